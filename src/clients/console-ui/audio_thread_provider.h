@@ -28,11 +28,45 @@
 #ifndef SCXT_SRC_CLIENTS_CONSOLE_UI_AUDIO_THREAD_PROVIDER_H
 #define SCXT_SRC_CLIENTS_CONSOLE_UI_AUDIO_THREAD_PROVIDER_H
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "engine/engine.h"
+
 namespace scxt::clients::console_ui
 {
+/*
+ * Stands in for an audio device so a headless engine has something calling processAudio.
+ * The console harness just wants blocks to keep coming; a server wants them at the real
+ * rate; an offline render wants them as fast as possible. Whoever is listening can pick
+ * each main output block up through onBlock, which runs on this thread right after it
+ * was rendered.
+ */
 struct AudioThreadProvider
 {
-    AudioThreadProvider(engine::Engine &e) : engine(e)
+    enum struct Pacing
+    {
+        // Sleep half a block after each block, so we run ahead of real time
+        HALF_BLOCK_SLEEP,
+        // Keep to the wall clock, running late blocks back to back to catch up as a
+        // device callback with a deep buffer would, rather than dropping them
+        WALL_CLOCK,
+        // No sleeping at all
+        OFFLINE
+    };
+
+    struct Options
+    {
+        Pacing pacing{Pacing::HALF_BLOCK_SLEEP};
+        std::function<void(const float *, const float *)> onBlock{nullptr};
+    };
+
+    AudioThreadProvider(engine::Engine &e) : AudioThreadProvider(e, Options{}) {}
+    AudioThreadProvider(engine::Engine &e, Options o) : engine(e), options(std::move(o))
     {
         keepProcessing = true;
         audioThread = std::make_unique<std::thread>([this]() { runAudioThread(); });
@@ -46,10 +80,14 @@ struct AudioThreadProvider
         }
     }
 
+    uint64_t blocksRendered() const { return blockCount; }
+
   private:
     engine::Engine &engine;
+    Options options;
     std::unique_ptr<std::thread> audioThread;
     std::atomic<bool> keepProcessing{false};
+    std::atomic<uint64_t> blockCount{0};
     void runAudioThread()
     {
         auto sr = engine.getSampleRate();
@@ -58,14 +96,35 @@ struct AudioThreadProvider
             SCLOG_IF(warnings, "Engine sample rate is wrong at " << sr);
             throw std::logic_error("Set sample rate to something realistic");
         }
-        auto sleepTime = (uint32_t)(scxt::blockSize / sr * 1000000 * 0.5);
+        using clock_t = std::chrono::steady_clock;
+        auto blockTime = std::chrono::duration_cast<clock_t::duration>(
+            std::chrono::duration<double>(scxt::blockSize / sr));
+        auto next = clock_t::now();
 
         while (keepProcessing)
         {
             engine.processAudio();
-            engine.transport.timeInBeats +=
-                (double)scxt::blockSize * 120 * engine.getSampleRateInv() / 60.f;
-            std::this_thread::sleep_for(std::chrono::microseconds(sleepTime));
+            engine.transport.timeInBeats += (double)scxt::blockSize * engine.transport.tempo *
+                                            engine.getSampleRateInv() / 60.0;
+            if (options.onBlock)
+            {
+                auto &out = engine.getPatch()->busses.mainBus.output;
+                options.onBlock(out[0], out[1]);
+            }
+            blockCount++;
+
+            switch (options.pacing)
+            {
+            case Pacing::HALF_BLOCK_SLEEP:
+                std::this_thread::sleep_for(blockTime / 2);
+                break;
+            case Pacing::WALL_CLOCK:
+                next += blockTime;
+                std::this_thread::sleep_until(next);
+                break;
+            case Pacing::OFFLINE:
+                break;
+            }
         }
     }
 };
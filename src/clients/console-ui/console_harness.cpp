@@ -27,6 +27,8 @@
 
 #include "console_harness.h"
 
+#include <cstring>
+
 namespace scxt::clients::console_ui
 {
 
@@ -43,11 +45,34 @@ bool ConsoleHarness::start(bool logMessages, double sampleRate)
     editor->logMessages = logMessages;
 
     audioThreadProvider = std::make_unique<scxt::clients::console_ui::AudioThreadProvider>(*engine);
+    if (traceLatency)
+        engine->getMessageController()->latencyTrace.enabled = true;
     return true;
 }
 
+void ConsoleHarness::consumeCommandLineFlags(int &argc, char **argv)
+{
+    int w{1};
+    for (int r = 1; r < argc; ++r)
+    {
+        if (strcmp(argv[r], "--trace-latency") == 0)
+            traceLatency = true;
+        else
+            argv[w++] = argv[r];
+    }
+    argc = w;
+}
+
+void ConsoleHarness::logLatencyReport()
+{
+    const auto &lt = engine->getMessageController()->latencyTrace;
+    SCLOG_IF(cliTools, scxt::messaging::LatencyTrace::formatReport(lt.report()));
+}
+
 ConsoleHarness::~ConsoleHarness()
 {
+    if (traceLatency && engine)
+        logLatencyReport();
     audioThreadProvider.reset();
     editor.reset();
     engine.reset();
@@ -43,6 +43,15 @@ struct ConsoleHarness : scxt::MoveableOnly<ConsoleHarness>
 
     bool start(bool logMessages = false, double sampleRate = 48000);
 
+    /*
+     * Tools built on the harness take these flags ahead of their own arguments:
+     *   --trace-latency   trace message latency and log a report when the harness ends
+     * Recognized flags are removed from argv.
+     */
+    static void consumeCommandLineFlags(int &argc, char **argv);
+    static inline bool traceLatency{false};
+    void logLatencyReport();
+
     void stepUI(size_t forSteps = 10)
     {
         for (int i = 0; i < forSteps; ++i)
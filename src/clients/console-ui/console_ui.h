@@ -69,7 +69,8 @@ struct ConsoleUI
     onMappingUpdated(const scxt::messaging::client::mappingSelectedZoneViewResposne_t &) ON_STUB;
     void
     onSamplesUpdated(const scxt::messaging::client::sampleSelectedZoneViewResposne_t &) ON_STUB;
-    void onStructureUpdated(const engine::Engine::pgzStructure_t &) ON_STUB;
+    void onStructureUpdated(const engine::Engine::pgzVersionedStructure_t &) ON_STUB;
+    void onStructureDelta(const engine::Engine::pgzStructureDelta_t &) ON_STUB;
     void onGroupOrZoneEnvelopeUpdated(
         const scxt::messaging::client::adsrViewResponsePayload_t &payload) ON_STUB;
     void onGroupOrZoneProcessorDataAndMetadata(
@@ -127,6 +128,8 @@ struct ConsoleUI
     void onPitchBendTuningAwarenessFromEngine(bool b) ON_STUB;
     void onTuningStatus(const scxt::messaging::client::tuningStatusPayload_t &) ON_STUB;
     void onOmniFlavorFromEngine(std::pair<int, bool> f) ON_STUB;
+    void onMemoryPoolStats(const scxt::messaging::client::memoryPoolStats_t &) ON_STUB;
+    void onLatencyReport(const scxt::messaging::client::latencyReport_t &) ON_STUB;
     void stepUI();
 
   private:
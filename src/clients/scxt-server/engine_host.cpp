@@ -0,0 +1,429 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "engine_host.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "sst/plugininfra/version_information.h"
+
+#include "messaging/messaging.h"
+
+namespace scxt::clients::server
+{
+namespace cmsg = scxt::messaging::client;
+
+namespace
+{
+void setReadTimeout(int fd, std::chrono::milliseconds ms)
+{
+    timeval tv{};
+    tv.tv_sec = ms.count() / 1000;
+    tv.tv_usec = (ms.count() % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+bool readAll(int fd, char *into, size_t n)
+{
+    while (n > 0)
+    {
+        auto r = ::read(fd, into, n);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return false;
+        into += r;
+        n -= r;
+    }
+    return true;
+}
+
+bool writeAll(int fd, const char *from, size_t n)
+{
+#if defined(MSG_NOSIGNAL)
+    constexpr int flags{MSG_NOSIGNAL};
+#else
+    constexpr int flags{0};
+#endif
+    while (n > 0)
+    {
+        auto r = ::send(fd, from, n, flags);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0)
+            return false;
+        from += r;
+        n -= r;
+    }
+    return true;
+}
+
+/*
+ * The frames the serialization thread has handed us for one connection but which
+ * haven't made it onto the socket yet.
+ */
+struct OutboundQueue
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::string> frames;
+    size_t bytes{0};
+    bool closed{false};
+
+    bool push(const std::string &msg, size_t maxBytes)
+    {
+        {
+            std::lock_guard<std::mutex> g(mutex);
+            if (closed)
+                return false;
+            if (bytes + msg.size() > maxBytes)
+            {
+                closed = true;
+            }
+            else
+            {
+                frames.push_back(msg);
+                bytes += msg.size();
+            }
+        }
+        cv.notify_one();
+        return !closed;
+    }
+
+    // Blocks until there is a frame or we are closed
+    bool pop(std::string &into)
+    {
+        std::unique_lock<std::mutex> g(mutex);
+        cv.wait(g, [this]() { return closed || !frames.empty(); });
+        if (closed)
+            return false;
+        into = std::move(frames.front());
+        frames.pop_front();
+        bytes -= into.size();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> g(mutex);
+            closed = true;
+            frames.clear();
+            bytes = 0;
+        }
+        cv.notify_all();
+    }
+};
+} // namespace
+
+EngineHost::EngineHost(const Config &c) : config(c) {}
+
+EngineHost::~EngineHost() { stop(); }
+
+bool EngineHost::readFrame(int fd, std::string &into)
+{
+    unsigned char hdr[4];
+    if (!readAll(fd, (char *)hdr, 4))
+        return false;
+    uint32_t len = hdr[0] | (hdr[1] << 8) | (hdr[2] << 16) | ((uint32_t)hdr[3] << 24);
+    if (len > maxFrameBytes)
+        return false;
+    into.resize(len);
+    return readAll(fd, into.data(), len);
+}
+
+bool EngineHost::writeFrame(int fd, const std::string &msg)
+{
+    if (msg.size() > maxFrameBytes)
+        return false;
+    auto len = (uint32_t)msg.size();
+    unsigned char hdr[4]{(unsigned char)(len & 0xFF), (unsigned char)((len >> 8) & 0xFF),
+                         (unsigned char)((len >> 16) & 0xFF), (unsigned char)((len >> 24) & 0xFF)};
+    return writeAll(fd, (const char *)hdr, 4) && writeAll(fd, msg.data(), msg.size());
+}
+
+std::string EngineHost::helloFrame()
+{
+    namespace vi = sst::plugininfra::VersionInformation;
+    return std::string("scxt-server ") + std::to_string(protocolVersion) + " " +
+           vi::project_version_and_hash + " " + vi::build_date + " " + vi::build_time;
+}
+
+bool EngineHost::start()
+{
+    sockaddr_un addr{};
+    if (config.socketPath.empty() || config.socketPath.size() >= sizeof(addr.sun_path))
+    {
+        SCLOG_IF(warnings, "Socket path '" << config.socketPath << "' is empty or too long");
+        return false;
+    }
+
+    if (::pipe(wakeFds) != 0)
+    {
+        SCLOG_IF(warnings, "Unable to create wake pipe: " << strerror(errno));
+        return false;
+    }
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0)
+    {
+        SCLOG_IF(warnings, "Unable to create socket: " << strerror(errno));
+        closeWakePipe();
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, config.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    // Clear out a socket a previous run left behind, but never anything else at that path
+    struct stat st;
+    if (::lstat(config.socketPath.c_str(), &st) == 0 && S_ISSOCK(st.st_mode))
+        ::unlink(config.socketPath.c_str());
+    if (::bind(listenFd, (sockaddr *)&addr, sizeof(addr)) != 0 || ::listen(listenFd, 1) != 0)
+    {
+        SCLOG_IF(warnings,
+                 "Unable to listen on " << config.socketPath << ": " << strerror(errno));
+        ::close(listenFd);
+        listenFd = -1;
+        closeWakePipe();
+        return false;
+    }
+    // A client arriving and leaving before we accept shouldn't block the listener
+    ::fcntl(listenFd, F_SETFL, ::fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+
+    engine = std::make_unique<engine::Engine>();
+    engine->runningEnvironment = "SCXT Server";
+    engine->setSampleRate(config.sampleRate);
+    if (config.jsonWireFormat)
+        engine->getMessageController()->wireFormat = messaging::MessageController::WireFormat::JSON;
+
+    console_ui::AudioThreadProvider::Options opts;
+    opts.pacing = config.offline ? console_ui::AudioThreadProvider::Pacing::OFFLINE
+                                 : console_ui::AudioThreadProvider::Pacing::WALL_CLOCK;
+    if (!config.renderPath.empty())
+    {
+        renderWriter = std::make_unique<patch_io::riffwav::RIFFWavWriter>(
+            fs::path(config.renderPath), 2, patch_io::riffwav::RIFFWavWriter::F32);
+        if (!renderWriter->openFile())
+        {
+            SCLOG_IF(warnings, "Unable to render to " << config.renderPath << ": "
+                                                      << renderWriter->errMsg);
+            renderWriter.reset();
+            engine.reset();
+            ::close(listenFd);
+            listenFd = -1;
+            closeWakePipe();
+            return false;
+        }
+        renderWriter->writeRIFFHeader();
+        renderWriter->writeFMTChunk((int32_t)config.sampleRate);
+        renderWriter->startDataChunk();
+
+        // This is our own stand in clock rather than a device callback, so the buffered
+        // stdio write is fine here; in wall clock mode a slow disk just means a catch up
+        opts.onBlock = [w = renderWriter.get()](const float *L, const float *R) {
+            float d[2];
+            for (int i = 0; i < scxt::blockSize; ++i)
+            {
+                d[0] = L[i];
+                d[1] = R[i];
+                w->pushSamplesF32(d);
+            }
+        };
+    }
+
+    keepRunning = true;
+    audio = std::make_unique<console_ui::AudioThreadProvider>(*engine, std::move(opts));
+    listenThread = std::make_unique<std::thread>([this]() { runListener(); });
+
+    SCLOG_IF(cliTools, "Engine listening on " << config.socketPath << " at "
+                                              << config.sampleRate << "hz"
+                                              << (config.offline ? " offline" : ""));
+    return true;
+}
+
+void EngineHost::stop()
+{
+    if (!keepRunning)
+        return;
+    keepRunning = false;
+
+    // Wake the listener out of poll, and out of the read on the current connection if
+    // there is one. Under the lock, so we either see the fd the listener is serving or
+    // it sees keepRunning false before it starts serving a new one.
+    char w{1};
+    [[maybe_unused]] auto r = ::write(wakeFds[1], &w, 1);
+    {
+        std::lock_guard<std::mutex> g(connectionMutex);
+        if (clientFd >= 0)
+            ::shutdown(clientFd, SHUT_RDWR);
+    }
+    listenThread->join();
+    listenThread.reset();
+    ::close(listenFd);
+    listenFd = -1;
+    closeWakePipe();
+    ::unlink(config.socketPath.c_str());
+
+    audio.reset();
+    if (renderWriter)
+    {
+        if (!renderWriter->closeFile())
+            SCLOG_IF(warnings, "Unable to finish writing " << config.renderPath);
+        renderWriter.reset();
+    }
+    engine.reset();
+}
+
+void EngineHost::closeWakePipe()
+{
+    for (auto &f : wakeFds)
+    {
+        if (f >= 0)
+            ::close(f);
+        f = -1;
+    }
+}
+
+void EngineHost::runListener()
+{
+    while (keepRunning)
+    {
+        pollfd pfd[2]{{listenFd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}};
+        auto pr = ::poll(pfd, 2, -1);
+        if (pr < 0 && errno == EINTR)
+            continue;
+        if (pr < 0 || (pfd[1].revents & POLLIN))
+            break;
+
+        auto fd = ::accept(listenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK ||
+                errno == ECONNABORTED)
+                continue;
+            break;
+        }
+        // The listen socket is non blocking, and on some platforms accept hands that on
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+        {
+            std::lock_guard<std::mutex> g(connectionMutex);
+            if (!keepRunning)
+            {
+                ::close(fd);
+                break;
+            }
+            clientFd = fd;
+        }
+        serveConnection(fd);
+        {
+            std::lock_guard<std::mutex> g(connectionMutex);
+            clientFd = -1;
+        }
+        ::close(fd);
+    }
+}
+
+void EngineHost::serveConnection(int fd)
+{
+#if defined(SO_NOSIGPIPE)
+    int one{1};
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    SCLOG_IF(cliTools, "Client connected on " << config.socketPath);
+    if (!exchangeHello(fd))
+        return;
+
+    auto &mc = *engine->getMessageController();
+
+    // The callback runs on the serialization thread under the client callback mutex, so
+    // it only queues; the writer thread does the blocking socket writes. If the client
+    // stops reading and we back up past the cap, or a write fails, shut the socket down
+    // so the read loop below ends the connection.
+    auto outbound = std::make_shared<OutboundQueue>();
+    std::thread writer([fd, outbound]() {
+        std::string frame;
+        while (outbound->pop(frame))
+        {
+            if (!writeFrame(fd, frame))
+            {
+                outbound->close();
+                ::shutdown(fd, SHUT_RDWR);
+            }
+        }
+    });
+    mc.registerClient("scxt-server", [fd, outbound, cap = config.maxQueuedBytes](const auto &msg) {
+        if (!outbound->push(msg, cap))
+            ::shutdown(fd, SHUT_RDWR);
+    });
+
+    std::string frame;
+    while (keepRunning && readFrame(fd, frame))
+    {
+        if (!cmsg::isWellFormedClientMessage(frame))
+        {
+            SCLOG_IF(warnings, "Dropping client on " << config.socketPath
+                                                     << " after a malformed frame");
+            break;
+        }
+        mc.sendRawFromClient(frame);
+    }
+
+    mc.unregisterClient();
+    outbound->close();
+    writer.join();
+    SCLOG_IF(cliTools, "Client disconnected from " << config.socketPath);
+}
+
+bool EngineHost::exchangeHello(int fd)
+{
+    std::string hello;
+    setReadTimeout(fd, helloTimeout);
+    auto gotHello = readFrame(fd, hello);
+    setReadTimeout(fd, std::chrono::milliseconds(0));
+
+    // Answer either way, so a mismatched client can say what it found
+    auto ours = helloFrame();
+    if (!writeFrame(fd, ours) || !gotHello)
+        return false;
+    if (hello != ours)
+    {
+        SCLOG_IF(warnings, "Rejecting client on " << config.socketPath << ": it is '" << hello
+                                                  << "' and we are '" << ours << "'");
+        return false;
+    }
+    return true;
+}
+} // namespace scxt::clients::server
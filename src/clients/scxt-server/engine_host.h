@@ -0,0 +1,118 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_CLIENTS_SCXT_SERVER_ENGINE_HOST_H
+#define SCXT_SRC_CLIENTS_SCXT_SERVER_ENGINE_HOST_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "engine/engine.h"
+#include "patch_io/RIFFWavWriter.hpp"
+#include "audio_thread_provider.h"
+
+namespace scxt::clients::server
+{
+/*
+ * One headless engine, a clock to drive its audio thread, and a Unix domain socket
+ * a single client at a time can attach to.
+ *
+ * The socket carries exactly the strings the in-process clients exchange with the
+ * MessageController (flat frames, msgpack or JSON), each preceded by its length as
+ * a little endian uint32. Inbound frames go to sendRawFromClient and the registered
+ * client callback writes outbound ones, so any client built on client_serial.h can
+ * talk to a remote engine by swapping the transport.
+ *
+ * Flat frames are raw bytes which only the same build reads the same way, so a
+ * client must open with helloFrame. The host answers with its own, and if the two
+ * differ, or none arrives within helloTimeout, it hangs up after answering. It also
+ * hangs up on a client which sends a frame isWellFormedClientMessage rejects. Outbound
+ * frames are queued and written by a per connection thread, so a slow reader never
+ * stalls the serialization thread; one which falls more than maxQueuedBytes behind
+ * is disconnected.
+ *
+ * The main output can be written to a float wav at renderPath. With offline set the
+ * engine renders as fast as it can rather than at the wall clock rate.
+ */
+struct EngineHost : MoveableOnly<EngineHost>
+{
+    struct Config
+    {
+        std::string socketPath;
+        double sampleRate{48000};
+        bool jsonWireFormat{false};
+        std::string renderPath;
+        bool offline{false};
+        size_t maxQueuedBytes{256 * 1024 * 1024};
+    };
+
+    explicit EngineHost(const Config &c);
+    ~EngineHost();
+
+    bool start();
+    void stop();
+
+    static constexpr uint32_t maxFrameBytes{64 * 1024 * 1024};
+    static bool readFrame(int fd, std::string &into);
+    static bool writeFrame(int fd, const std::string &msg);
+
+    // Bump this when the framing or the handshake changes
+    static constexpr uint32_t protocolVersion{1};
+    static constexpr std::chrono::milliseconds helloTimeout{5000};
+    // The protocol version and the build, which both ends send first
+    static std::string helloFrame();
+
+    uint64_t blocksRendered() const { return audio ? audio->blocksRendered() : 0; }
+
+  private:
+    void runListener();
+    void serveConnection(int fd);
+    bool exchangeHello(int fd);
+    void closeWakePipe();
+
+    Config config;
+    std::unique_ptr<engine::Engine> engine;
+    std::unique_ptr<patch_io::riffwav::RIFFWavWriter> renderWriter;
+    std::unique_ptr<console_ui::AudioThreadProvider> audio;
+    std::unique_ptr<std::thread> listenThread;
+    std::atomic<bool> keepRunning{false};
+    int listenFd{-1};
+    // stop() writes here to wake the listener out of poll
+    int wakeFds[2]{-1, -1};
+
+    // Guards clientFd so stop() can't shut down a descriptor the listener has already
+    // closed (and the OS may have handed out again), nor miss one it just accepted
+    std::mutex connectionMutex;
+    int clientFd{-1};
+};
+} // namespace scxt::clients::server
+
+#endif // SCXT_SRC_CLIENTS_SCXT_SERVER_ENGINE_HOST_H
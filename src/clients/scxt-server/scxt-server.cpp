@@ -0,0 +1,121 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+/*
+ * A headless engine server. Each engine gets its own Unix domain socket which one
+ * client at a time can attach to and drive with the regular client message protocol,
+ * so the sampler can render on one machine while an editor or a script runs in
+ * another process.
+ *
+ *   scxt-server [--socket path] [--engines n] [--sample-rate sr] [--json]
+ *               [--render-to file.wav] [--offline]
+ *
+ * With more than one engine, engine i listens on path.i and renders to file.wav.i.
+ * --render-to writes the main output as float wav; --offline renders as fast as the
+ * machine allows rather than in real time. Stop with SIGINT or SIGTERM.
+ */
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+#include "engine_host.h"
+
+int main(int argc, char **argv)
+{
+    namespace srv = scxt::clients::server;
+
+    std::string socketPath{"/tmp/scxt-server.sock"};
+    int engines{1};
+    srv::EngineHost::Config base;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        auto arg = std::string(argv[i]);
+        auto hasValue = i + 1 < argc;
+        if (arg == "--socket" && hasValue)
+            socketPath = argv[++i];
+        else if (arg == "--engines" && hasValue)
+            engines = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--sample-rate" && hasValue)
+            base.sampleRate = std::atof(argv[++i]);
+        else if (arg == "--json")
+            base.jsonWireFormat = true;
+        else if (arg == "--render-to" && hasValue)
+            base.renderPath = argv[++i];
+        else if (arg == "--offline")
+            base.offline = true;
+        else
+        {
+            SCLOG_IF(cliTools, "Usage: " << argv[0]
+                                         << " [--socket path] [--engines n] [--sample-rate sr]"
+                                            " [--json] [--render-to file.wav] [--offline]");
+            return 1;
+        }
+    }
+    if (base.sampleRate < 44100)
+    {
+        SCLOG_IF(cliTools, "Sample rate " << base.sampleRate << " is too low");
+        return 1;
+    }
+
+    // Block these before any threads start so they all inherit the mask and only
+    // the sigwait below sees them. A client vanishing mid write shouldn't kill us.
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<std::unique_ptr<srv::EngineHost>> hosts;
+    for (int i = 0; i < engines; ++i)
+    {
+        auto cfg = base;
+        cfg.socketPath = engines == 1 ? socketPath : socketPath + "." + std::to_string(i);
+        if (engines > 1 && !cfg.renderPath.empty())
+            cfg.renderPath += "." + std::to_string(i);
+        auto h = std::make_unique<srv::EngineHost>(cfg);
+        if (!h->start())
+            return 2;
+        hosts.push_back(std::move(h));
+    }
+
+    int sig{0};
+    sigwait(&stopSignals, &sig);
+    SCLOG_IF(cliTools, "Stopping on signal " << sig);
+
+    for (auto &h : hosts)
+        h->stop();
+    return 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_CLIENTS_STRESS_TESTS_BENCH_SUPPORT_H
+#define SCXT_SRC_CLIENTS_STRESS_TESTS_BENCH_SUPPORT_H
+
+/*
+ * The boilerplate the stress benches share: a harness with the audio thread taken
+ * over so the bench can call the engine directly, a clock, and the summary of a
+ * set of timings.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "console_harness.h"
+
+namespace scxt::clients::stress_tests
+{
+using harness_t = scxt::clients::console_ui::ConsoleHarness;
+
+inline std::unique_ptr<harness_t> startHarness()
+{
+    auto ch = std::make_unique<harness_t>();
+    ch->start(false);
+    ch->stepUI();
+    return ch;
+}
+
+/*
+ * Stop the harness audio thread and claim its role for this thread, so nothing
+ * else touches the engine while the bench times it. Benches which time
+ * serialization thread work claim that role instead.
+ */
+inline scxt::engine::Engine &takeOverEngine(harness_t &ch, bool asAudioThread = true)
+{
+    ch.audioThreadProvider.reset();
+    auto &e = *ch.engine;
+    auto &tc = e.getMessageController()->threadingChecker;
+    if (asAudioThread)
+        tc.registerAsAudioThread();
+    else
+        tc.registerAsSerialThread();
+    return e;
+}
+
+using benchClock = std::chrono::high_resolution_clock;
+
+template <typename Unit = std::ratio<1>> double elapsed(benchClock::time_point st)
+{
+    return std::chrono::duration<double, Unit>(benchClock::now() - st).count();
+}
+
+/*
+ * Log the median, 99th percentile and worst of a set of timings, which it sorts.
+ * The tail matters as much as the middle since the worst case is what the audio
+ * thread has to budget for.
+ */
+inline void logTimings(const std::string &label, std::vector<double> &t, const std::string &unit)
+{
+    if (t.empty())
+        return;
+
+    std::sort(t.begin(), t.end());
+    auto pct = [&t](double p) { return t[(size_t)(p * (t.size() - 1))]; };
+    auto pad = [](std::string s) {
+        s.resize(std::max(s.size(), (size_t)21), ' ');
+        return s + ": ";
+    };
+    SCLOG_IF(cliTools, pad("Median " + label) << pct(0.5) << " " << unit);
+    SCLOG_IF(cliTools, pad("99th pct " + label) << pct(0.99) << " " << unit);
+    SCLOG_IF(cliTools, pad("Worst " + label) << t.back() << " " << unit);
+}
+} // namespace scxt::clients::stress_tests
+
+#endif // SCXT_SRC_CLIENTS_STRESS_TESTS_BENCH_SUPPORT_H
@@ -81,6 +81,7 @@ void makeNbyNGroupPer(int dc, const std::string &path)
 
 int main(int argc, char **argv)
 {
+    scxt::clients::console_ui::ConsoleHarness::consumeCommandLineFlags(argc, argv);
     makeNbyNGroupPer(5, "/tmp/stressG.scm");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+/*
+ * Times note on, from the event to the voices being ready to render, with stacks
+ * of layered zones so each note starts many voices at once. Reports the mean and
+ * the tail since the worst case is what the audio thread has to budget for.
+ *
+ * Each run times note on twice: with the voice start descriptors published, and
+ * with them marked stale before every note so each voice compiles its variant at
+ * note on, which is the work starting a voice did before there were descriptors.
+ *
+ *   note-on-bench [--trace-latency] <sample file> [layers] [rounds]
+ */
+
+#include <cstdlib>
+#include <vector>
+#include "bench_support.h"
+
+namespace bench = scxt::clients::stress_tests;
+
+int main(int argc, char **argv)
+{
+    scxt::clients::console_ui::ConsoleHarness::consumeCommandLineFlags(argc, argv);
+    if (argc < 2)
+    {
+        SCLOG_IF(cliTools, "Usage: " << argv[0] << " <sample file> [layers] [rounds]");
+        return 1;
+    }
+    int layers = argc > 2 ? std::atoi(argv[2]) : 8;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    auto ch = bench::startHarness();
+
+    namespace cmsg = scxt::messaging::client;
+
+    // Every layer covers the whole keyboard, so a note starts one voice per layer
+    for (int l = 0; l < layers; ++l)
+    {
+        ch->sendToSerialization(cmsg::AddSampleWithRange({argv[1], 60, 0, 127, 0, 127}));
+    }
+    ch->stepUI(50);
+
+    // Take over the audio thread so we can call the engine directly
+    auto &e = bench::takeOverEngine(*ch);
+
+    static constexpr int chordSize{6}, blocksHeld{8}, blocksReleased{256};
+    static constexpr int chord[chordSize]{48, 52, 55, 60, 64, 67};
+
+    auto timeNoteOns = [&](bool compileAtNoteOn, const std::string &label) {
+        std::vector<double> noteOnNanos;
+        noteOnNanos.reserve(rounds * chordSize);
+        size_t voicesStarted{0};
+
+        for (int r = 0; r < rounds; ++r)
+        {
+            for (auto k : chord)
+            {
+                // Nothing steps the serialization thread here, so stale stays stale
+                if (compileAtNoteOn)
+                    for (auto &z : *e.getPatch()->getPart(0)->getGroup(0))
+                        z->markVoiceStartDescriptorsDirty();
+
+                auto before = e.activeVoices.load();
+                auto st = bench::benchClock::now();
+                e.processNoteOnEvent(0, 0, k, -1, 0.8, 0.f);
+                noteOnNanos.push_back(bench::elapsed<std::nano>(st));
+                voicesStarted += e.activeVoices - before;
+            }
+
+            for (int b = 0; b < blocksHeld + blocksReleased; ++b)
+            {
+                if (b == blocksHeld)
+                {
+                    for (auto k : chord)
+                        e.processNoteOffEvent(0, 0, k, -1, 0.8);
+                }
+                e.processAudio();
+            }
+        }
+
+        if (noteOnNanos.empty())
+            return;
+
+        double total{0};
+        for (auto n : noteOnNanos)
+            total += n;
+
+        SCLOG_IF(cliTools, "Note ons timed       : " << noteOnNanos.size() << " (" << label << ")");
+        SCLOG_IF(cliTools, "Voices per note on   : " << (double)voicesStarted / noteOnNanos.size());
+        SCLOG_IF(cliTools, "Mean note on         : " << total / noteOnNanos.size() << " ns");
+        bench::logTimings("note on", noteOnNanos, "ns");
+    };
+
+    timeNoteOns(false, "descriptors published");
+    timeNoteOns(true, "compiled at note on");
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+/*
+ * Times a full engine unstream and the clearAll which tears it down, on the same
+ * dense one-zone-per-key-and-velocity layout make-stress builds. Runs each round
+ * with structure objects from the heap and from a StructureArena so the two can be
+ * compared.
+ *
+ *   unstream-bench [--trace-latency] [rounds] [keys]
+ *
+ * keys x keys zones are made, so the default of 100 gives a 10k zone multi.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "bench_support.h"
+#include "json/stream.h"
+
+namespace bench = scxt::clients::stress_tests;
+
+int main(int argc, char **argv)
+{
+    scxt::clients::console_ui::ConsoleHarness::consumeCommandLineFlags(argc, argv);
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 10;
+    int keys = argc > 2 ? std::clamp(std::atoi(argv[2]), 1, 128) : 100;
+
+    auto ch = bench::startHarness();
+
+    namespace cmsg = scxt::messaging::client;
+
+    using abz = cmsg::AddBlankZone;
+    for (int k = 0; k < keys; ++k)
+    {
+        for (int v = 0; v < keys; ++v)
+        {
+            ch->sendToSerialization(abz({0, 0, k, k, v, v}));
+        }
+        ch->stepUI(1);
+    }
+    ch->stepUI(50);
+
+    // Take over the audio thread so nothing else touches the structure while we time
+    auto &e = bench::takeOverEngine(*ch, false);
+
+    auto countZones = [&e]() {
+        size_t res{0};
+        for (const auto &p : *e.getPatch())
+            for (const auto &g : *p)
+                res += g->getZones().size();
+        return res;
+    };
+
+    auto state = scxt::json::streamEngineState(e);
+    SCLOG_IF(cliTools, "Zones                : " << countZones());
+    SCLOG_IF(cliTools, "Streamed state       : " << state.size() / 1024 << " kb");
+
+    // Median unstream and clearAll for the heap then the arena
+    double medians[2][2]{};
+    for (auto useArena : {false, true})
+    {
+        scxt::engine::StructureArena::enabled = useArena;
+
+        std::vector<double> loadMs, clearMs;
+        for (int r = 0; r < rounds; ++r)
+        {
+            auto st = bench::benchClock::now();
+            scxt::json::unstreamEngineState(e, state);
+            loadMs.push_back(bench::elapsed<std::milli>(st));
+
+            st = bench::benchClock::now();
+            e.clearAll(false);
+            clearMs.push_back(bench::elapsed<std::milli>(st));
+
+            // Drain the refresh messages the load sent
+            ch->stepUI(1);
+        }
+        SCLOG_IF(cliTools, (useArena ? "Arena" : "Heap"));
+        bench::logTimings("unstream", loadMs, "ms");
+        bench::logTimings("clearAll", clearMs, "ms");
+        if (rounds > 0)
+        {
+            // logTimings left them sorted
+            medians[useArena][0] = loadMs[(loadMs.size() - 1) / 2];
+            medians[useArena][1] = clearMs[(clearMs.size() - 1) / 2];
+        }
+    }
+    scxt::engine::StructureArena::enabled = true;
+
+    if (rounds > 0 && medians[1][0] > 0 && medians[1][1] > 0)
+    {
+        SCLOG_IF(cliTools, "Heap / arena unstream: " << medians[0][0] / medians[1][0] << "x");
+        SCLOG_IF(cliTools, "Heap / arena clearAll: " << medians[0][1] / medians[1][1] << "x");
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+/*
+ * Reports the voice footprint and times the engine with a keyboard full of voices
+ * held. Run it before and after a change to the voice layout to compare.
+ *
+ *   voice-bench [--trace-latency] <sample file> [rounds]
+ */
+
+#include <cstdlib>
+#include "bench_support.h"
+#include "voice/voice.h"
+
+namespace bench = scxt::clients::stress_tests;
+
+int main(int argc, char **argv)
+{
+    scxt::clients::console_ui::ConsoleHarness::consumeCommandLineFlags(argc, argv);
+    if (argc < 2)
+    {
+        SCLOG_IF(cliTools, "Usage: " << argv[0] << " <sample file> [rounds]");
+        return 1;
+    }
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    auto ch = bench::startHarness();
+
+    namespace cmsg = scxt::messaging::client;
+
+    // One zone per four keys so voices spread over many zones like a real multi
+    for (int k = 0; k < 128; k += 4)
+    {
+        ch->sendToSerialization(cmsg::AddSampleWithRange({argv[1], k + 2, k, k + 3, 0, 127}));
+    }
+    ch->stepUI(50);
+
+    // Take over the audio thread so we can time processAudio directly
+    auto &e = bench::takeOverEngine(*ch);
+
+    static constexpr int keysHeld{96}, blocksHeld{512}, blocksReleased{64};
+    double processSeconds{0};
+    size_t processedBlocks{0}, voiceBlocks{0};
+    for (int r = 0; r < rounds; ++r)
+    {
+        for (int k = 16; k < 16 + keysHeld; ++k)
+            e.processNoteOnEvent(0, 0, k, -1, 0.8, 0.f);
+
+        for (int b = 0; b < blocksHeld + blocksReleased; ++b)
+        {
+            if (b == blocksHeld)
+            {
+                for (int k = 16; k < 16 + keysHeld; ++k)
+                    e.processNoteOffEvent(0, 0, k, -1, 0.8);
+            }
+            voiceBlocks += e.activeVoices;
+
+            auto st = bench::benchClock::now();
+            e.processAudio();
+            processSeconds += bench::elapsed(st);
+            processedBlocks++;
+        }
+    }
+
+    auto voiceSize = sizeof(scxt::voice::Voice);
+    SCLOG_IF(cliTools, "sizeof(Voice)        : " << voiceSize << " bytes / "
+                                                 << (voiceSize + 63) / 64 << " cache lines");
+    SCLOG_IF(cliTools, "Voice buffer         : " << voiceSize * scxt::maxVoices / 1024 << " kb");
+    SCLOG_IF(cliTools, "Unison generators    : " << scxt::voice::Voice::unisonGeneratorBytes
+                                                 << " bytes per unison voice, pooled");
+    SCLOG_IF(cliTools, "Blocks processed     : " << processedBlocks);
+    SCLOG_IF(cliTools, "Mean voices / block  : " << (double)voiceBlocks / processedBlocks);
+    SCLOG_IF(cliTools, "Mean time / block    : " << processSeconds / processedBlocks * 1e6
+                                                 << " us");
+    if (voiceBlocks)
+    {
+        SCLOG_IF(cliTools,
+                 "Mean time / voice    : " << processSeconds / voiceBlocks * 1e9 << " ns");
+    }
+
+    return 0;
+}
@@ -35,8 +35,19 @@ namespace scxt
 {
 static constexpr uint64_t currentStreamingVersion{0x2026'03'08};
 
-static constexpr uint16_t blockSize{16};
-static constexpr uint16_t blockSizeQuad{16 >> 2};
+/*
+ * The internal block size is chosen at build time with -DSCXT_BLOCK_SIZE=16, 32 or 64.
+ * All the per-block work (modulation, envelope and LFO updates, endpoint snapping and
+ * message queue draining) runs once per block, so a larger block trades modulation
+ * granularity for a smaller fixed overhead.
+ */
+#ifndef SCXT_BLOCK_SIZE
+#define SCXT_BLOCK_SIZE 16
+#endif
+static constexpr uint16_t blockSize{SCXT_BLOCK_SIZE};
+static_assert(blockSize == 16 || blockSize == 32 || blockSize == 64,
+              "SCXT_BLOCK_SIZE must be 16, 32 or 64");
+static constexpr uint16_t blockSizeQuad{blockSize >> 2};
 static constexpr double blockSizeInv{1.0 / blockSize};
 static constexpr uint16_t numParts{16};
 static constexpr uint16_t numAux{4};
@@ -80,7 +91,8 @@ static constexpr uint16_t envFollowersPerGroupOrZone{2};
 
 static constexpr uint16_t triggerConditionsPerGroup{4};
 
-static constexpr uint16_t maxGeneratorsPerVoice{64};
+// A voice runs at most one generator per zone variant
+static constexpr uint16_t maxGeneratorsPerVoice{maxVariantsPerZone};
 
 static constexpr size_t modMatrixRowsPerZone{18};
 static constexpr size_t modMatrixRowsPerGroup{18};
@@ -144,7 +156,7 @@ namespace hasFeature
  */
 static constexpr bool geometryChangesAdjustFade{false};
 
-static constexpr bool memoryUsageExplanation{false}; // that chip in the header
+static constexpr bool memoryUsageExplanation{true}; // that chip in the header
 static constexpr bool mappingPane11Controls{false};  // zone mapping header skipped for 1.0
 static constexpr bool hasBrowserSearch{false};
 static constexpr bool hasGroupMIDIChannel{false}; // turn off per-group midi channel (see #1959)
@@ -71,9 +71,9 @@ inline InterpolationTypes fromStringInterpolationTypes(const std::string &s)
     return p->second;
 }
 
+// Members are grouped by size so the voice arrays of these pack without padding
 struct GeneratorState
 {
-    int16_t direction{0}; // +1 for forward, -1 for back
     int32_t samplePos{0};
     int32_t sampleSubPos{0};
 
@@ -85,20 +85,22 @@ struct GeneratorState
     int32_t loopUpperBound{1};     // inclusive
     float loopInvertedBounds{1.f}; // 1 / (UB-LB)
     int32_t ratio{1 << 24};        // 1 << 24 is playback-at-tempo
-    int16_t blockSize{scxt::blockSize};
-    bool isFinished{true};
     int32_t sampleStart{0};
     int32_t sampleStop{0};
-    bool gated{0};
-    int16_t loopCount{-1};        // if this is positive then we play this many loops no matter what
-    int16_t directionAtOutset{1}; // is our 'ur-' direction forward or backwards?
 
     float positionWithinLoop{0};
-    bool isInLoop{false};
-
     int32_t loopFade{0};
 
     InterpolationTypes interpolationType{InterpolationTypes::Sinc};
+
+    int16_t direction{0}; // +1 for forward, -1 for back
+    int16_t blockSize{scxt::blockSize};
+    int16_t loopCount{-1};        // if this is positive then we play this many loops no matter what
+    int16_t directionAtOutset{1}; // is our 'ur-' direction forward or backwards?
+
+    bool isFinished{true};
+    bool gated{0};
+    bool isInLoop{false};
 };
 
 struct GeneratorIO
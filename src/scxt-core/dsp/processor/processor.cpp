@@ -37,6 +37,8 @@
 
 namespace scxt::dsp::processor
 {
+// The memory pool records which processor types reserved each size class in a 64 bit mask
+static_assert(proct_num_types <= engine::MemoryPool::maxOwners);
 
 /**
  * This code blob uses constexpr expansion to allow us to convert a runtime integer to
@@ -241,6 +241,9 @@ struct Processor : MoveableOnly<Processor>, SampleRateSupport
 
   public:
     bool bypassAnyway{false};
+    // Set if the memory pool was dry when this checked out a block; see MemoryPool
+    bool memoryStarved{false};
+    bool isBypassed() const { return bypassAnyway || memoryStarved; }
 
     size_t preReserveSize[16]{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
     size_t preReserveSingleInstanceSize[16]{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
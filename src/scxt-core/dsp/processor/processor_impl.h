@@ -48,7 +48,7 @@ template <int OSFactor> struct SCXTVFXConfig
     {
         if (b->memoryPool)
         {
-            b->memoryPool->preReservePool(s);
+            b->memoryPool->preReservePool(s, (int)b->getType());
         }
         else
         {
@@ -67,7 +67,7 @@ template <int OSFactor> struct SCXTVFXConfig
     {
         if (b->memoryPool)
         {
-            b->memoryPool->preReserveSingleInstancePool(s);
+            b->memoryPool->preReserveSingleInstancePool(s, (int)b->getType());
         }
         else
         {
@@ -85,7 +85,15 @@ template <int OSFactor> struct SCXTVFXConfig
     static uint8_t *checkoutBlock(BaseClass *b, size_t s)
     {
         assert(b->memoryPool);
-        return b->memoryPool->checkoutBlock(s);
+        auto res = b->memoryPool->checkoutBlock(s);
+        if (!res)
+        {
+            // The pool ran dry. The effect still gets memory to set up in, but it is the
+            // shared reserve, so the processor never runs.
+            b->memoryStarved = true;
+            res = b->memoryPool->reserveBlock(s);
+        }
+        return res;
     }
 
     static void returnBlock(BaseClass *b, uint8_t *d, size_t s)
@@ -397,12 +405,13 @@ void Processor::setupProcessor(T *that, ProcessorType t, engine::MemoryPool *mp,
         if (preReserveSize[i] > 0)
         {
             assert(memoryPool);
-            memoryPool->preReservePool(preReserveSize[i]);
+            memoryPool->preReservePool(preReserveSize[i], (int)myType);
         }
         if (preReserveSingleInstanceSize[i] > 0)
         {
             assert(memoryPool);
-            memoryPool->preReserveSingleInstancePool(preReserveSingleInstanceSize[i]);
+            memoryPool->preReserveSingleInstancePool(preReserveSingleInstanceSize[i],
+                                                     (int)myType);
         }
     }
 
@@ -0,0 +1,208 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_DSP_PROCESSOR_QUAD_VOICE_FILTER_H
+#define SCXT_SRC_SCXT_CORE_DSP_PROCESSOR_QUAD_VOICE_FILTER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "sst/basic-blocks/simd/setup.h"
+
+#include "processor.h"
+
+namespace scxt::dsp::processor
+{
+/*
+ * A Cytomic (Simper) state variable filter with one voice in each SIMD lane, one register
+ * per channel. The processor wrapper runs a single voice with its channels in the lanes;
+ * a zone running voices in lockstep packs four voices here instead, the way Surge's quad
+ * filter chain does.
+ *
+ * The voices in a batch change as notes come and go, so the filter state lives with each
+ * voice and is gathered into the lanes for a block and scattered back after it.
+ */
+struct QuadVoiceSVF
+{
+    static constexpr int lanes{4};
+
+    // The order of the passband int param on the Cytomic SVF processor
+    enum Passband : int32_t
+    {
+        LP,
+        HP,
+        BP,
+        NOTCH,
+        PEAK,
+        ALL,
+        numPassbands
+    };
+
+    // Which of the processor's params feed the lanes; see fast-svf.json
+    static constexpr int fpCutoffL{0}, fpCutoffR{1}, fpResonance{2};
+    static constexpr int ipStereo{0}, ipPassband{1};
+
+    static constexpr int coeffs{6}; // a1 a2 a3, then the v0 v1 v2 output mix
+    struct VoiceState
+    {
+        // ic1eq then ic2eq, and the coefficients of the last block, per channel
+        float ic[2][2]{};
+        float c[2][coeffs]{};
+        bool primed{false};
+    };
+
+    // The shelf and bell passbands need the gain param, which this kernel doesn't do
+    static bool supports(ProcessorType t, const int32_t *ip)
+    {
+        return t == proct_CytomicSVF && ip[ipPassband] >= 0 && ip[ipPassband] < numPassbands;
+    }
+
+    /*
+     * Set up a lane for the block from the processor params. Cutoff is in semitones
+     * relative to A440 with the keytrack pitch already added, resonance is 0..1.
+     */
+    void setLane(int lane, const float *fp, const int32_t *ip, float pitch, float srInv,
+                 VoiceState &s)
+    {
+        auto stereo = ip[ipStereo] != 0;
+        for (int c = 0; c < 2; ++c)
+        {
+            float to[coeffs];
+            auto cutoff = fp[(c == 1 && stereo) ? fpCutoffR : fpCutoffL] + pitch;
+            makeCoefficients((Passband)ip[ipPassband], cutoff, fp[fpResonance], srInv, to);
+            if (!s.primed)
+                std::copy(to, to + coeffs, s.c[c]);
+            for (int k = 0; k < coeffs; ++k)
+            {
+                from[c][k][lane] = s.c[c][k];
+                target[c][k][lane] = to[k];
+            }
+            ic[c][0][lane] = s.ic[c][0];
+            ic[c][1][lane] = s.ic[c][1];
+        }
+        s.primed = true;
+    }
+
+    void storeLane(int lane, VoiceState &s) const
+    {
+        for (int c = 0; c < 2; ++c)
+        {
+            for (int k = 0; k < coeffs; ++k)
+                s.c[c][k] = target[c][k][lane];
+            s.ic[c][0] = ic[c][0][lane];
+            s.ic[c][1] = ic[c][1][lane];
+        }
+    }
+
+    /*
+     * Filter N samples for every lane, gliding the coefficients from the last block to this
+     * one. A null input is an idle lane or channel, which runs on silence and whose output
+     * is dropped.
+     */
+    template <int N> void process(float *const in[lanes][2], float *const out[lanes][2])
+    {
+        static constexpr float invN{1.f / N};
+        const auto two = SIMD_MM(set1_ps)(2.f);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            // A mono chain only feeds the left register
+            if (std::none_of(in, in + lanes, [c](auto *l) { return l[c] != nullptr; }))
+                continue;
+
+            SIMD_M128 cf[coeffs], dc[coeffs];
+            for (int k = 0; k < coeffs; ++k)
+            {
+                cf[k] = SIMD_MM(load_ps)(from[c][k]);
+                dc[k] = SIMD_MM(mul_ps)(SIMD_MM(sub_ps)(SIMD_MM(load_ps)(target[c][k]), cf[k]),
+                                        SIMD_MM(set1_ps)(invN));
+            }
+            auto ic1eq = SIMD_MM(load_ps)(ic[c][0]);
+            auto ic2eq = SIMD_MM(load_ps)(ic[c][1]);
+
+            float lane alignas(16)[lanes];
+            for (int i = 0; i < N; ++i)
+            {
+                for (int l = 0; l < lanes; ++l)
+                    lane[l] = in[l][c] ? in[l][c][i] : 0.f;
+                auto v0 = SIMD_MM(load_ps)(lane);
+
+                for (int k = 0; k < coeffs; ++k)
+                    cf[k] = SIMD_MM(add_ps)(cf[k], dc[k]);
+
+                auto v3 = SIMD_MM(sub_ps)(v0, ic2eq);
+                auto v1 =
+                    SIMD_MM(add_ps)(SIMD_MM(mul_ps)(cf[0], ic1eq), SIMD_MM(mul_ps)(cf[1], v3));
+                auto v2 = SIMD_MM(add_ps)(
+                    ic2eq,
+                    SIMD_MM(add_ps)(SIMD_MM(mul_ps)(cf[1], ic1eq), SIMD_MM(mul_ps)(cf[2], v3)));
+                ic1eq = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(two, v1), ic1eq);
+                ic2eq = SIMD_MM(sub_ps)(SIMD_MM(mul_ps)(two, v2), ic2eq);
+
+                auto res = SIMD_MM(add_ps)(
+                    SIMD_MM(mul_ps)(cf[3], v0),
+                    SIMD_MM(add_ps)(SIMD_MM(mul_ps)(cf[4], v1), SIMD_MM(mul_ps)(cf[5], v2)));
+                SIMD_MM(store_ps)(lane, res);
+                for (int l = 0; l < lanes; ++l)
+                    if (in[l][c])
+                        out[l][c][i] = lane[l];
+            }
+
+            SIMD_MM(store_ps)(ic[c][0], ic1eq);
+            SIMD_MM(store_ps)(ic[c][1], ic2eq);
+        }
+    }
+
+    static void makeCoefficients(Passband pb, float cutoff, float resonance, float srInv,
+                                 float c[coeffs])
+    {
+        auto freq = 440.f * std::pow(2.f, cutoff / 12.f);
+        freq = std::clamp(freq, 5.f, 0.499f / srInv);
+        auto g = std::tan((float)M_PI * freq * srInv);
+        auto k = 2.f - 2.f * std::clamp(resonance, 0.f, 0.98f);
+
+        c[0] = 1.f / (1.f + g * (g + k));
+        c[1] = g * c[0];
+        c[2] = g * c[1];
+
+        // high = v0 - k v1 - v2, low = v2, band = v1
+        static constexpr float mix[numPassbands][3]{{0, 0, 1}, {1, 0, -1}, {0, 1, 0},
+                                                    {1, 0, 0}, {-1, 0, 2}, {1, 0, 0}};
+        static constexpr float kmix[numPassbands]{0, -1, 0, -1, 1, -2};
+        c[3] = mix[pb][0];
+        c[4] = mix[pb][1] + kmix[pb] * k;
+        c[5] = mix[pb][2];
+    }
+
+  private:
+    float from alignas(16)[2][coeffs][lanes]{}, target alignas(16)[2][coeffs][lanes]{};
+    float ic alignas(16)[2][2][lanes]{};
+};
+} // namespace scxt::dsp::processor
+
+#endif // SCXT_SRC_SCXT_CORE_DSP_PROCESSOR_QUAD_VOICE_FILTER_H
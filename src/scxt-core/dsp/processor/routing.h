@@ -41,7 +41,7 @@ runSingleProcessor(int i, PitchPtr fpitch, Processor *processors[engine::process
                    bool processorConsumesMono[engine::processorCount], Mix &mix, Mix &outLev,
                    Endpoints *endpoints, bool &chainIsMono, float input[2][N], float output[2][N])
 {
-    if (processors[i]->bypassAnyway)
+    if (processors[i]->isBypassed())
     {
         return;
     }
@@ -136,9 +136,33 @@ runSingleProcessor(int i, PitchPtr fpitch, Processor *processors[engine::process
                            */
 }
 
+/*
+ * The mix and output level stage of runSingleProcessor for a processor whose wet signal
+ * was made elsewhere, as when voices run a filter in lanes (see
+ * Voice::processLockstepSlotInLanes). The caller has snapped the endpoint values.
+ */
+template <typename Mix, typename Endpoints, int N>
+inline void mixProcessorOutput(int i, Mix &mix, Mix &outLev, Endpoints *endpoints,
+                               bool chainIsMono, float output[2][N], float wet[2][N])
+{
+    mix[i].set_target(*endpoints->processorTarget[i].mixP);
+    mix[i].fade_blocks(output[0], wet[0], output[0]);
+    if (!chainIsMono)
+        mix[i].fade_blocks(output[1], wet[1], output[1]);
+
+    auto ol = *endpoints->processorTarget[i].outputLevelDbP;
+    ol = ol * ol * ol * dsp::processor::ProcessorStorage::maxOutputAmp;
+    outLev[i].set_target(ol);
+
+    if (chainIsMono)
+        outLev[i].multiply_block(output[0]);
+    else
+        outLev[i].multiply_2_blocks(output[0], output[1]);
+}
+
 inline bool isActive(Processor *processors[engine::processorCount], size_t idx)
 {
-    return processors[idx] && !processors[idx]->bypassAnyway;
+    return processors[idx] && !processors[idx]->isBypassed();
 }
 
 template <typename... Indices>
@@ -70,6 +70,30 @@ std::string getBusAddressLabel(BusAddress b, const std::string &defaultName = "D
 
 struct Engine;
 
+/*
+ * What zones, groups and parts accumulate into for one bus in one block. This is
+ * kept apart from the Bus so the bus effects can run on one block of input while
+ * the next block renders into a second BusInput. See Patch::processBusses.
+ */
+struct BusInput
+{
+    float output alignas(16)[2][blockSize]{};
+    float outputOS alignas(16)[2][blockSize << 1]{};
+    bool hasOSSignal{false};
+    bool used{false};
+
+    inline void clear()
+    {
+        if (!used)
+            return;
+        memset(output, 0, sizeof(output));
+        if (hasOSSignal)
+            memset(outputOS, 0, sizeof(outputOS));
+        hasOSSignal = false;
+        used = false;
+    }
+};
+
 struct Bus : MoveableOnly<Bus>, SampleRateSupport
 {
     static constexpr int maxEffectsPerBus{scxt::maxEffectsPerBus};
@@ -92,8 +116,8 @@ struct Bus : MoveableOnly<Bus>, SampleRateSupport
         }
     }
 
-    float output alignas(16)[2][blockSize];
-    float outputOS alignas(16)[2][blockSize << 1];
+    float output alignas(16)[2][blockSize]{};
+    float outputOS alignas(16)[2][blockSize << 1]{};
     bool hasOSSignal{false}, previousHadOSSignal{false};
     float auxoutputPreFX alignas(16)[2][blockSize];
     float auxoutputPreVCA alignas(16)[2][blockSize];
@@ -111,7 +135,9 @@ struct Bus : MoveableOnly<Bus>, SampleRateSupport
     inline void clear()
     {
         memset(output, 0, sizeof(output));
-        memset(outputOS, 0, sizeof(outputOS));
+        // outputOS is only ever read, or written, in a block which sets hasOSSignal
+        if (hasOSSignal)
+            memset(outputOS, 0, sizeof(outputOS));
         hasOSSignal = false;
         inRingout = true;
         silenceMaxSelf = 0;
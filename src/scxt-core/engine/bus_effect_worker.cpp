@@ -0,0 +1,142 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "bus_effect_worker.h"
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "patch.h"
+
+namespace scxt::engine
+{
+BusEffectWorker::BusEffectWorker()
+{
+    worker = std::thread([this]() { workerLoop(); });
+#if defined(__linux__) || defined(__APPLE__)
+    // Best effort, as with the voice render pool
+    sched_param sp{};
+    sp.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(worker.native_handle(), SCHED_FIFO, &sp);
+#endif
+    SCLOG_IF(always, "Bus effect worker started");
+}
+
+BusEffectWorker::~BusEffectWorker()
+{
+    keepRunning.store(false, std::memory_order_seq_cst);
+    wakeWorker.wake();
+    worker.join();
+}
+
+void BusEffectWorker::begin(Patch *p, int slot)
+{
+    assert(state.load(std::memory_order_relaxed) == IDLE);
+    patch = p;
+    inputSlot = slot;
+    if (inlineBlocksLeft > 0)
+    {
+        inlineBlocksLeft--;
+        runInline = true;
+        return;
+    }
+    state.store(POSTED, std::memory_order_seq_cst);
+    wakeWorker.wake();
+}
+
+bool BusEffectWorker::claim()
+{
+    uint32_t expected{POSTED};
+    return state.compare_exchange_strong(expected, RUNNING, std::memory_order_acq_rel,
+                                         std::memory_order_acquire);
+}
+
+void BusEffectWorker::run()
+{
+    patch->processBusses(inputSlot);
+    state.store(DONE, std::memory_order_release);
+}
+
+void BusEffectWorker::finish()
+{
+    if (runInline)
+    {
+        runInline = false;
+        patch->processBusses(inputSlot);
+        return;
+    }
+
+    if (claim())
+    {
+        run();
+    }
+    else
+    {
+        waitForWorker();
+    }
+    state.store(IDLE, std::memory_order_relaxed);
+}
+
+void BusEffectWorker::waitForWorker()
+{
+    if (state.load(std::memory_order_acquire) == DONE)
+        return;
+
+    auto deadline = std::chrono::steady_clock::now() + finishDeadline;
+    bool overran{false};
+    while (state.load(std::memory_order_acquire) != DONE)
+    {
+        if (!overran && std::chrono::steady_clock::now() > deadline)
+        {
+            overran = true;
+            finishOverruns.fetch_add(1, std::memory_order_relaxed);
+            inlineBlocksLeft = overrunInlineBlocks;
+        }
+    }
+}
+
+void BusEffectWorker::workerLoop()
+{
+    while (keepRunning.load(std::memory_order_acquire))
+    {
+        if (state.load(std::memory_order_acquire) == POSTED && claim())
+        {
+            run();
+            continue;
+        }
+
+        wakeWorker.sleepUnless(
+            [this]() {
+                return !keepRunning.load(std::memory_order_seq_cst) ||
+                       state.load(std::memory_order_seq_cst) == POSTED;
+            },
+            workerWakeLimit);
+    }
+}
+} // namespace scxt::engine
@@ -0,0 +1,119 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_ENGINE_BUS_EFFECT_WORKER_H
+#define SCXT_SRC_SCXT_CORE_ENGINE_BUS_EFFECT_WORKER_H
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "configuration.h"
+#include "utils.h"
+#include "infrastructure/worker_wake.h"
+
+namespace scxt::engine
+{
+struct Patch;
+
+/*
+ * The BusEffectWorker is an optional pre-spawned thread which runs the bus pass
+ * (sends, part, aux and main bus effects) for the previous block while the audio
+ * thread renders the voices of this one. Patch::process drives it with begin and
+ * finish around part rendering, so it only ever runs between those two calls.
+ * Messages and structure changes which reach the busses run before begin, so the
+ * worker never races them.
+ *
+ * This adds one internal block of latency, which the engine reports through
+ * getLatencySamples for the plugin to pass on to the host.
+ *
+ * If the worker has not picked the job up by the time finish is called, the audio
+ * thread takes it back and runs it inline, so a worker which is asleep costs at most
+ * the serial time. The worker sleeps between blocks. The audio thread only waits on
+ * a pass which is already running, and spins for it without sleeping. If that takes
+ * longer than finishDeadline the worker was descheduled mid pass, and the audio
+ * thread runs the bus pass itself for the next overrunInlineBlocks blocks.
+ */
+struct BusEffectWorker : MoveableOnly<BusEffectWorker>
+{
+    BusEffectWorker();
+    ~BusEffectWorker();
+
+    static constexpr uint32_t latencyInSamples{blockSize};
+
+    /*
+     * Post the bus pass for the given input slot. Audio thread only.
+     */
+    void begin(Patch *patch, int inputSlot);
+    /*
+     * Return once the posted bus pass has run. Audio thread only.
+     */
+    void finish();
+
+    // The worker re-checks for a posted pass this often even if it missed a wake up
+    static constexpr std::chrono::microseconds workerWakeLimit{1000};
+    // How long finish waits on a pass already running before it stops handing passes
+    // to the worker, and for how many blocks
+    static constexpr std::chrono::microseconds finishDeadline{100};
+    static constexpr int overrunInlineBlocks{256};
+
+    uint64_t getFinishOverruns() const { return finishOverruns.load(std::memory_order_relaxed); }
+
+  private:
+    enum State : uint32_t
+    {
+        IDLE,
+        POSTED,
+        RUNNING,
+        DONE
+    };
+
+    bool claim();
+    void run();
+    void workerLoop();
+
+    void waitForWorker();
+
+    Patch *patch{nullptr};
+    int inputSlot{0};
+    // Audio thread only
+    bool runInline{false};
+    int inlineBlocksLeft{0};
+
+    alignas(64) std::atomic<uint32_t> state{IDLE};
+    std::atomic<bool> keepRunning{true};
+    std::atomic<uint64_t> finishOverruns{0};
+
+    infrastructure::WorkerWake wakeWorker;
+
+    std::thread worker;
+};
+} // namespace scxt::engine
+
+#endif // SCXT_SRC_SCXT_CORE_ENGINE_BUS_EFFECT_WORKER_H
@@ -56,6 +56,7 @@
 #include "gig.h"
 #include "SF.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <mutex>
 #include "messaging/client/client_serial.h"
@@ -78,6 +79,7 @@ Engine::Engine()
                                 << " / "
                                 << sst::plugininfra::VersionInformation::project_version_and_hash);
     SCLOG_IF(always, "    Stream V  = " << humanReadableVersion(scxt::currentStreamingVersion));
+    SCLOG_IF(always, "    Block     = " << scxt::blockSize);
 
     memset(cpuAverages, 0, sizeof(cpuAverages));
 
@@ -136,6 +138,7 @@ Engine::Engine()
     selectionManager = std::make_unique<selection::SelectionManager>(*this);
 
     memoryPool = std::make_unique<MemoryPool>();
+    memoryPool->preReservePool(voice::Voice::unisonGeneratorBytes);
 
     voice::Voice::ahdsrenv_t::initializeLuts();
 
@@ -165,11 +168,53 @@ Engine::Engine()
     runtimeConfig.applyOmniToAllPartsOnSelect = defaults->getUserDefaultValue(
         scxt::infrastructure::DefaultKeys::applyOmniToAllOnSelect, false);
 
+    setVoiceRenderWorkerCount(defaults->getUserDefaultValue(
+        scxt::infrastructure::DefaultKeys::voiceRenderWorkerThreads, 0));
+
+    setPipelinedBusEffects(defaults->getUserDefaultValue(
+        scxt::infrastructure::DefaultKeys::pipelinedBusEffects, false));
+
+    setQuadVoiceFilters(
+        defaults->getUserDefaultValue(scxt::infrastructure::DefaultKeys::quadVoiceFilters, false));
+
+    if (defaults->getUserDefaultValue(scxt::infrastructure::DefaultKeys::jsonWireFormat, false))
+    {
+        messageController->wireFormat = messaging::MessageController::WireFormat::JSON;
+    }
+
+    // Audio isn't running yet, so this is where the voice manager may grow its maps
+    for (auto k = PolyphonyGroupKeys::forPart(0); k < PolyphonyGroupKeys::endKey; ++k)
+    {
+        voiceManager.guaranteeGroup(k);
+    }
     onPartConfigurationUpdated();
 }
 
+void Engine::setVoiceRenderWorkerCount(int workers)
+{
+    voiceRenderPool.reset();
+    if (workers > 0)
+    {
+        voiceRenderPool = std::make_unique<VoiceRenderPool>(workers);
+    }
+}
+
+void Engine::setPipelinedBusEffects(bool pipelined)
+{
+    busEffectWorker.reset();
+    if (pipelined)
+    {
+        busEffectWorker = std::make_unique<BusEffectWorker>();
+    }
+    // Anything left in the pending slot belonged to the old arrangement
+    getPatch()->busses.inputPending = false;
+}
+
 Engine::~Engine()
 {
+    voiceRenderPool.reset();
+    busEffectWorker.reset();
+
     for (auto &v : voices)
     {
         if (v)
@@ -291,7 +336,7 @@ void Engine::immediatelyTerminateAllVoices()
     int idx{0};
     for (auto &v : voices)
     {
-        if (v && v->isVoiceAssigned && v->isVoicePlaying)
+        if (v && v->isVoiceAssigned && v->isSounding())
             toCleanUp[idx++] = v;
     }
 
@@ -305,12 +350,29 @@ void Engine::immediatelyTerminateAllVoices()
     forceVoiceUpdate = true;
 }
 
+bool Engine::runStructureCallback(void *p)
+{
+    if (!structureGate.tryEnterWrite())
+        return false;
+
+    auto cb = static_cast<messaging::MessageController::AudioThreadCallback *>(p);
+    cb->execBatch(*this);
+    structureGate.exitWrite();
+
+    messaging::audio::AudioToSerialization rt;
+    rt.id = messaging::audio::a2s_pointer_complete;
+    rt.payloadType = messaging::audio::AudioToSerialization::VOID_STAR;
+    rt.payload.p = (void *)cb;
+    messageController->audioToSerializationQueue.push(rt);
+    return true;
+}
+
 bool Engine::processAudio()
 {
     auto processingStartTime = std::chrono::high_resolution_clock::now();
 
     namespace mech = sst::basic_blocks::mechanics;
-#if BUILD_IS_DEBUG
+#if BUILD_IS_DEBUG || SCXT_AUDIO_THREAD_GUARD
     messageController->threadingChecker.registerAsAudioThread();
 #endif
     messageController->engineProcessRuns++;
@@ -318,6 +380,14 @@ bool Engine::processAudio()
     auto av = (uint32_t)activeVoices;
 
     bool tryToDrain{true};
+    if (deferredStructureCallback)
+    {
+        // Still blocked means everything queued behind it waits another block too
+        if (runStructureCallback(deferredStructureCallback))
+            deferredStructureCallback = nullptr;
+        else
+            tryToDrain = false;
+    }
     while (tryToDrain && !messageController->serializationToAudioQueue.empty())
     {
         auto msgopt = messageController->serializationToAudioQueue.pop();
@@ -332,7 +402,7 @@ bool Engine::processAudio()
         {
             auto cb =
                 static_cast<messaging::MessageController::AudioThreadCallback *>(msgopt->payload.p);
-            cb->exec(*this);
+            cb->execBatch(*this);
 
             messaging::audio::AudioToSerialization rt;
             rt.id = messaging::audio::a2s_pointer_complete;
@@ -343,16 +413,11 @@ bool Engine::processAudio()
         break;
         case messaging::audio::s2a_dispatch_to_pointer_under_structurelock:
         {
-            std::lock_guard<std::mutex> structG(modifyStructureMutex);
-            auto cb =
-                static_cast<messaging::MessageController::AudioThreadCallback *>(msgopt->payload.p);
-            cb->exec(*this);
-
-            messaging::audio::AudioToSerialization rt;
-            rt.id = messaging::audio::a2s_pointer_complete;
-            rt.payloadType = messaging::audio::AudioToSerialization::VOID_STAR;
-            rt.payload.p = (void *)cb;
-            messageController->audioToSerializationQueue.push(rt);
+            if (!runStructureCallback(msgopt->payload.p))
+            {
+                deferredStructureCallback = msgopt->payload.p;
+                tryToDrain = false;
+            }
         }
         break;
         case messaging::audio::s2a_param_beginendedit:
@@ -368,10 +433,14 @@ bool Engine::processAudio()
         }
     }
 
+    processPatchSwap();
+
     getPatch()->busses.clear();
 
     if (stopEngineRequests > 0)
     {
+        // Whatever was waiting on the bus effect worker predates the stop
+        getPatch()->busses.inputPending = false;
         return true;
     }
 
@@ -388,6 +457,8 @@ bool Engine::processAudio()
         mech::accumulate_from_to<blockSize>(previewVoice->output[1], main[1]);
     }
 
+    applyPatchSwapFade();
+
     if (previewVoice->schedulePurge)
     {
         previewVoice->schedulePurge = false;
@@ -431,31 +502,26 @@ bool Engine::processAudio()
         lastUpdateVoiceDisplayState = 0;
         lastMidiNoteStateCounter = midiNoteStateCounter;
 
-        int i{0};
+        auto &vds = sharedUIMemoryState.voiceDisplay.writeBuffer();
+        int32_t n{0};
         for (const auto *v : voices)
         {
-            auto &itm = sharedUIMemoryState.voiceDisplayItems[i];
-
             if (v && (v->isVoiceAssigned && v->isVoicePlaying))
             {
-                itm.active = true;
-                itm.part = v->zonePath.part;
-                itm.group = v->zonePath.group;
-                itm.zone = v->zonePath.zone;
-                itm.sample = v->sampleIndex;
-                itm.samplePos = v->GD[0].samplePos;
-                itm.midiNote = v->originalMidiKey;
-                itm.midiChannel = v->channel;
+                auto &itm = vds.items[n++];
+                itm.part = (int32_t)v->zonePath.part;
+                itm.group = (int32_t)v->zonePath.group;
+                itm.zone = (int32_t)v->zonePath.zone;
+                itm.sample = (int32_t)v->sampleIndex;
+                itm.samplePos = v->firstGenerator.state.samplePos;
+                itm.midiNote = (int16_t)v->originalMidiKey;
+                itm.midiChannel = (int16_t)v->channel;
                 itm.gated = v->isGated;
             }
-            else
-            {
-                itm.active = false;
-            }
-            i++;
         }
-        sharedUIMemoryState.voiceCount = pav;
-        sharedUIMemoryState.voiceDisplayStateWriteCounter++;
+        vds.itemCount = n;
+        vds.voiceCount = pav;
+        sharedUIMemoryState.voiceDisplay.publish();
     }
     lastUpdateVoiceDisplayState++;
 
@@ -472,6 +538,8 @@ bool Engine::processAudio()
     cpuWP = (cpuWP + 1) & (cpuAverageObservation - 1);
     cpuAvg += (pct - ppct) / cpuAverageObservation;
     sharedUIMemoryState.cpuLevel = cpuAvg;
+    sharedUIMemoryState.memoryPoolBytes.store(memoryPool->getReservedBytes(),
+                                              std::memory_order_relaxed);
     return true;
 }
 
@@ -511,13 +579,22 @@ Engine::getProcessorStorage(const processorAddress_t &addr) const
     return {};
 }
 
-Engine::pgzStructure_t Engine::getPartGroupZoneStructure() const
+Engine::pgzStructure_t Engine::getPartGroupZoneStructure(std::vector<int64_t> *stableKeys) const
 {
     Engine::pgzStructure_t res;
+    // The kind goes above the id so a group and a zone with the same id differ
+    auto key = [stableKeys](int64_t kind, int32_t id) {
+        if (stableKeys)
+            stableKeys->push_back((kind << 32) | (uint32_t)id);
+    };
+    if (stableKeys)
+        stableKeys->clear();
+
     int32_t partidx{0};
     for (const auto &part : *patch)
     {
         res.push_back({{partidx, -1, -1}, part->getName()});
+        key(1, partidx);
 
         int32_t groupidx{0};
         for (const auto &group : *part)
@@ -528,6 +605,7 @@ Engine::pgzStructure_t Engine::getPartGroupZoneStructure() const
                 groupFeatures += GroupZoneFeatures::MUTED;
             }
             res.push_back({{partidx, groupidx, -1}, group->getName(), groupFeatures});
+            key(2, group->id.id);
             int32_t zoneidx{0};
             for (const auto &zone : *group)
             {
@@ -538,6 +616,7 @@ Engine::pgzStructure_t Engine::getPartGroupZoneStructure() const
                 }
 
                 res.push_back({{partidx, groupidx, zoneidx}, zone->getName(), zoneFeatures});
+                key(3, zone->id.id);
                 zoneidx++;
             }
 
@@ -557,6 +636,163 @@ Engine::pgzStructure_t Engine::getPartGroupZoneStructure() const
     return res;
 }
 
+void Engine::sendPartGroupZoneStructureToClient(bool forceFull)
+{
+    auto &cont = *messageController;
+    assert(cont.threadingChecker.isSerialThread());
+    auto &sent = cont.sentStructure;
+
+    std::vector<int64_t> keys;
+    auto structure = getPartGroupZoneStructure(&keys);
+    auto fromVersion = sent.version;
+    sent.version++;
+
+    // A client which isn't there misses the send, so start over when it connects
+    bool sendFull = forceFull || !sent.valid || !cont.isClientConnected;
+    if (!sendFull)
+    {
+        auto ops = diffPartGroupZoneStructure(sent.structure, sent.keys, structure, keys);
+        size_t carried{0};
+        for (const auto &op : ops)
+            carried += std::get<3>(op).size();
+
+        // Past about half the structure the full list is as cheap to send and to apply
+        if (carried * 2 < structure.size())
+        {
+            SCLOG_IF(uiStructure, "Sending structure delta " << fromVersion << " -> " << sent.version
+                                                             << " with " << ops.size() << " ops");
+            serializationSendToClient(
+                messaging::client::s2c_send_pgz_structure_delta,
+                pgzStructureDelta_t{fromVersion, sent.version, std::move(ops)}, cont);
+        }
+        else
+        {
+            sendFull = true;
+        }
+    }
+
+    if (sendFull)
+    {
+        serializationSendToClient(messaging::client::s2c_send_pgz_structure,
+                                  pgzVersionedStructure_t{sent.version, structure}, cont);
+    }
+
+    sent.valid = cont.isClientConnected;
+    sent.structure = std::move(structure);
+    sent.keys = std::move(keys);
+}
+
+std::vector<Engine::pgzDeltaOp_t>
+Engine::diffPartGroupZoneStructure(const pgzStructure_t &from, const std::vector<int64_t> &fromKeys,
+                                   const pgzStructure_t &to, const std::vector<int64_t> &toKeys)
+{
+    assert(from.size() == fromKeys.size() && to.size() == toKeys.size());
+
+    /*
+     * Edits are almost always in one place, so trim the common run at each end and
+     * replace what is left in the middle. A move from one end of a part to the other
+     * resends everything between, which is no worse than the full list.
+     */
+    size_t n0 = from.size(), n1 = to.size();
+    size_t pre{0}, suf{0};
+    while (pre < n0 && pre < n1 && fromKeys[pre] == toKeys[pre])
+        pre++;
+    while (suf < n0 - pre && suf < n1 - pre && fromKeys[n0 - 1 - suf] == toKeys[n1 - 1 - suf])
+        suf++;
+
+    std::vector<pgzDeltaOp_t> res;
+    if (n0 - pre - suf > 0)
+    {
+        res.emplace_back(PGZ_REMOVE, (int32_t)pre, (int32_t)(n0 - pre - suf), pgzStructure_t{});
+    }
+    if (n1 - pre - suf > 0)
+    {
+        res.emplace_back(PGZ_INSERT, (int32_t)pre, (int32_t)(n1 - pre - suf),
+                         pgzStructure_t(to.begin() + pre, to.begin() + (n1 - suf)));
+    }
+
+    // Entries kept at either end can still have been renamed or muted
+    auto updateRun = [&](size_t fromStart, size_t toStart, size_t count) {
+        size_t i{0};
+        while (i < count)
+        {
+            const auto &a = from[fromStart + i];
+            const auto &b = to[toStart + i];
+            if (a.name == b.name && a.features == b.features)
+            {
+                i++;
+                continue;
+            }
+            auto runStart = i;
+            pgzStructure_t run;
+            while (i < count && (from[fromStart + i].name != to[toStart + i].name ||
+                                 from[fromStart + i].features != to[toStart + i].features))
+            {
+                run.push_back(to[toStart + i]);
+                i++;
+            }
+            res.emplace_back(PGZ_UPDATE, (int32_t)(toStart + runStart), (int32_t)run.size(),
+                             std::move(run));
+        }
+    };
+    updateRun(0, 0, pre);
+    updateRun(n0 - suf, n1 - suf, suf);
+
+    return res;
+}
+
+void Engine::applyPartGroupZoneStructureDelta(pgzStructure_t &onto,
+                                              const std::vector<pgzDeltaOp_t> &ops)
+{
+    for (const auto &op : ops)
+        applyPartGroupZoneStructureOp(onto, op);
+    renumberPartGroupZoneStructure(onto);
+}
+
+void Engine::applyPartGroupZoneStructureOp(pgzStructure_t &onto, const pgzDeltaOp_t &op)
+{
+    const auto &[kind, idx, count, entries] = op;
+    auto at = std::clamp((size_t)std::max(idx, 0), (size_t)0, onto.size());
+    switch (kind)
+    {
+    case PGZ_REMOVE:
+        onto.erase(onto.begin() + at, onto.begin() + std::min(at + count, onto.size()));
+        break;
+    case PGZ_INSERT:
+        onto.insert(onto.begin() + at, entries.begin(), entries.end());
+        break;
+    case PGZ_UPDATE:
+        for (size_t i = 0; i < entries.size() && at + i < onto.size(); ++i)
+            onto[at + i] = entries[i];
+        break;
+    }
+}
+
+void Engine::renumberPartGroupZoneStructure(pgzStructure_t &onto)
+{
+    // The kind of each entry is fixed but its position may have moved
+    int32_t p{-1}, g{-1}, z{-1};
+    for (auto &e : onto)
+    {
+        if (e.address.group < 0)
+        {
+            p = e.address.part;
+            g = -1;
+        }
+        else if (e.address.zone < 0)
+        {
+            g++;
+            z = -1;
+            e.address = {p, g, -1};
+        }
+        else
+        {
+            z++;
+            e.address = {p, g, z};
+        }
+    }
+}
+
 void Engine::loadCompoundElementIntoZone(const sample::compound::CompoundElement &p, int16_t partID,
                                          int16_t groupID, int16_t zoneID, int variantID)
 {
@@ -675,8 +911,7 @@ void Engine::loadCompoundElementIntoSelectedPartAndGroup(const sample::compound:
                 auto res =
                     sf2_support::importSF2(p.sampleAddress.path, *this, p.sampleAddress.preset);
                 messageController->restartAudioThreadFromSerial();
-                serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                          getPartGroupZoneStructure(), *messageController);
+                sendPartGroupZoneStructureToClient();
             });
             return;
         }
@@ -688,8 +923,7 @@ void Engine::loadCompoundElementIntoSelectedPartAndGroup(const sample::compound:
                     RAISE_ERROR_CONT(*messageController, "SFZ Import Failed",
                                      "Check log for errors");
                 messageController->restartAudioThreadFromSerial();
-                serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                          getPartGroupZoneStructure(), *messageController);
+                sendPartGroupZoneStructureToClient();
             });
             return;
         }
@@ -699,8 +933,7 @@ void Engine::loadCompoundElementIntoSelectedPartAndGroup(const sample::compound:
                 auto res =
                     gig_support::importGIG(p.sampleAddress.path, *this, p.sampleAddress.preset);
                 messageController->restartAudioThreadFromSerial();
-                serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                          getPartGroupZoneStructure(), *messageController);
+                sendPartGroupZoneStructureToClient();
             });
             return;
         }
@@ -709,8 +942,7 @@ void Engine::loadCompoundElementIntoSelectedPartAndGroup(const sample::compound:
             messageController->stopAudioThreadThenRunOnSerial([this, p](const auto &) {
                 auto res = akai_support::importAKP(p.sampleAddress.path, *this);
                 messageController->restartAudioThreadFromSerial();
-                serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                          getPartGroupZoneStructure(), *messageController);
+                sendPartGroupZoneStructureToClient();
             });
             return;
         }
@@ -779,8 +1011,7 @@ void Engine::loadSampleIntoSelectedPartAndGroup(const fs::path &p, int16_t rootK
         messageController->stopAudioThreadThenRunOnSerial([this, p](const auto &) {
             sf2_support::importSF2(p, *this, -1);
             messageController->restartAudioThreadFromSerial();
-            serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                      getPartGroupZoneStructure(), *messageController);
+            sendPartGroupZoneStructureToClient();
         });
         return;
     }
@@ -793,8 +1024,7 @@ void Engine::loadSampleIntoSelectedPartAndGroup(const fs::path &p, int16_t rootK
                 RAISE_ERROR_CONT(*messageController, "SFZ Import Failed",
                                  "Check log for further errors");
             messageController->restartAudioThreadFromSerial();
-            serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                      getPartGroupZoneStructure(), *messageController);
+            sendPartGroupZoneStructureToClient();
         });
         return;
     }
@@ -807,8 +1037,7 @@ void Engine::loadSampleIntoSelectedPartAndGroup(const fs::path &p, int16_t rootK
                 RAISE_ERROR_CONT(*messageController, "EXS Import Failed",
                                  "Check log for subsequent errors");
             messageController->restartAudioThreadFromSerial();
-            serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                      getPartGroupZoneStructure(), *messageController);
+            sendPartGroupZoneStructureToClient();
         });
         return;
     }
@@ -820,8 +1049,7 @@ void Engine::loadSampleIntoSelectedPartAndGroup(const fs::path &p, int16_t rootK
                 RAISE_ERROR_CONT(*messageController, "Multisample Import Failed",
                                  "Check log for subsequent errors");
             messageController->restartAudioThreadFromSerial();
-            serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                      getPartGroupZoneStructure(), *messageController);
+            sendPartGroupZoneStructureToClient();
         });
         return;
     }
@@ -833,8 +1061,7 @@ void Engine::loadSampleIntoSelectedPartAndGroup(const fs::path &p, int16_t rootK
                 RAISE_ERROR_CONT(*messageController, "AKP Import Failed",
                                  "Check log for subsequent errors");
             messageController->restartAudioThreadFromSerial();
-            serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                      getPartGroupZoneStructure(), *messageController);
+            sendPartGroupZoneStructureToClient();
         });
         return;
     }
@@ -844,8 +1071,7 @@ void Engine::loadSampleIntoSelectedPartAndGroup(const fs::path &p, int16_t rootK
         messageController->stopAudioThreadThenRunOnSerial([this, p](const auto &) {
             gig_support::importGIG(p, *this, -1);
             messageController->restartAudioThreadFromSerial();
-            serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                      getPartGroupZoneStructure(), *messageController);
+            sendPartGroupZoneStructureToClient();
         });
         return;
     }
@@ -1389,7 +1615,7 @@ std::optional<fs::path> Engine::setupUserStorageDirectory()
     return std::nullopt;
 }
 
-void Engine::sendFullRefreshToClient() const
+void Engine::sendFullRefreshToClient()
 {
     auto &cont = getMessageController();
     assert(cont->threadingChecker.isSerialThread());
@@ -1406,8 +1632,7 @@ void Engine::sendFullRefreshToClient() const
         runtimeConfig.tuningAwarePitchBends, *getMessageController());
 
     sendMetadataToClient();
-    serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                              getPartGroupZoneStructure(), *cont);
+    sendPartGroupZoneStructureToClient(true);
     if (getSelectionManager()->currentLeadZone(*this).has_value())
     {
         // We want to re-send the action as if a lead was selected.
@@ -1478,6 +1703,136 @@ void Engine::clearAll(bool alsoPurge)
         sampleManager->purgeUnreferencedSamples();
 }
 
+void Engine::swapPatchInBackground(std::unique_ptr<PatchSwap> swap)
+{
+    assert(messageController->threadingChecker.isSerialThread());
+    assert(swap && swap->patch);
+    if (pendingPatchSwap)
+    {
+        SCLOG_IF(patchIO, "Patch swap already in flight; queueing this one behind it");
+        queuedPatchSwap = std::move(swap);
+        return;
+    }
+    pendingPatchSwap = std::move(swap);
+    startPatchSwap();
+}
+
+void Engine::startPatchSwap()
+{
+    auto ps = pendingPatchSwap.get();
+    ps->dialect = applyPartConfiguration(*ps->patch, ps->partVoiceLimits);
+    if (!messageController->isAudioRunning)
+    {
+        std::swap(patch, ps->patch);
+        runtimeConfig = ps->runtimeConfig;
+        resetTuningFromRuntimeConfig();
+        voiceManager.dialect = ps->dialect;
+        applyPartVoiceLimits(ps->partVoiceLimits);
+        resetGroupPlaymodes();
+        completePatchSwap(ps);
+        return;
+    }
+
+    messageController->scheduleAudioThreadCallback([ps](Engine &e) {
+        e.incomingPatchSwap = ps;
+        e.patchSwapFadeOut = ps->policy == PatchSwapPolicy::FADE ? patchSwapFadeBlocks : 0;
+        e.patchSwapFadeIn = 0;
+    });
+}
+
+void Engine::processPatchSwap()
+{
+    if (!incomingPatchSwap || patchSwapFadeOut > 0)
+        return;
+
+    // Anything held back this block may still refer to the old patch, so let it land first
+    if (deferredStructureCallback || !structureGate.tryEnterWrite())
+        return;
+
+    immediatelyTerminateAllVoices();
+    std::swap(patch, incomingPatchSwap->patch);
+    runtimeConfig = incomingPatchSwap->runtimeConfig;
+    resetTuningFromRuntimeConfig();
+    voiceManager.dialect = incomingPatchSwap->dialect;
+    applyPartVoiceLimits(incomingPatchSwap->partVoiceLimits);
+    resetGroupPlaymodes();
+    structureGate.exitWrite();
+
+    if (incomingPatchSwap->policy == PatchSwapPolicy::FADE)
+        patchSwapFadeIn = patchSwapFadeBlocks;
+
+    messaging::audio::AudioToSerialization rt;
+    rt.id = messaging::audio::a2s_patch_swapped;
+    rt.payloadType = messaging::audio::AudioToSerialization::VOID_STAR;
+    rt.payload.p = (void *)incomingPatchSwap;
+    messageController->audioToSerializationQueue.push(rt);
+    incomingPatchSwap = nullptr;
+}
+
+void Engine::applyPatchSwapFade()
+{
+    float g0, g1;
+    if (incomingPatchSwap && incomingPatchSwap->policy == PatchSwapPolicy::FADE)
+    {
+        g0 = (float)patchSwapFadeOut / patchSwapFadeBlocks;
+        if (patchSwapFadeOut > 0)
+            patchSwapFadeOut--;
+        g1 = (float)patchSwapFadeOut / patchSwapFadeBlocks;
+    }
+    else if (patchSwapFadeIn > 0)
+    {
+        g0 = (float)(patchSwapFadeBlocks - patchSwapFadeIn) / patchSwapFadeBlocks;
+        patchSwapFadeIn--;
+        g1 = (float)(patchSwapFadeBlocks - patchSwapFadeIn) / patchSwapFadeBlocks;
+    }
+    else
+    {
+        return;
+    }
+
+    auto ramp = [g0, dg = (float)((g1 - g0) * blockSizeInv)](float *d) {
+        auto g = g0;
+        for (int i = 0; i < blockSize; ++i)
+        {
+            d[i] *= g;
+            g += dg;
+        }
+    };
+
+    auto &bs = getPatch()->busses;
+    ramp(bs.mainBus.output[0]);
+    ramp(bs.mainBus.output[1]);
+    for (int i = 0; i < numNonMainPluginOutputs; ++i)
+    {
+        if (bs.usesOutput[i + 1])
+        {
+            ramp(bs.pluginNonMainOutputs[i][0]);
+            ramp(bs.pluginNonMainOutputs[i][1]);
+        }
+    }
+}
+
+void Engine::completePatchSwap(PatchSwap *swap)
+{
+    assert(messageController->threadingChecker.isSerialThread());
+    assert(swap && swap == pendingPatchSwap.get());
+
+    auto done = std::move(pendingPatchSwap);
+    // This now holds the old patch, which nothing on the audio thread can reach
+    done->patch.reset();
+    if (done->stagedSamples)
+        sampleManager->mergeStaged(std::move(*done->stagedSamples));
+    selectionManager = std::make_unique<selection::SelectionManager>(*this);
+    if (done->onSwapped)
+        done->onSwapped(*this);
+
+    if (queuedPatchSwap)
+    {
+        pendingPatchSwap = std::move(queuedPatchSwap);
+        startPatchSwap();
+    }
+}
+
 void Engine::setMacro01ValueFromPlugin(int part, int index, float value01)
 {
     // Open Question: What about with paramFlush
@@ -1511,10 +1866,37 @@ void Engine::processNoteOffEvent(int16_t port, int16_t channel, int16_t key, int
 }
 
 void Engine::onPartConfigurationUpdated()
+{
+    partVoiceLimits_t limits;
+    voiceManager.dialect = applyPartConfiguration(*getPatch(), limits);
+    applyPartVoiceLimits(limits);
+}
+
+void Engine::applyPartVoiceLimits(const partVoiceLimits_t &limits)
+{
+    for (int16_t i = 0; i < numParts; ++i)
+    {
+        voiceManager.setPolyphonyGroupVoiceLimit(PolyphonyGroupKeys::forPart(i), limits[i]);
+    }
+}
+
+void Engine::resetGroupPlaymodes()
+{
+    for (auto &p : *getPatch())
+    {
+        for (auto &g : *p)
+        {
+            g->resetPolyAndPlaymode(*this);
+        }
+    }
+}
+
+Engine::voiceManager_t::MIDI1Dialect Engine::applyPartConfiguration(Patch &onto,
+                                                                    partVoiceLimits_t &limits)
 {
     auto midiM = voiceManager_t::MIDI1Dialect::MIDI1;
     auto anySolo = false;
-    for (auto &p : *getPatch())
+    for (auto &p : onto)
     {
         if (p->configuration.channel == Part::PartConfiguration::mpeChannel)
             midiM = voiceManager_t::MIDI1Dialect::MIDI1_MPE;
@@ -1522,19 +1904,17 @@ void Engine::onPartConfigurationUpdated()
             anySolo = true;
         p->configuration.muteDueToSolo = false;
 
-        voiceManager.setPolyphonyGroupVoiceLimit((uint64_t)p.get(),
-                                                 p->configuration.polyLimitVoices);
+        limits[p->partNumber] = p->configuration.polyLimitVoices;
     }
 
-    voiceManager.dialect = midiM;
-
     if (anySolo)
     {
-        for (auto &p : *getPatch())
+        for (auto &p : onto)
         {
             p->configuration.muteDueToSolo = !p->configuration.solo;
         }
     }
+    return midiM;
 }
 
 void Engine::prepareToStream()
@@ -53,6 +53,11 @@
 
 #include "selection/selection_manager.h"
 #include "memory_pool.h"
+#include "structure_gate.h"
+#include "polyphony_group_keys.h"
+#include "voice_render_pool.h"
+#include "bus_effect_worker.h"
+#include "infrastructure/triple_buffer.h"
 #include "tuning/midikey_retuner.h"
 #include "sst/basic-blocks/dsp/RNG.h"
 
@@ -120,8 +125,12 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
 
     /**
      * Midi-style events. Each event is assumed to be at the top of the
-     * blockSize sample block
+     * blockSize sample block, unless the caller sets noteEventSampleOffset to
+     * say how far into the coming block it lands. Voices started by it are then
+     * delayed by that much, and voices released by it start their amplitude
+     * release at that sample, so note ons and offs stay sample accurate.
      */
+    uint16_t noteEventSampleOffset{0};
     void processMIDI1Event(uint16_t midiPort, const uint8_t data[3]);
     void processNoteOnEvent(int16_t port, int16_t channel, int16_t key, int32_t note_id,
                             double velocity, float retune);
@@ -161,8 +170,16 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
                 auto prex = part->respondsToMIDIChannelExcludingGroupMask(channel);
                 auto kt =
                     part->configuration.transpose + part->getChannelBasedTransposition(channel);
+
+                // With a current lookup index the group pass below just records which
+                // groups may play and the zones come from the key/velocity bucket
+                auto *zl = part->isZoneLookupCurrent() ? part->zoneLookup.get() : nullptr;
+
                 for (const auto &[gidx, group] : sst::cpputils::enumerate(*part))
                 {
+                    if (zl)
+                        zl->groupPlays[gidx] = false;
+
                     if (hasFeature::hasGroupMIDIChannel)
                     {
                         if (!group->respondsToChannelOrUsesPartChannel(channel, prex))
@@ -217,9 +234,15 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
                         continue;
                     }
 
+                    if (zl)
+                    {
+                        zl->groupPlays[gidx] = true;
+                        continue;
+                    }
+
                     for (const auto &[zidx, zone] : sst::cpputils::enumerate(*group))
                     {
-                        if (zone->mapping.keyboardRange.includes(key + kt) &&
+                        if (idx < res.size() && zone->mapping.keyboardRange.includes(key + kt) &&
                             zone->mapping.velocityRange.includes(velocity))
                         {
                             res[idx] = {(size_t)pidx, (size_t)gidx,        (size_t)zidx,
@@ -228,6 +251,26 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
                         }
                     }
                 }
+
+                if (zl)
+                {
+                    // structured bindings can't be captured portably, so copy them out
+                    auto mkey = (int16_t)(key + kt);
+                    auto pi = (size_t)pidx;
+                    const auto &groups = part->getGroups();
+                    zl->forEachCandidate(mkey, velocity, [&](uint32_t gidx, uint32_t zidx) {
+                        if (!zl->groupPlays[gidx])
+                            return;
+                        const auto &zone = groups[gidx]->getZones()[zidx];
+                        if (idx < res.size() && zone->mapping.keyboardRange.includes(mkey) &&
+                            zone->mapping.velocityRange.includes(velocity))
+                        {
+                            res[idx] = {pi,      (size_t)gidx, (size_t)zidx,
+                                        channel, mkey,         noteId};
+                            idx++;
+                        }
+                    });
+                }
             }
         }
         return idx;
@@ -388,6 +431,17 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     static_assert(sst::voicemanager::constraints::ConstraintsChecker<
                   VMConfig, VoiceManagerResponder, MonoVoiceManagerResponder>::satisfies());
     voiceManager_t voiceManager{voiceManagerResponder, monoVoiceManagerResponder};
+    // Every key is added to the voice manager in the constructor. Declared ahead of the
+    // patch, as its groups hand their keys back when they are destroyed.
+    PolyphonyGroupKeys polyphonyGroupKeys;
+
+    using partVoiceLimits_t = std::array<int32_t, numParts>;
+    // Sets solo state for the parts of p, fills in their voice limits and returns the
+    // MIDI dialect they need. It doesn't touch the voice manager, so it can set up a
+    // patch which isn't live yet.
+    voiceManager_t::MIDI1Dialect applyPartConfiguration(Patch &p, partVoiceLimits_t &limits);
+    // Audio thread, or with audio stopped
+    void applyPartVoiceLimits(const partVoiceLimits_t &limits);
 
     void onSampleRateChanged() override;
 
@@ -426,7 +480,7 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     void prepareToPlay(double sampleRate)
     {
         setSampleRate(sampleRate);
-        sharedUIMemoryState.voiceDisplayStateWriteCounter = 0;
+        forceVoiceUpdate = true;
 
         const double updateFrequencyHz{30.0};
 
@@ -445,17 +499,20 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     }
 
     /**
-     * This is a mutex which we lock when modifying the structure in the engine.
      * The structure will only be modified in one of two situations
      * 1. On the audio thread (wav load for instance)
      * 2. On the serialization thread after the audio thread has been paused
      *    (which is how we do SFZ)
      *
-     * As a result this mutex needs to be locked when serialization reads the structure
-     * or when engine changes it but not when engine traverses it so note on and the
-     * like can avoid a mutex lock.
+     * Serialization holds a read section on this gate while it reads the structure
+     * and the engine only runs a structure changing callback when it can enter the
+     * gate without waiting. If it can't, the callback is parked in
+     * deferredStructureCallback and retried at the top of the next block, ahead of
+     * anything else queued, so the audio thread never blocks on serialization.
+     * Engine traversal (note on and the like) doesn't touch the gate at all.
+     * See structure_gate.h.
      */
-    std::mutex modifyStructureMutex;
+    StructureGate structureGate;
 
     /*
      * The serialization technique described in messaging.h works
@@ -482,18 +539,25 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     {
         std::array<std::array<std::atomic<float>, 2>, Patch::Busses::busCount> busVULevels;
 
-        std::atomic<int64_t> voiceDisplayStateWriteCounter{0};
-
+        /*
+         * The audio thread publishes the playing voices as one snapshot, packed at
+         * the front of items, and the UI acquires the latest whole snapshot when it
+         * polls. Only one UI thread may read.
+         */
         struct VoiceDisplayStateItem
         {
-            std::atomic<bool> active{false};
-            std::atomic<size_t> part, group, zone, sample;
-
-            std::atomic<int64_t> samplePos{}, midiNote{-1}, midiChannel{-1};
-            std::atomic<bool> gated{false};
+            int64_t samplePos{0};
+            int32_t part{0}, group{0}, zone{0}, sample{0};
+            int16_t midiNote{-1}, midiChannel{-1};
+            bool gated{false};
+        };
+        struct VoiceDisplayState
+        {
+            int32_t voiceCount{0};
+            int32_t itemCount{0};
+            std::array<VoiceDisplayStateItem, maxVoices> items;
         };
-        std::atomic<int32_t> voiceCount;
-        std::array<VoiceDisplayStateItem, maxVoices> voiceDisplayItems;
+        infrastructure::TripleBuffer<VoiceDisplayState> voiceDisplay;
 
         struct TransportDisplayState
         {
@@ -504,6 +568,7 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
 
         std::atomic<float> cpuLevel{0};
         std::atomic<float> ramUsage{0};
+        std::atomic<uint64_t> memoryPoolBytes{0};
     } sharedUIMemoryState;
 
     /* When we actually unstream an entire engine we want to know if we are doing
@@ -537,6 +602,23 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
             engine::Engine::fullEngineUnstreamStreamingVersion = pVer;
         }
     };
+    /*
+     * Serialization thread. For the life of the guard getSampleManager is the staging
+     * manager, so a patch built to the side of the live one restores its samples and
+     * attaches its zones there rather than disturbing the live manager.
+     */
+    struct SampleManagerStagingGuard
+    {
+        Engine &engine;
+        std::unique_ptr<sample::SampleManager> &staging;
+        SampleManagerStagingGuard(Engine &e, std::unique_ptr<sample::SampleManager> &s)
+            : engine(e), staging(s)
+        {
+            assert(engine.messageController->threadingChecker.isSerialThread());
+            std::swap(engine.sampleManager, staging);
+        }
+        ~SampleManagerStagingGuard() { std::swap(engine.sampleManager, staging); }
+    };
     struct StreamGuard
     {
         StreamReason pIs{IN_PROCESS};
@@ -612,7 +694,7 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     /*
      * Send everything we need upon a reset or register
      */
-    void sendFullRefreshToClient() const;
+    void sendFullRefreshToClient();
 
     /*
      * Update the audio playing state
@@ -621,6 +703,48 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
 
     void clearAll(bool purgeSamples = true);
 
+    /*
+     * Loading a multi can build a complete new Patch (samples attached, effects and
+     * processors set up) on the serialization thread while the current patch keeps
+     * playing, then hand it to the audio thread to swap in at a block boundary. See
+     * json::unstreamEngineStateInBackground.
+     *
+     * Voices belong to the zones of the patch they started in, so they can't carry
+     * over the swap. The policy says how they leave.
+     */
+    enum struct PatchSwapPolicy : uint8_t
+    {
+        CUT,  // swap at the next block the structure gate allows; old voices stop dead
+        FADE, // fade the output out over patchSwapFadeBlocks, swap, then fade back in
+    };
+    static constexpr int32_t patchSwapFadeBlocks{32};
+
+    struct PatchSwap
+    {
+        std::unique_ptr<Patch> patch;
+        RuntimeConfig runtimeConfig;
+        PatchSwapPolicy policy{PatchSwapPolicy::FADE};
+
+        // Worked out on the serialization thread before the swap is published, so the
+        // audio thread only has to store them
+        voiceManager_t::MIDI1Dialect dialect{voiceManager_t::MIDI1Dialect::MIDI1};
+        partVoiceLimits_t partVoiceLimits{};
+
+        // Samples the new patch was restored against, adopted by the live sample
+        // manager when the swap completes. Dropped untouched if it never does.
+        std::unique_ptr<sample::SampleManager> stagedSamples;
+
+        // Called on the serialization thread once the new patch is live
+        std::function<void(Engine &)> onSwapped{nullptr};
+    };
+
+    // Serialization thread. A swap requested while one is in flight waits for it to
+    // land and then replaces any other waiting swap.
+    void swapPatchInBackground(std::unique_ptr<PatchSwap> swap);
+    // Serialization thread, when the audio thread reports the swap has happened
+    void completePatchSwap(PatchSwap *swap);
+    bool isPatchSwapPending() const { return pendingPatchSwap != nullptr; }
+
     struct EngineStatusMessage
     {
         bool isAudioRunning;
@@ -646,10 +770,48 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
      * Get the Part/Group/Zone structure as a set o fzone addreses. A part with
      * no groups will be (p,-1,-1); a group with no zones will be (p,g,-1).
      *
+     * @param stableKeys if set, filled in parallel with a key per entry which
+     * survives reordering (the part index, group id or zone id)
      * @return The vector of zones in the running engine
      * independent of selection.
      */
-    pgzStructure_t getPartGroupZoneStructure() const;
+    pgzStructure_t getPartGroupZoneStructure(std::vector<int64_t> *stableKeys = nullptr) const;
+
+    /*
+     * The client keeps a copy of the structure, so after the first full send we
+     * usually ship only what changed. Every send bumps a version, and a delta names
+     * the version it applies to so a client which missed one asks for a full resend.
+     *
+     * Ops apply in order to the flat bundle list: REMOVE drops count entries at
+     * index, INSERT places the entries at index and UPDATE overwrites the entries
+     * from index on (a rename or a feature change). Applying a delta renumbers the
+     * addresses, since removing a zone shifts every zone after it.
+     */
+    enum PGZDeltaOp : int32_t
+    {
+        PGZ_REMOVE,
+        PGZ_INSERT,
+        PGZ_UPDATE
+    };
+    typedef std::tuple<int32_t, int32_t, int32_t, pgzStructure_t> pgzDeltaOp_t; // op, idx, count
+    typedef std::pair<uint64_t, pgzStructure_t> pgzVersionedStructure_t;
+    typedef std::tuple<uint64_t, uint64_t, std::vector<pgzDeltaOp_t>> pgzStructureDelta_t; // from, to
+
+    /**
+     * Send the structure to the client, as a delta against the last send if that
+     * is small enough. Serialization thread only.
+     */
+    void sendPartGroupZoneStructureToClient(bool forceFull = false);
+    static std::vector<pgzDeltaOp_t> diffPartGroupZoneStructure(const pgzStructure_t &from,
+                                                                const std::vector<int64_t> &fromKeys,
+                                                                const pgzStructure_t &to,
+                                                                const std::vector<int64_t> &toKeys);
+    static void applyPartGroupZoneStructureDelta(pgzStructure_t &onto,
+                                                 const std::vector<pgzDeltaOp_t> &ops);
+    // The steps of the above, for a client which follows each op: apply them in turn,
+    // then renumber once at the end
+    static void applyPartGroupZoneStructureOp(pgzStructure_t &onto, const pgzDeltaOp_t &op);
+    static void renumberPartGroupZoneStructure(pgzStructure_t &onto);
 
     const std::unique_ptr<MemoryPool> &getMemoryPool()
     {
@@ -657,6 +819,36 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
         return memoryPool;
     }
 
+    // Null unless the user has configured voice render worker threads
+    VoiceRenderPool *getVoiceRenderPool() { return voiceRenderPool.get(); }
+    // Replace the pool with one of this many workers, or none. Only with audio stopped.
+    void setVoiceRenderWorkerCount(int workers);
+
+    // Null unless the user has asked for bus effects to run on their own worker
+    BusEffectWorker *getBusEffectWorker() { return busEffectWorker.get(); }
+    // Start or stop the bus effect worker. Only with audio stopped.
+    void setPipelinedBusEffects(bool pipelined);
+    // What the engine adds on top of the host, for the plugin to report as its latency
+    uint32_t getLatencySamples() const
+    {
+        return busEffectWorker ? BusEffectWorker::latencyInSamples : 0;
+    }
+
+    /*
+     * Run zone Cytomic SVF filters four voices at a time in SIMD lanes (see
+     * Zone::processVoicesInLockstep) rather than in each voice's processor. Only with audio
+     * stopped, since a held voice's filter state doesn't move between the two.
+     */
+    void setQuadVoiceFilters(bool q) { quadVoiceFilters = q; }
+    bool getQuadVoiceFilters() const { return quadVoiceFilters; }
+
+    /*
+     * A plugin wrapper whose host offers a thread pool sets this to run n tasks,
+     * each of which calls Patch::processConcurrentPartTask, returning false if the
+     * host could not. Called on the audio thread only. Null means parts run serially.
+     */
+    std::function<bool(uint32_t)> requestConcurrentPartTasks{nullptr};
+
     std::atomic<int32_t> stopEngineRequests{0};
 
     /*
@@ -729,6 +921,9 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
   private:
     std::unique_ptr<Patch> patch;
     std::unique_ptr<MemoryPool> memoryPool;
+    std::unique_ptr<VoiceRenderPool> voiceRenderPool;
+    std::unique_ptr<BusEffectWorker> busEffectWorker;
+    bool quadVoiceFilters{false};
     std::unique_ptr<sample::SampleManager> sampleManager;
     std::unique_ptr<browser::BrowserDB> browserDb;
     std::unique_ptr<browser::Browser> browser;
@@ -738,6 +933,21 @@ struct Engine : MoveableOnly<Engine>, SampleRateSupport
     std::unique_ptr<messaging::MessageController> messageController;
     std::unique_ptr<selection::SelectionManager> selectionManager;
 
+    // A structure callback which couldn't enter structureGate last block. Audio thread only.
+    void *deferredStructureCallback{nullptr};
+    bool runStructureCallback(void *cb);
+
+    // Owned by the serialization thread until completePatchSwap
+    std::unique_ptr<PatchSwap> pendingPatchSwap, queuedPatchSwap;
+    void startPatchSwap();
+    // Audio thread only
+    PatchSwap *incomingPatchSwap{nullptr};
+    int32_t patchSwapFadeOut{0}, patchSwapFadeIn{0};
+    void processPatchSwap();
+    void applyPatchSwapFade();
+    // Sets up the voice manager for every group of the live patch
+    void resetGroupPlaymodes();
+
     static constexpr size_t cpuAverageObservation{64};
     size_t cpuWP{0};
     float cpuAvg{0.f};
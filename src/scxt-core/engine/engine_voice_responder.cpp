@@ -53,14 +53,16 @@ int32_t Engine::VoiceManagerResponder::beginVoiceCreationTransaction(
             z->parentGroup->outputInfo.playMode != Group::PlayMode::POLY)
         {
             SCLOG_IF(voiceResponder,
-                     "-- Setting polyphony group to group basd " << (uint64_t)z->parentGroup);
-            buffer[idx].polyphonyGroup = (uint64_t)z->parentGroup;
+                     "-- Setting polyphony group to group basd "
+                         << z->parentGroup->getPolyphonyGroup());
+            buffer[idx].polyphonyGroup = z->parentGroup->getPolyphonyGroup();
         }
         else if (z->parentGroup->parentPart->configuration.polyLimitVoices)
         {
             SCLOG_IF(voiceResponder,
                      "-- Setting polyphony group to part based " << z->parentGroup->parentPart)
-            buffer[idx].polyphonyGroup = (uint64_t)z->parentGroup->parentPart;
+            buffer[idx].polyphonyGroup =
+                PolyphonyGroupKeys::forPart(z->parentGroup->parentPart->partNumber);
         }
         else
         {
@@ -46,8 +46,9 @@ namespace scxt::engine
 {
 
 Group::Group(sst::basic_blocks::dsp::RNG &engineRNG)
-    : id(GroupID::next()), name(id.to_string()), endpoints{nullptr},
-      modulation::shared::HasModulators<Group, egsPerGroup>(this, engineRNG), osDownFilter(6, true)
+    : modulation::shared::OwnedRNG(engineRNG.unifU32()), id(GroupID::next()),
+      name(id.to_string()), endpoints{nullptr},
+      modulation::shared::HasModulators<Group, egsPerGroup>(this, ownedRNG), osDownFilter(6, true)
 {
 }
 
@@ -274,6 +275,22 @@ template <bool OS> void Group::processWithOS(scxt::engine::Engine &e)
 
     modMatrix.process();
 
+    /*
+     * With a render pool, render every voice in this group in parallel now and
+     * let the zone loop below only mix, so the sums happen in the serial order.
+     */
+    auto *renderPool = e.getVoiceRenderPool();
+    if (renderPool && !parentPart->processingConcurrently &&
+        renderPool->shouldRenderInParallel((size_t)fVoiceCount))
+    {
+        renderPool->beginJobs();
+        for (int i = 0; i < activeZones; ++i)
+        {
+            activeZoneWeakRefs[i]->addVoicesToRenderPool(*renderPool);
+        }
+        renderPool->runJobs();
+    }
+
     auto oAZ = activeZones;
     rescanWeakRefs = 0;
     for (int i = 0; i < activeZones; ++i)
@@ -499,6 +516,24 @@ bool Group::updateSilenceMax()
     return res;
 }
 
+bool Group::canProcessConcurrently()
+{
+    // An oversample change turns sounds off through the shared voice manager
+    if (lastOversample != outputInfo.oversample)
+        return false;
+
+    // Groups routed elsewhere accumulate straight onto a shared bus
+    if (outputInfo.routeTo != DEFAULT_BUS && outputInfo.routeTo != parentPart->configuration.routeTo)
+        return false;
+
+    for (int i = 0; i < activeZones; ++i)
+    {
+        if (!activeZoneWeakRefs[i]->canProcessConcurrently())
+            return false;
+    }
+    return true;
+}
+
 void Group::addActiveZone(engine::Zone *zwp)
 {
     // Add active zone to end
@@ -573,7 +608,7 @@ void Group::setupOnUnstream(engine::Engine &e)
         stepLfos[i].setSampleRate(sampleRate, sampleRateInv);
 
         stepLfos[i].assign(&modulatorStorage[i], endpoints.lfo[i].rateP, &(getEngine()->transport),
-                           getEngine()->rng);
+                           ownedRNG);
         curveLfos[i].assign(&modulatorStorage[i], &(getEngine()->transport));
     }
 
@@ -595,7 +630,9 @@ void Group::setupOnUnstream(engine::Engine &e)
     }
 
     triggerConditions.setupOnUnstream(parentPart->groupTriggerInstrumentState);
-    resetPolyAndPlaymode(e);
+    // A patch restored in the background reaches the voice manager when it is swapped in
+    if (parentPart->parentPatch == e.getPatch().get())
+        resetPolyAndPlaymode(e);
 }
 
 void Group::onGroupMidiChannelSubscriptionChanged()
@@ -835,7 +872,7 @@ void Group::resetLFOs(int whichLFO)
             stepLfos[i].setSampleRate(sampleRate, sampleRateInv);
 
             stepLfos[i].assign(&modulatorStorage[i], endpoints.lfo[i].rateP,
-                               &(getEngine()->transport), getEngine()->rng);
+                               &(getEngine()->transport), ownedRNG);
             curveLfos[i].assign(&modulatorStorage[i], &(getEngine()->transport));
         }
         else if (lfoEvaluator[i] == CURVE)
@@ -855,7 +892,7 @@ void Group::resetLFOs(int whichLFO)
     }
 
     randomEvaluator.evaluate(miscSourceStorage);
-    phasorEvaluator.attack(getEngine()->transport, miscSourceStorage, getEngine()->rng);
+    phasorEvaluator.attack(getEngine()->transport, miscSourceStorage, ownedRNG);
 }
 
 bool Group::isActive() const
@@ -870,9 +907,21 @@ bool Group::isActive() const
 
 void Group::onRoutingChanged() { rePrepareAndBindGroupMatrix(); }
 
+void Group::onZoneStructureChanged()
+{
+    if (parentPart)
+        parentPart->markZoneLookupDirty();
+}
+
 void Group::resetPolyAndPlaymode(engine::Engine &e)
 {
-    auto pgrp = (uint64_t)this;
+    if (!polyphonyGroup)
+    {
+        polyphonyGroup = e.polyphonyGroupKeys.acquireGroupKey();
+        if (polyphonyGroup)
+            polyphonyGroupKeys = &e.polyphonyGroupKeys;
+    }
+    auto pgrp = getPolyphonyGroup();
     e.voiceManager.guaranteeGroup(pgrp);
 
     if (outputInfo.playMode == Group::PlayMode::POLY)
@@ -46,6 +46,8 @@
 #include "modulation/group_matrix.h"
 #include "modulation/has_modulators.h"
 #include "group_triggers.h"
+#include "structure_arena.h"
+#include "polyphony_group_keys.h"
 
 namespace scxt::engine
 {
@@ -56,10 +58,15 @@ constexpr int lfosPerGroup{scxt::lfosPerGroup};
 
 struct Group : MoveableOnly<Group>,
                HasGroupZoneProcessors<Group>,
+               modulation::shared::OwnedRNG,
                modulation::shared::HasModulators<Group, egsPerGroup>,
-               SampleRateSupport
+               SampleRateSupport,
+               StructureArenaAllocated
 {
     explicit Group(sst::basic_blocks::dsp::RNG &engineRNG);
+
+    // See Part::canProcessConcurrently
+    bool canProcessConcurrently();
     virtual ~Group()
     {
         for (auto *p : processors)
@@ -69,6 +76,10 @@ struct Group : MoveableOnly<Group>,
                 dsp::processor::unspawnProcessor(p);
             }
         }
+        if (polyphonyGroupKeys)
+        {
+            polyphonyGroupKeys->releaseGroupKey(polyphonyGroup);
+        }
     }
     GroupID id;
 
@@ -148,6 +159,7 @@ struct Group : MoveableOnly<Group>,
         z->engine = getEngine();
         zones.push_back(std::move(z));
         activeZoneWeakRefs.push_back(nullptr);
+        onZoneStructureChanged();
         return zones.size();
     }
 
@@ -157,6 +169,7 @@ struct Group : MoveableOnly<Group>,
         z->engine = getEngine();
         zones.push_back(std::move(z));
         activeZoneWeakRefs.push_back(nullptr);
+        onZoneStructureChanged();
         return zones.size();
     }
 
@@ -164,6 +177,7 @@ struct Group : MoveableOnly<Group>,
     {
         zones.clear();
         activeZoneWeakRefs.clear();
+        onZoneStructureChanged();
     }
 
     int getZoneIndex(const ZoneID &zid) const
@@ -200,14 +214,19 @@ struct Group : MoveableOnly<Group>,
         res->parentGroup = nullptr;
 
         postZoneTraversalRemoveHandler();
+        onZoneStructureChanged();
         return res;
     }
 
     void swapZonesByIndex(size_t zoneIndex0, size_t zoneIndex1)
     {
         std::swap(zones[zoneIndex0], zones[zoneIndex1]);
+        onZoneStructureChanged();
     }
 
+    // Adding, removing, reordering or remapping zones invalidates the part zone lookup
+    void onZoneStructureChanged();
+
     bool isActive() const;
     void addActiveZone(engine::Zone *zoneWP);
     void removeActiveZone(engine::Zone *zoneWP);
@@ -215,6 +234,8 @@ struct Group : MoveableOnly<Group>,
     void onSampleRateChanged() override;
 
     void resetPolyAndPlaymode(engine::Engine &);
+    // The voice manager key for this group. See PolyphonyGroupKeys.
+    uint64_t getPolyphonyGroup() const { return polyphonyGroup ? polyphonyGroup : (uint64_t)this; }
 
     /*
      * Only call this if you have *already* checked the part containing
@@ -382,6 +403,9 @@ struct Group : MoveableOnly<Group>,
     std::vector<Zone *> activeZoneWeakRefs;
     uint32_t rescanWeakRefs{0};
 
+    uint64_t polyphonyGroup{0};
+    PolyphonyGroupKeys *polyphonyGroupKeys{nullptr};
+
     void postZoneTraversalRemoveHandler();
 };
 } // namespace scxt::engine
@@ -26,133 +26,326 @@
  */
 
 #include "memory_pool.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include "configuration.h"
 
 namespace scxt::engine
 {
-/*
- * A massive TODO here. Right now this allocates on the audio thread but we
- * can instead have this have a message contrller refecence at construction time
- * and instead try to ask the audio thread to allocate.
- */
+static constexpr uint32_t initialPoolSize{16};
+// How often the replenisher looks for classes below their watermark
+static constexpr auto replenishInterval{std::chrono::milliseconds(2)};
+
+bool MemoryPool::SizeClass::pop(uint32_t &slot)
+{
+    auto head = freeHead.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto idx = (uint32_t)(head & 0xFFFFFFFF);
+        if (idx == emptyList)
+            return false;
+
+        // This may be stale if someone else pops first, but then the count moved on
+        // and the exchange fails
+        auto nxt = next[idx].load(std::memory_order_relaxed);
+        auto nh = (((head >> 32) + 1) << 32) | nxt;
+        if (freeHead.compare_exchange_weak(head, nh, std::memory_order_acq_rel,
+                                           std::memory_order_acquire))
+        {
+            freeCount.fetch_sub(1, std::memory_order_relaxed);
+            slot = idx;
+            return true;
+        }
+    }
+}
+
+void MemoryPool::SizeClass::push(uint32_t slot)
+{
+    auto head = freeHead.load(std::memory_order_relaxed);
+    while (true)
+    {
+        next[slot].store((uint32_t)(head & 0xFFFFFFFF), std::memory_order_relaxed);
+        auto nh = (((head >> 32) + 1) << 32) | slot;
+        if (freeHead.compare_exchange_weak(head, nh, std::memory_order_release,
+                                           std::memory_order_relaxed))
+        {
+            freeCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+MemoryPool::MemoryPool() : classes(std::make_unique<std::array<SizeClass, maxSizeClasses>>())
+{
+    replenisher = std::thread([this]() { replenishLoop(); });
+}
 
 MemoryPool::~MemoryPool()
 {
-    SCLOG_IF(memoryPool, "Destroying memory pool " << SCD(debugCheckouts) << SCD(debugReturns));
+    keepRunning.store(false, std::memory_order_release);
+    replenisher.join();
+
+    SCLOG_IF(memoryPool, "Destroying memory pool " << SCD(debugCheckouts.load())
+                                                   << SCD(debugReturns.load()));
     assert(debugCheckouts == debugReturns);
 
-    for (auto &[sz, s] : cache)
+    for (auto &c : *classes)
     {
-        SCLOG_IF(memoryPool, "Cleaning up pool of size " << sz);
-        while (!s.data.empty())
+        auto sz = c.associatedSize.load();
+        if (sz == 0)
+            continue;
+
+        auto n = std::min(c.allocatedCount.load(), maxBlocksPerClass);
+        SCLOG_IF(memoryPool, "Cleaning up pool of size " << sz << " with " << n << " blocks");
+        for (uint32_t i = 0; i < n; ++i)
         {
-            delete[] s.data.front();
-            s.data.pop();
+            delete[] c.blocks[i];
         }
+        delete[] c.reserve.load();
     }
 }
 
-static constexpr size_t initialPoolSize{16};
-MemoryPool::data_t *MemoryPool::checkoutBlock(size_t requestBlockSize)
+MemoryPool::SizeClass *MemoryPool::findClass(size_t blockSize) const
 {
-    // Technically don't need this in the naive impl but lets avoid some bugs
-    auto blockSize = nearestBlock(requestBlockSize);
-    auto cacheP = cache.find(blockSize);
-    SCLOG_IF(memoryPool,
-             "Checkout Block " << blockSize << " from pool of size " << cacheP->second.data.size());
-    assert(cacheP != cache.end()); // If you hit this you didn't pre-reserve
-    if (cacheP == cache.end())
+    for (auto &c : *classes)
     {
-        return nullptr;
+        auto sz = c.associatedSize.load(std::memory_order_acquire);
+        if (sz == blockSize)
+            return &c;
+        if (sz == 0)
+            return nullptr;
     }
-    assert(cacheP->second.associatedSize == blockSize);
-    if (cacheP->second.data.empty())
+    return nullptr;
+}
+
+MemoryPool::SizeClass *MemoryPool::findOrClaimClass(size_t blockSize, uint32_t lowWatermark,
+                                                    int owner)
+{
+    // Classes are claimed in order, so two threads registering the same size race for
+    // the same entry and the loser finds the winner's class there
+    SizeClass *res{nullptr};
+    for (auto &c : *classes)
     {
-        growBlock(requestBlockSize, false);
-        return checkoutBlock(requestBlockSize);
+        size_t expected{0};
+        if (c.associatedSize.compare_exchange_strong(expected, blockSize,
+                                                     std::memory_order_acq_rel))
+        {
+            c.lowWatermark.store(lowWatermark, std::memory_order_relaxed);
+            c.reserve.store(new data_t[blockSize], std::memory_order_release);
+            reservedBytes.fetch_add(blockSize, std::memory_order_relaxed);
+            res = &c;
+            break;
+        }
+        if (expected == blockSize)
+        {
+            waitForReserve(c);
+            res = &c;
+            break;
+        }
+    }
+    assert(res); // If you hit this raise maxSizeClasses
+    if (res && owner >= 0 && owner < maxOwners)
+    {
+        res->ownerBits.fetch_or(1ULL << owner, std::memory_order_relaxed);
     }
-
-    debugCheckouts++;
-    auto res = cacheP->second.data.front();
-    cacheP->second.data.pop();
-
-    SCLOG_IF(memoryPool, blockSize << " : Post checkout size is " << cacheP->second.data.size());
     return res;
 }
-void MemoryPool::returnBlock(data_t *block, size_t requestBlockSize)
+
+void MemoryPool::waitForReserve(const SizeClass &c)
 {
-    debugReturns++;
-    auto blockSize = nearestBlock(requestBlockSize);
-    auto cacheP = cache.find(blockSize);
-    assert(cacheP != cache.end()); // If you hit this you didn't pre-reserve
+    while (!c.reserve.load(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
 
-    cacheP->second.data.push(block);
-    SCLOG_IF(memoryPool, "Return Block " << blockSize << " now have " << cacheP->second.data.size()
-                                         << " entries");
+void MemoryPool::noteCheckout(SizeClass &c)
+{
+    auto o = (uint32_t)(c.outstanding.fetch_add(1, std::memory_order_relaxed) + 1);
+    auto hw = c.highWatermark.load(std::memory_order_relaxed);
+    while (o > hw && !c.highWatermark.compare_exchange_weak(hw, o, std::memory_order_relaxed))
+    {
+    }
 }
 
-void MemoryPool::growBlock(size_t requestBlockSize, bool initialize)
+bool MemoryPool::growClass(SizeClass &c)
 {
-    auto blockSize = nearestBlock(requestBlockSize);
-    SCLOG_IF(memoryPool, "Growing block size " << blockSize << " init=" << initialize);
-    auto cacheP = cache.find(blockSize);
-    assert(cacheP != cache.end()); // If you hit this you didn't pre-reserve
+    auto slot = c.allocatedCount.fetch_add(1, std::memory_order_acq_rel);
+    if (slot >= maxBlocksPerClass)
+    {
+        c.allocatedCount.store(maxBlocksPerClass, std::memory_order_relaxed);
+        return false;
+    }
 
-    auto gb = initialize ? cacheP->second.initialPoolSize : cacheP->second.growSize;
+    auto sz = c.associatedSize.load(std::memory_order_relaxed);
+    auto raw = new data_t[sz + headerSize];
+    reservedBytes.fetch_add(sz, std::memory_order_relaxed);
+    *reinterpret_cast<uint32_t *>(raw) = slot;
+    c.blocks[slot] = raw;
+    c.push(slot);
+    return true;
+}
 
-    SCLOG_IF(memoryPool, "Adding entries from " << cacheP->second.data.size() << " to " << gb);
+void MemoryPool::fillTo(SizeClass &c, uint32_t count)
+{
+    while (c.freeCount.load(std::memory_order_relaxed) < count)
+    {
+        if (!growClass(c))
+            break;
+    }
+}
 
-    for (auto i = cacheP->second.data.size(); i < gb; ++i)
+void MemoryPool::replenishLoop()
+{
+    while (keepRunning.load(std::memory_order_acquire))
     {
-        cacheP->second.data.push(new data_t[blockSize]);
+        for (auto &c : *classes)
+        {
+            if (c.associatedSize.load(std::memory_order_acquire) == 0)
+                break;
+
+            auto lw = c.lowWatermark.load(std::memory_order_relaxed);
+            if (c.freeCount.load(std::memory_order_relaxed) < lw)
+            {
+                SCLOG_IF(memoryPool, "Replenishing " << c.associatedSize.load() << " from "
+                                                     << c.freeCount.load() << " to " << lw);
+                fillTo(c, lw);
+            }
+        }
+        std::this_thread::sleep_for(replenishInterval);
     }
 }
 
-void MemoryPool::preReservePool(size_t requestBlockSize)
+MemoryPool::data_t *MemoryPool::checkoutBlock(size_t requestBlockSize)
 {
     auto blockSize = nearestBlock(requestBlockSize);
-    SCLOG_IF(memoryPool, "preReserve Pool " << blockSize);
-    auto cacheP = cache.find(blockSize);
-    if (cacheP == cache.end())
+    auto *c = findClass(blockSize);
+    assert(c); // If you hit this you didn't pre-reserve
+    if (!c)
     {
-        auto cacheSet = pool_t();
-        cacheSet.associatedSize = blockSize;
-        cacheSet.initialPoolSize = initialPoolSize;
-        cacheSet.growSize = initialPoolSize >> 1;
+        return nullptr;
+    }
+
+    uint32_t slot;
+    if (!c->pop(slot))
+    {
+        // The replenisher fell behind. Allocating here would be on the audio thread, so
+        // hand back null for the caller to fall back on the reserve, and make sure the
+        // replenisher keeps more of this size around from now on.
+        fallbackAllocations.fetch_add(1, std::memory_order_relaxed);
+        c->fallbackGrows.fetch_add(1, std::memory_order_relaxed);
+        auto lw = c->lowWatermark.load(std::memory_order_relaxed);
+        c->lowWatermark.store(std::min(std::max(lw, 1U) * 2, maxBlocksPerClass),
+                              std::memory_order_relaxed);
+        SCLOG_IF(memoryPool, "Checkout of " << blockSize << " found class empty");
+        return nullptr;
+    }
+
+    noteCheckout(*c);
+    debugCheckouts++;
+    SCLOG_IF(memoryPool, blockSize << " : Post checkout size is " << c->freeCount.load());
+    return c->blocks[slot] + headerSize;
+}
+
+MemoryPool::data_t *MemoryPool::reserveBlock(size_t requestBlockSize) const
+{
+    auto *c = findClass(nearestBlock(requestBlockSize));
+    assert(c); // If you hit this you didn't pre-reserve
+    return c ? c->reserve.load(std::memory_order_acquire) : nullptr;
+}
+
+void MemoryPool::returnBlock(data_t *block, size_t requestBlockSize)
+{
+    auto blockSize = nearestBlock(requestBlockSize);
+    auto *c = findClass(blockSize);
+    assert(c); // If you hit this you didn't pre-reserve
+    if (c && block == c->reserve.load(std::memory_order_acquire))
+        return;
 
-        cache.insert({blockSize, std::move(cacheSet)});
-        growBlock(requestBlockSize, true);
+    debugReturns++;
+    if (c)
+    {
+        c->outstanding.fetch_sub(1, std::memory_order_relaxed);
     }
+
+    auto raw = block - headerSize;
+    auto slot = *reinterpret_cast<uint32_t *>(raw);
+    assert(c && slot < maxBlocksPerClass && c->blocks[slot] == raw);
+
+    c->push(slot);
     SCLOG_IF(memoryPool,
-             "preReserve complete " << blockSize << " " << cache[blockSize].data.size());
+             "Return Block " << blockSize << " now have " << c->freeCount.load() << " entries");
 }
 
-void MemoryPool::preReserveSingleInstancePool(size_t requestBlockSize)
+void MemoryPool::preReservePool(size_t requestBlockSize, int owner)
 {
     auto blockSize = nearestBlock(requestBlockSize);
-    SCLOG_IF(memoryPool, "preReserve Single Instance Pool " << blockSize);
+    SCLOG_IF(memoryPool, "preReserve Pool " << blockSize);
 
-    auto cacheP = cache.find(blockSize);
-    if (cacheP == cache.end())
+    auto *c = findClass(blockSize);
+    if (!c)
+    {
+        c = findOrClaimClass(blockSize, initialPoolSize >> 1, owner);
+        if (!c)
+            return;
+        fillTo(*c, initialPoolSize);
+    }
+    else
     {
-        auto cacheSet = pool_t();
+        waitForReserve(*c);
+        if (owner >= 0 && owner < maxOwners)
+            c->ownerBits.fetch_or(1ULL << owner, std::memory_order_relaxed);
+    }
+    SCLOG_IF(memoryPool, "preReserve complete " << blockSize << " " << c->freeCount.load());
+}
 
-        cacheSet.associatedSize = blockSize;
-        cacheSet.initialPoolSize = 1;
-        cacheSet.growSize = 1;
+void MemoryPool::preReserveSingleInstancePool(size_t requestBlockSize, int owner)
+{
+    auto blockSize = nearestBlock(requestBlockSize);
+    SCLOG_IF(memoryPool, "preReserve Single Instance Pool " << blockSize);
 
-        cache.insert({blockSize, std::move(cacheSet)});
-        growBlock(requestBlockSize, true);
+    auto *c = findClass(blockSize);
+    if (!c)
+    {
+        // The one block is made here; the replenisher has nothing to keep topped up
+        c = findOrClaimClass(blockSize, 0, owner);
+        if (!c)
+            return;
     }
-    // For single pool make sure its there if i pre-reserve it.
-    const auto &pool = cache[blockSize];
-    if (pool.data.size() < pool.initialPoolSize)
+    else
     {
-        growBlock(requestBlockSize, true);
+        waitForReserve(*c);
+        if (owner >= 0 && owner < maxOwners)
+            c->ownerBits.fetch_or(1ULL << owner, std::memory_order_relaxed);
     }
+    // For single pool make sure its there if i pre-reserve it.
+    fillTo(*c, 1);
     SCLOG_IF(memoryPool,
-             "preReserve Single complete " << blockSize << " " << cache[blockSize].data.size());
+             "preReserve Single complete " << blockSize << " " << c->freeCount.load());
 }
 
-} // namespace scxt::engine
\ No newline at end of file
+std::vector<MemoryPool::SizeClassStats> MemoryPool::getStats() const
+{
+    std::vector<SizeClassStats> res;
+    for (const auto &c : *classes)
+    {
+        auto sz = c.associatedSize.load(std::memory_order_acquire);
+        if (sz == 0)
+            break;
+
+        SizeClassStats st;
+        st.blockSize = sz;
+        st.reservedBlocks = std::min(c.allocatedCount.load(std::memory_order_relaxed),
+                                     maxBlocksPerClass);
+        st.freeBlocks = c.freeCount.load(std::memory_order_relaxed);
+        st.outstanding = c.outstanding.load(std::memory_order_relaxed);
+        st.highWatermark = c.highWatermark.load(std::memory_order_relaxed);
+        st.fallbackGrows = c.fallbackGrows.load(std::memory_order_relaxed);
+        st.reservedBytes = (uint64_t)st.reservedBlocks * sz;
+        st.ownerBits = c.ownerBits.load(std::memory_order_relaxed);
+        res.push_back(st);
+    }
+    return res;
+}
+} // namespace scxt::engine
@@ -28,45 +28,132 @@
 #ifndef SCXT_SRC_SCXT_CORE_ENGINE_MEMORY_POOL_H
 #define SCXT_SRC_SCXT_CORE_ENGINE_MEMORY_POOL_H
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <cctype>
-#include <unordered_map>
-#include <unordered_set>
-#include <queue>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "utils.h"
 
 namespace scxt::engine
 {
+/*
+ * The MemoryPool hands processors their delay lines and other large buffers, which
+ * they check out from the audio thread at voice start. Each distinct (rounded) size
+ * is a size class holding a fixed table of blocks and a lock-free free list over
+ * that table, so checkout and return are a compare and swap with no locks and no
+ * allocation.
+ *
+ * A replenisher thread keeps every class above its low watermark. The audio thread
+ * never allocates: if a class runs dry before the replenisher gets to it the checkout
+ * returns null, and the class watermark doubles so the next burst of that size is
+ * covered. See getFallbackAllocations. Every class also holds one reserve block,
+ * made when the class is, which is never on the free list. A caller which gets null
+ * can use it to stay memory safe, but it is shared, so only to set up in and never
+ * to run on. Processors do this and then stay bypassed; see SCXTVFXConfig.
+ */
 struct MemoryPool : MoveableOnly<MemoryPool>
 {
     typedef uint8_t data_t;
 
+    MemoryPool();
     ~MemoryPool();
 
-    void preReservePool(size_t blockSize);
-    void preReserveSingleInstancePool(size_t blockSize);
+    /*
+     * The owner is a small integer (processors use their ProcessorType) recorded
+     * against the size class so the statistics can say who reserved it.
+     */
+    void preReservePool(size_t blockSize, int owner = -1);
+    void preReserveSingleInstancePool(size_t blockSize, int owner = -1);
 
     data_t *checkoutBlock(size_t blockSize);
+    // The shared reserve block of a pre-reserved size. Returning it is a no-op.
+    data_t *reserveBlock(size_t blockSize) const;
     void returnBlock(data_t *block, size_t blockSize);
 
+    // How many times a checkout found its class empty and returned null
+    uint64_t getFallbackAllocations() const
+    {
+        return fallbackAllocations.load(std::memory_order_relaxed);
+    }
+
+    // Total bytes held by the pool, checked out or free
+    uint64_t getReservedBytes() const { return reservedBytes.load(std::memory_order_relaxed); }
+
+    struct SizeClassStats
+    {
+        size_t blockSize{0};
+        uint32_t reservedBlocks{0}, freeBlocks{0};
+        int32_t outstanding{0};
+        uint32_t highWatermark{0};
+        uint64_t fallbackGrows{0};
+        uint64_t reservedBytes{0};
+        uint64_t ownerBits{0}; // bit n set if owner n reserved this class
+    };
+    // Allocates, so call from the serialization thread
+    std::vector<SizeClassStats> getStats() const;
+
+    static constexpr size_t maxSizeClasses{64};
+    static constexpr uint32_t maxBlocksPerClass{1024};
+    static constexpr int maxOwners{64};
+
   private:
     template <size_t N = 10> static inline size_t nearestBlock(size_t x)
     {
         return ((x >> N) + 1) * (1 << N);
     }
-    void growBlock(size_t blockSize, bool initialize);
-    struct SinglePool : MoveableOnly<SinglePool>
+
+    /*
+     * Every block carries its slot in the class table just ahead of the memory
+     * handed out, so a return finds its way back onto the free list.
+     */
+    static constexpr size_t headerSize{alignof(std::max_align_t)};
+    static constexpr uint32_t emptyList{0xFFFFFFFF};
+
+    struct SizeClass
     {
-        size_t associatedSize;
-        size_t initialPoolSize, growSize;
-        std::queue<data_t *> data;
+        std::atomic<size_t> associatedSize{0}; // 0 is an unclaimed class
+        std::atomic<uint32_t> lowWatermark{0};
+        std::atomic<data_t *> reserve{nullptr};
+
+        std::array<data_t *, maxBlocksPerClass> blocks{};
+        std::array<std::atomic<uint32_t>, maxBlocksPerClass> next{};
+        std::atomic<uint32_t> allocatedCount{0};
+        std::atomic<uint32_t> freeCount{0};
+
+        std::atomic<int32_t> outstanding{0};
+        std::atomic<uint32_t> highWatermark{0};
+        std::atomic<uint64_t> fallbackGrows{0};
+        std::atomic<uint64_t> ownerBits{0};
+
+        // The free list head packs a change count above the slot to defeat ABA
+        std::atomic<uint64_t> freeHead{emptyList};
+
+        bool pop(uint32_t &slot);
+        void push(uint32_t slot);
     };
-    using pool_t = SinglePool;
-    using cache_t = std::unordered_map<size_t, pool_t>;
-    cache_t cache;
 
-    int64_t debugCheckouts{0}, debugReturns{0};
+    SizeClass *findClass(size_t blockSize) const;
+    SizeClass *findOrClaimClass(size_t blockSize, uint32_t lowWatermark, int owner);
+    // The class's claimer makes its reserve just after claiming it
+    static void waitForReserve(const SizeClass &c);
+    void noteCheckout(SizeClass &c);
+    // Allocates one block into the class table and onto the free list
+    bool growClass(SizeClass &c);
+    void fillTo(SizeClass &c, uint32_t count);
+    void replenishLoop();
+
+    std::unique_ptr<std::array<SizeClass, maxSizeClasses>> classes;
+
+    std::atomic<int64_t> debugCheckouts{0}, debugReturns{0};
+    std::atomic<uint64_t> fallbackAllocations{0};
+    std::atomic<uint64_t> reservedBytes{0};
+
+    std::atomic<bool> keepRunning{true};
+    std::thread replenisher;
 };
 } // namespace scxt::engine
 
@@ -30,6 +30,7 @@
 #include "bus.h"
 #include "patch.h"
 #include "engine.h"
+#include "voice/voice.h"
 #include "feature_enums.h"
 
 #include "selection/selection_manager.h"
@@ -133,10 +134,20 @@ void Part::process(Engine &e)
             idx++;
         }
 
-        auto &obus = e.getPatch()->getBusForOutput(bi);
+        if (processingConcurrently)
+        {
+            blk::copy_from_to<blockSize>(defOut[0], concurrentOutput[0]);
+            blk::copy_from_to<blockSize>(defOut[1], concurrentOutput[1]);
+            concurrentOutputBus = bi;
+            hasConcurrentOutput = true;
+        }
+        else
+        {
+            auto &obus = e.getPatch()->getBusForOutput(bi);
 
-        blk::accumulate_from_to<blockSize>(defOut[0], obus.output[0]);
-        blk::accumulate_from_to<blockSize>(defOut[1], obus.output[1]);
+            blk::accumulate_from_to<blockSize>(defOut[0], obus.output[0]);
+            blk::accumulate_from_to<blockSize>(defOut[1], obus.output[1]);
+        }
     }
     auto lv = blk::blockAbsMax<blockSize>(defOut[0]) + blk::blockAbsMax<blockSize>(defOut[1]);
     if (lv > silenceThresh)
@@ -149,6 +160,43 @@ void Part::process(Engine &e)
     }
 }
 
+bool Part::canProcessConcurrently()
+{
+    for (const auto &g : groups)
+    {
+        if (g->isActive() && !g->canProcessConcurrently())
+            return false;
+    }
+    return true;
+}
+
+void Part::processConcurrently(Engine &e)
+{
+    processingConcurrently = true;
+    process(e);
+    processingConcurrently = false;
+}
+
+void Part::flushConcurrentOutput(Engine &e)
+{
+    namespace blk = sst::basic_blocks::mechanics;
+
+    if (hasConcurrentOutput)
+    {
+        auto &obus = e.getPatch()->getBusForOutput(concurrentOutputBus);
+
+        blk::accumulate_from_to<blockSize>(concurrentOutput[0], obus.output[0]);
+        blk::accumulate_from_to<blockSize>(concurrentOutput[1], obus.output[1]);
+        hasConcurrentOutput = false;
+    }
+
+    for (size_t i = 0; i < deferredVoiceReleaseCount; ++i)
+    {
+        deferredVoiceReleases[i]->releaseFromEngine();
+    }
+    deferredVoiceReleaseCount = 0;
+}
+
 bool Part::isActive()
 {
     if (!configuration.active)
@@ -222,6 +270,12 @@ std::vector<SampleID> Part::getSamplesUsedByPart() const
     return std::vector<SampleID>(resSet.begin(), resSet.end());
 }
 
+uint64_t Part::nextZoneLookupGeneration()
+{
+    static std::atomic<uint64_t> generationSource{1};
+    return generationSource.fetch_add(1, std::memory_order_relaxed);
+}
+
 size_t Part::addGroup()
 {
     auto g = std::make_unique<Group>(this->parentPatch->parentEngine->rng);
@@ -250,6 +304,7 @@ size_t Part::addGroup()
     g->name = cn;
 
     groups.push_back(std::move(g));
+    markZoneLookupDirty();
     return groups.size();
 }
 
@@ -258,6 +313,7 @@ size_t Part::addGroup(std::unique_ptr<Group> &g)
     g->parentPart = this;
     g->setSampleRate(getSampleRate());
     groups.push_back(std::move(g));
+    markZoneLookupDirty();
     return groups.size();
 }
 
@@ -291,6 +347,7 @@ void Part::moveGroupToAfter(size_t whichGroup, size_t toAfter)
         }
         groups[toAfter + 1] = std::move(og);
     }
+    markZoneLookupDirty();
 }
 
 void Part::swapGroups(size_t gA, size_t gB)
@@ -301,6 +358,7 @@ void Part::swapGroups(size_t gA, size_t gB)
     }
 
     std::swap(groups[gA], groups[gB]);
+    markZoneLookupDirty();
 }
 
 void Part::setupOnUnstream(Engine &e)
@@ -43,6 +43,7 @@
 #include "group_triggers.h"
 
 #include "bus_effect.h"
+#include "zone_lookup_index.h"
 
 namespace scxt::engine
 {
@@ -132,6 +133,22 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
     } configuration;
     void process(Engine &onto);
 
+    /*
+     * Parts can run on host worker threads when nothing they touch is shared with
+     * another part. While processingConcurrently the part stages its output and the
+     * engine side of voice cleanup; flushConcurrentOutput applies both back on the
+     * audio thread in part order.
+     */
+    bool canProcessConcurrently();
+    void processConcurrently(Engine &onto);
+    void flushConcurrentOutput(Engine &onto);
+    void deferVoiceRelease(voice::Voice *v)
+    {
+        assert(deferredVoiceReleaseCount < deferredVoiceReleases.size());
+        deferredVoiceReleases[deferredVoiceReleaseCount++] = v;
+    }
+    bool processingConcurrently{false};
+
     // TODO: editable name
     std::string getName() const
     {
@@ -149,6 +166,33 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
             addGroup();
     }
 
+    /*
+     * The note-on zone lookup index for this part. zoneLookup is owned by the audio
+     * thread and only used while its generation matches zoneLookupGeneration.
+     * Changing part structure or any zone mapping must mark the index dirty; the
+     * serialization thread then rebuilds it and swaps it in with an audio thread
+     * callback (see Patch::refreshZoneLookupIndices).
+     */
+    static uint64_t nextZoneLookupGeneration();
+    void markZoneLookupDirty()
+    {
+        zoneLookupGeneration.store(nextZoneLookupGeneration(), std::memory_order_release);
+        // New and moved zones need their voice start descriptors too
+        voiceStartDescriptorsNeedRefresh.store(true, std::memory_order_release);
+    }
+    bool isZoneLookupCurrent() const
+    {
+        return zoneLookup &&
+               zoneLookup->generation == zoneLookupGeneration.load(std::memory_order_acquire) &&
+               zoneLookup->groupCount == groups.size();
+    }
+    std::unique_ptr<ZoneLookupIndex> zoneLookup;
+    std::atomic<uint64_t> zoneLookupGeneration{nextZoneLookupGeneration()};
+    uint64_t zoneLookupScheduledGeneration{0}; // serialization thread only
+
+    // Set when a zone in this part may need its voice start descriptors compiled
+    std::atomic<bool> voiceStartDescriptorsNeedRefresh{true};
+
     /**
      *The state of this part for group trigger caches and so on
      */
@@ -197,6 +241,15 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
 
     size_t silenceTime{0}, silenceMax{0};
 
+  private:
+    float concurrentOutput alignas(16)[2][blockSize];
+    BusAddress concurrentOutputBus{DEFAULT_BUS};
+    bool hasConcurrentOutput{false};
+    std::array<voice::Voice *, maxVoices> deferredVoiceReleases{};
+    size_t deferredVoiceReleaseCount{0};
+
+  public:
+
     std::array<float, 128> midiCCValues{}; // 0 .. 1 so the 128 taken out
     float channelAT{0.f};
     float pitchBendValue{0.f}; // -1..1 so the 8192 taken out
@@ -248,7 +301,11 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
     typedef std::vector<std::unique_ptr<Group>> groupContainer_t;
 
     const groupContainer_t &getGroups() const { return groups; }
-    void clearGroups() { groups.clear(); }
+    void clearGroups()
+    {
+        groups.clear();
+        markZoneLookupDirty();
+    }
     int getGroupIndex(const GroupID &zid) const
     {
         for (const auto &[idx, r] : sst::cpputils::enumerate(groups))
@@ -265,6 +322,7 @@ struct Part : MoveableOnly<Part>, SampleRateSupport
         auto res = std::move(groups[idx]);
         groups.erase(groups.begin() + idx);
         res->parentPart = nullptr;
+        markZoneLookupDirty();
         return res;
     }
     groupContainer_t::iterator begin() noexcept { return groups.begin(); }
@@ -26,33 +26,95 @@
  */
 
 #include "patch.h"
+#include "engine.h"
 #include "sst/basic-blocks/mechanics/block-ops.h"
 
 namespace scxt::engine
 {
 void Patch::process(Engine &e)
+{
+    auto *worker = e.getBusEffectWorker();
+
+    // With a worker the bus pass runs the previous block while this one renders
+    auto busSlot = busses.renderInput ^ 1;
+    bool pipelined{worker && busses.inputPending};
+    if (pipelined)
+    {
+        worker->begin(this, busSlot);
+    }
+
+    // Run each of the parts, accumulating onto the bus inputs
+    for (auto &in : busses.inputs[busses.renderInput])
+        in.clear();
+
+    if (!processPartsConcurrently(e))
+    {
+        for (const auto &part : parts)
+        {
+            if (part->isActive())
+            {
+                part->process(e);
+            }
+        }
+    }
+
+    if (pipelined)
+    {
+        worker->finish();
+    }
+    else if (worker)
+    {
+        // The first block after a start has nothing ahead of it to output
+        busses.clear();
+        memset(busses.pluginNonMainOutputs, 0, sizeof(busses.pluginNonMainOutputs));
+    }
+    else
+    {
+        processBusses(busses.renderInput);
+        return;
+    }
+
+    busses.renderInput = busSlot;
+    busses.inputPending = true;
+}
+
+void Patch::Busses::loadInputs(int slot)
 {
     namespace mech = sst::basic_blocks::mechanics;
 
-    // Clear the busses
-    busses.mainBus.clear();
-    for (auto &b : busses.partBusses)
-        b.clear();
-    for (auto &b : busses.auxBusses)
+    for (int a = 0; a < busCount; ++a)
+    {
+        const auto &in = inputs[slot][a];
+        if (!in.used && !busActive[a])
+            continue;
+
+        auto &b = busByAddress((BusAddress)a);
+        busActive[a] = true;
         b.clear();
+        if (!in.used)
+            continue;
 
-    // Run each of the parts, accumulating onto the engine busses
-    for (const auto &part : parts)
-    {
-        if (part->isActive())
+        b.setInRingout(false);
+        mech::copy_from_to<blockSize>(in.output[0], b.output[0]);
+        mech::copy_from_to<blockSize>(in.output[1], b.output[1]);
+        if (in.hasOSSignal)
         {
-            part->process(e);
+            mech::copy_from_to<blockSize << 1>(in.outputOS[0], b.outputOS[0]);
+            mech::copy_from_to<blockSize << 1>(in.outputOS[1], b.outputOS[1]);
+            b.hasOSSignal = true;
         }
     }
+}
+
+void Patch::processBusses(int inputSlot)
+{
+    namespace mech = sst::basic_blocks::mechanics;
+
+    busses.loadInputs(inputSlot);
 
     for (auto &b : busses.partBusses)
     {
-        if (!busses.busUsed[b.address])
+        if (!busses.busActive[b.address])
         {
             continue;
         }
@@ -63,7 +125,7 @@ void Patch::process(Engine &e)
             {
                 if (b.busSendStorage.sendLevels[i] != 0.f)
                 {
-                    busses.busUsed[i + AUX_0] = true;
+                    busses.activate(i + AUX_0);
                     busses.auxBusses[i].inRingout = busses.auxBusses[i].inRingout && b.inRingout;
                     busses.auxBusses[i].silenceMaxUpstreamBusses += b.silenceMaxSelf;
                     switch (b.busSendStorage.auxLocation[i])
@@ -95,16 +157,30 @@ void Patch::process(Engine &e)
     // Process my send busses
     for (auto &b : busses.auxBusses)
     {
+        if (!busses.busActive[b.address])
+        {
+            continue;
+        }
         b.process();
         busses.mainBus.silenceMaxUpstreamBusses += b.silenceMaxSelf + b.silenceMaxUpstreamBusses;
     }
 
-    // TODO - we can be more parsimonious here if we don't use these
-    memset(busses.pluginNonMainOutputs, 0, sizeof(busses.pluginNonMainOutputs));
+    // The wrapper only reads the outputs something is routed to
+    for (int i = 0; i < numNonMainPluginOutputs; ++i)
+    {
+        if (busses.usesOutput[i + 1])
+        {
+            memset(busses.pluginNonMainOutputs[i], 0, sizeof(busses.pluginNonMainOutputs[i]));
+        }
+    }
 
     // And finally push onto the main bus
     for (auto [bi, br] : sst::cpputils::enumerate(busses.partToVSTRouting))
     {
+        if (!busses.busActive[PART_0 + bi])
+        {
+            continue;
+        }
         if (br == 0)
         {
             busses.mainBus.inRingout = busses.mainBus.inRingout && busses.partBusses[bi].inRingout;
@@ -127,6 +203,10 @@ void Patch::process(Engine &e)
 
     for (auto [bi, br] : sst::cpputils::enumerate(busses.auxToVSTRouting))
     {
+        if (!busses.busActive[AUX_0 + bi])
+        {
+            continue;
+        }
         if (br == 0)
         {
             // accumulate onto main
@@ -146,6 +226,22 @@ void Patch::process(Engine &e)
 
     // And run the main bus
     busses.mainBus.process();
+
+    busses.retireSilentBusses();
+}
+
+void Patch::Busses::retireSilentBusses()
+{
+    for (int a = PART_0; a < busCount; ++a)
+    {
+        auto &b = busByAddress((BusAddress)a);
+        if (busActive[a] && b.inRingout && b.wasSilent)
+        {
+            busActive[a] = false;
+            b.vuLevel[0] = 0.f;
+            b.vuLevel[1] = 0.f;
+        }
+    }
 }
 
 void Patch::setupPatchOnUnstream(Engine &e)
@@ -179,4 +275,151 @@ void Patch::onSampleRateChanged()
         a.setSampleRate(getSampleRate());
     }
 }
-} // namespace scxt::engine
\ No newline at end of file
+
+bool Patch::processPartsConcurrently(Engine &e)
+{
+    if (!e.requestConcurrentPartTasks)
+        return false;
+
+    concurrentPartCount = 0;
+    for (const auto &part : parts)
+    {
+        if (part->isActive() && part->canProcessConcurrently())
+        {
+            concurrentParts[concurrentPartCount++] = part.get();
+        }
+    }
+
+    // One part is no better on a host worker than here
+    if (concurrentPartCount < 2 || !e.requestConcurrentPartTasks(concurrentPartCount))
+        return false;
+
+    // Now run the rest and flush the concurrent ones, in part order so the bus sums match
+    uint32_t nextConcurrent{0};
+    for (const auto &part : parts)
+    {
+        if (nextConcurrent < concurrentPartCount && concurrentParts[nextConcurrent] == part.get())
+        {
+            part->flushConcurrentOutput(e);
+            nextConcurrent++;
+        }
+        else if (part->isActive())
+        {
+            part->process(e);
+        }
+    }
+    return true;
+}
+
+void Patch::processConcurrentPartTask(uint32_t taskIndex)
+{
+    assert(taskIndex < concurrentPartCount);
+    concurrentParts[taskIndex]->processConcurrently(*parentEngine);
+}
+
+bool Patch::zoneLookupIndicesNeedRefresh() const
+{
+    for (const auto &p : parts)
+        if (p->zoneLookupScheduledGeneration !=
+            p->zoneLookupGeneration.load(std::memory_order_acquire))
+            return true;
+    return false;
+}
+
+void Patch::refreshZoneLookupIndices()
+{
+    auto &cont = parentEngine->getMessageController();
+    assert(cont->threadingChecker.isSerialThread());
+
+    for (const auto &[pidx, part] : sst::cpputils::enumerate(parts))
+    {
+        auto gen = part->zoneLookupGeneration.load(std::memory_order_acquire);
+        if (gen == part->zoneLookupScheduledGeneration)
+            continue;
+        part->zoneLookupScheduledGeneration = gen;
+
+        // A part the table can't represent just keeps using the full walk
+        auto idx = ZoneLookupIndex::build(*part, gen);
+        if (!idx)
+            continue;
+
+        SCLOG_IF(voiceResponder, "Zone lookup for part " << pidx << " rebuilt with "
+                                                         << idx->candidateCount()
+                                                         << " candidates");
+
+        // The audio thread swaps the new index in and leaves the old one in the
+        // handoff, which is released back here on the serialization thread. Should the
+        // structure move on before the swap lands the generation check makes it inert.
+        auto handoff = std::make_shared<std::unique_ptr<ZoneLookupIndex>>(std::move(idx));
+        cont->scheduleAudioThreadCallbackUnderStructureLock(
+            [p = pidx, handoff](auto &e) {
+                std::swap(e.getPatch()->getPart(p)->zoneLookup, *handoff);
+            },
+            [handoff](auto &) { handoff->reset(); });
+    }
+}
+
+bool Patch::voiceStartDescriptorsNeedRefresh() const
+{
+    for (const auto &p : parts)
+        if (p->voiceStartDescriptorsNeedRefresh.load(std::memory_order_acquire))
+            return true;
+    return false;
+}
+
+void Patch::refreshVoiceStartDescriptors()
+{
+    auto &cont = parentEngine->getMessageController();
+    assert(cont->threadingChecker.isSerialThread());
+
+    struct Compiled
+    {
+        size_t group, zone;
+        ZoneID id;
+        std::unique_ptr<Zone::VoiceStartDescriptors> descriptors;
+    };
+
+    for (const auto &[pidx, part] : sst::cpputils::enumerate(parts))
+    {
+        if (!part->voiceStartDescriptorsNeedRefresh.exchange(false, std::memory_order_acq_rel))
+            continue;
+
+        auto handoff = std::make_shared<std::vector<Compiled>>();
+        for (const auto &[gidx, group] : sst::cpputils::enumerate(part->getGroups()))
+        {
+            for (const auto &[zidx, zone] : sst::cpputils::enumerate(group->getZones()))
+            {
+                auto gen = zone->voiceStartGeneration.value.load(std::memory_order_acquire);
+                if (gen == zone->voiceStartScheduledGeneration)
+                    continue;
+                zone->voiceStartScheduledGeneration = gen;
+                handoff->push_back(
+                    {(size_t)gidx, (size_t)zidx, zone->id, zone->compileVoiceStartDescriptors(gen)});
+            }
+        }
+        if (handoff->empty())
+            continue;
+
+        SCLOG_IF(voiceResponder, "Voice start descriptors for part "
+                                     << pidx << " compiled for " << handoff->size() << " zones");
+
+        // As with the zone lookup the audio thread swaps each set in and leaves the old one
+        // to be freed back here. A zone which moved before the swap lands is skipped; the
+        // move marks it dirty again, and until then its generation keeps anything stale inert.
+        cont->scheduleAudioThreadCallbackUnderStructureLock(
+            [p = pidx, handoff](auto &e) {
+                auto &pt = e.getPatch()->getPart(p);
+                for (auto &c : *handoff)
+                {
+                    if (c.group >= pt->getGroups().size())
+                        continue;
+                    auto &grp = pt->getGroup(c.group);
+                    if (c.zone >= grp->getZones().size() || grp->getZone(c.zone)->id != c.id)
+                        continue;
+                    std::swap(grp->getZone(c.zone)->voiceStartDescriptors, c.descriptors);
+                }
+            },
+            [handoff](auto &) { handoff->clear(); });
+    }
+}
+} // namespace scxt::engine
@@ -46,7 +46,8 @@ struct Patch : MoveableOnly<Patch>, SampleRateSupport
         Busses() : mainBus(MAIN_0) { initialize(); }
         void initialize()
         {
-            std::fill(busUsed.begin(), busUsed.end(), false);
+            std::fill(busActive.begin(), busActive.end(), false);
+            busActive[MAIN_0] = true;
             std::fill(partToVSTRouting.begin(), partToVSTRouting.end(), 0);
             std::fill(auxToVSTRouting.begin(), auxToVSTRouting.end(), 0);
             int adr = PART_0;
@@ -71,12 +72,9 @@ struct Patch : MoveableOnly<Patch>, SampleRateSupport
 
         inline void clear()
         {
-            // TODO - be more parsimonious - only clear things in use
-            mainBus.clear();
-            for (auto &b : partBusses)
-                b.clear();
-            for (auto &b : auxBusses)
-                b.clear();
+            for (int a = 0; a < busCount; ++a)
+                if (busActive[a])
+                    busByAddress((BusAddress)a).clear();
         }
 
         static constexpr int busCount{numParts + numAux + 1};
@@ -163,18 +161,76 @@ struct Patch : MoveableOnly<Patch>, SampleRateSupport
         }
         std::array<bool, numPluginOutputs> usesOutput{};
 
-        std::array<bool, busCount> busUsed;
+        /*
+         * The busses the bus pass touches. A bus joins when input or a send reaches it
+         * and leaves once it has nothing coming in and has rung out, at which point its
+         * output is silent and stays so untouched. The main bus is always active.
+         */
+        std::array<bool, busCount> busActive;
+        void activate(int address)
+        {
+            if (busActive[address])
+                return;
+            busActive[address] = true;
+            busByAddress((BusAddress)address).clear();
+        }
+        void retireSilentBusses();
+
+        /*
+         * Rendering accumulates into inputs[renderInput]. Without a bus effect worker the
+         * bus pass consumes that same block; with one it consumes the other slot, which
+         * holds the previous block, while this one renders. inputPending says that slot
+         * holds a block the bus pass has not yet run.
+         */
+        std::array<std::array<BusInput, busCount>, 2> inputs{};
+        int renderInput{0};
+        bool inputPending{false};
+
+        void loadInputs(int slot);
     } busses;
 
-    Bus &getBusForOutput(BusAddress &ba)
+    BusInput &getBusForOutput(BusAddress &ba)
     {
-        busses.busUsed[(int)ba] = true;
-        busses.busByAddress(ba).setInRingout(false);
-        return busses.busByAddress(ba);
+        auto &in = busses.inputs[busses.renderInput][(int)ba];
+        in.used = true;
+        return in;
     }
 
     void process(Engine &e);
 
+    /*
+     * Run the busses, sends and bus effects on one slot of busses.inputs. This is the
+     * audio thread in the usual case and the BusEffectWorker when pipelined.
+     */
+    void processBusses(int inputSlot);
+
+    /*
+     * Called from a host worker thread for each task requested by process when
+     * parts run concurrently. The task index is an index into the eligible parts.
+     */
+    void processConcurrentPartTask(uint32_t taskIndex);
+
+    /*
+     * Rebuild the note-on zone lookup of any part whose structure or mapping changed
+     * and hand it to the audio thread. Serialization thread only, under the structure
+     * lock.
+     */
+    bool zoneLookupIndicesNeedRefresh() const;
+    void refreshZoneLookupIndices();
+    void markAllZoneLookupsDirty()
+    {
+        for (auto &p : parts)
+            p->markZoneLookupDirty();
+    }
+
+    /*
+     * Compile the voice start descriptors of any zone whose variants or samples changed
+     * and hand them to the audio thread. Serialization thread only, under the structure
+     * lock.
+     */
+    bool voiceStartDescriptorsNeedRefresh() const;
+    void refreshVoiceStartDescriptors();
+
     void resetToBlankPatch()
     {
         for (int i = 0; i < numParts; ++i)
@@ -237,6 +293,10 @@ struct Patch : MoveableOnly<Patch>, SampleRateSupport
 
   private:
     partContainer_t parts;
+
+    bool processPartsConcurrently(Engine &e);
+    std::array<Part *, numParts> concurrentParts{};
+    uint32_t concurrentPartCount{0};
 };
 } // namespace scxt::engine
 
@@ -0,0 +1,64 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "polyphony_group_keys.h"
+
+#include <bit>
+#include <cassert>
+
+namespace scxt::engine
+{
+uint64_t PolyphonyGroupKeys::acquireGroupKey()
+{
+    for (size_t w = 0; w < taken.size(); ++w)
+    {
+        auto cur = taken[w].load(std::memory_order_relaxed);
+        while (cur != ~0ULL)
+        {
+            auto bit = std::countr_one(cur);
+            if (taken[w].compare_exchange_weak(cur, cur | (1ULL << bit),
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_relaxed))
+            {
+                inUse.fetch_add(1, std::memory_order_relaxed);
+                return firstGroupKey + w * 64 + bit;
+            }
+        }
+    }
+    return 0;
+}
+
+void PolyphonyGroupKeys::releaseGroupKey(uint64_t key)
+{
+    assert(key >= firstGroupKey && key < endKey);
+    auto slot = key - firstGroupKey;
+    auto prior = taken[slot / 64].fetch_and(~(1ULL << (slot % 64)), std::memory_order_acq_rel);
+    assert(prior & (1ULL << (slot % 64)));
+    (void)prior;
+    inUse.fetch_sub(1, std::memory_order_relaxed);
+}
+} // namespace scxt::engine
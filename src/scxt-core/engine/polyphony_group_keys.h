@@ -0,0 +1,75 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_ENGINE_POLYPHONY_GROUP_KEYS_H
+#define SCXT_SRC_SCXT_CORE_ENGINE_POLYPHONY_GROUP_KEYS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "configuration.h"
+#include "utils.h"
+
+namespace scxt::engine
+{
+/*
+ * The voice manager keeps its voice limits and play modes in maps keyed by polyphony
+ * group, and adding a key allocates. Only the audio thread may touch it once audio
+ * runs, so the engine creates every key it will use before then and parts and groups
+ * share out that fixed set.
+ *
+ * Each part slot has its own key, the same in every patch. Groups take a key from
+ * a pool the first time they are set up with the voice manager and hand it back when
+ * they are destroyed, so the groups of a patch swapped out return their keys for the
+ * next patch to reuse. Taking and returning keys is lock free and works from any
+ * thread. A group which finds the pool empty falls back to its own address, which the
+ * voice manager adds on first use.
+ */
+struct PolyphonyGroupKeys : MoveableOnly<PolyphonyGroupKeys>
+{
+    PolyphonyGroupKeys() = default;
+
+    static constexpr int32_t groupKeyCount{1024};
+    static constexpr uint64_t firstGroupKey{1 + numParts};
+    static constexpr uint64_t endKey{firstGroupKey + groupKeyCount};
+
+    static uint64_t forPart(int16_t partNumber) { return 1 + (uint64_t)partNumber; }
+
+    // Returns 0 if every group key is in use
+    uint64_t acquireGroupKey();
+    void releaseGroupKey(uint64_t key);
+
+    int32_t getGroupKeysInUse() const { return inUse.load(std::memory_order_relaxed); }
+
+  private:
+    std::array<std::atomic<uint64_t>, groupKeyCount / 64> taken{};
+    std::atomic<int32_t> inUse{0};
+};
+} // namespace scxt::engine
+
+#endif // SCXT_SRC_SCXT_CORE_ENGINE_POLYPHONY_GROUP_KEYS_H
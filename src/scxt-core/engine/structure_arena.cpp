@@ -0,0 +1,133 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "structure_arena.h"
+#include <cassert>
+#include <new>
+
+namespace scxt::engine
+{
+// Every allocation is preceded by this, holding the owning arena or nullptr for the heap
+static constexpr size_t headerSize{alignof(std::max_align_t)};
+static_assert(headerSize >= sizeof(StructureArena *));
+
+thread_local StructureArena *StructureArena::current{nullptr};
+std::atomic<int64_t> StructureArena::liveArenas{0};
+std::atomic<bool> StructureArena::enabled{true};
+
+StructureArena::StructureArena() { liveArenas.fetch_add(1, std::memory_order_relaxed); }
+
+StructureArena::~StructureArena()
+{
+    assert(refs.load() == 0);
+    liveArenas.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void *StructureArena::bump(size_t size)
+{
+    size = (size + headerSize - 1) / headerSize * headerSize;
+
+    if (size > chunkSize / 4)
+    {
+        // Big enough that packing it into a chunk would waste the tail
+        chunks.emplace_back(new uint8_t[size]);
+        return chunks.back().get();
+    }
+
+    if (size > remaining)
+    {
+        chunks.emplace_back(new uint8_t[chunkSize]);
+        cursor = chunks.back().get();
+        remaining = chunkSize;
+    }
+    auto res = cursor;
+    cursor += size;
+    remaining -= size;
+    return res;
+}
+
+void StructureArena::unref()
+{
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete this;
+    }
+}
+
+void *StructureArena::allocate(size_t size)
+{
+    auto *a = current;
+    uint8_t *raw{nullptr};
+    if (a)
+    {
+        raw = static_cast<uint8_t *>(a->bump(size + headerSize));
+        a->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        raw = static_cast<uint8_t *>(::operator new(size + headerSize));
+    }
+    *reinterpret_cast<StructureArena **>(raw) = a;
+    return raw + headerSize;
+}
+
+void StructureArena::release(void *p)
+{
+    if (!p)
+        return;
+
+    auto raw = static_cast<uint8_t *>(p) - headerSize;
+    auto *a = *reinterpret_cast<StructureArena **>(raw);
+    if (a)
+    {
+        a->unref();
+    }
+    else
+    {
+        ::operator delete(raw);
+    }
+}
+
+StructureArena::Scope::Scope(bool enable) : prior(current)
+{
+    if (enable && StructureArena::enabled.load(std::memory_order_relaxed))
+    {
+        arena = new StructureArena();
+        current = arena;
+    }
+}
+
+StructureArena::Scope::~Scope()
+{
+    if (arena)
+    {
+        assert(current == arena);
+        current = prior;
+        arena->unref();
+    }
+}
+} // namespace scxt::engine
@@ -0,0 +1,110 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_ENGINE_STRUCTURE_ARENA_H
+#define SCXT_SRC_SCXT_CORE_ENGINE_STRUCTURE_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "utils.h"
+
+namespace scxt::engine
+{
+/*
+ * Loading a large multi makes thousands of zones and groups, one after another,
+ * all of which usually live and die together. While a StructureArena::Scope is open
+ * on a thread, structure objects created on that thread are carved out of large
+ * shared chunks instead of each going to the heap. That makes the load a handful of
+ * big allocations, keeps zones of a part next to each other in memory, and turns the
+ * teardown at the next clearAll into one release of the chunks.
+ *
+ * Objects made outside a scope (add zone, paste, duplicate) come from the heap as
+ * before. Each allocation carries a small header saying where it came from, so a zone
+ * can move between groups or outlive the load that created it. The arena is reference
+ * counted by its live objects and goes away with the last of them; memory for an
+ * individually deleted zone is not reused until then.
+ *
+ * Only the object itself lives in the arena. The maps, vectors and strings inside a
+ * zone still use the regular heap.
+ */
+struct StructureArena : MoveableOnly<StructureArena>
+{
+    static void *allocate(size_t size);
+    static void release(void *p);
+
+    struct Scope
+    {
+        explicit Scope(bool enable = true);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+      private:
+        StructureArena *prior{nullptr};
+        StructureArena *arena{nullptr};
+    };
+
+    // Global off switch, mostly so load benchmarks can compare with the heap
+    static std::atomic<bool> enabled;
+    static int64_t getLiveArenaCount() { return liveArenas.load(std::memory_order_relaxed); }
+
+    static constexpr size_t chunkSize{4 * 1024 * 1024};
+
+  private:
+    StructureArena();
+    ~StructureArena();
+
+    void *bump(size_t size);
+    void unref();
+
+    std::vector<std::unique_ptr<uint8_t[]>> chunks;
+    uint8_t *cursor{nullptr};
+    size_t remaining{0};
+    // One reference for the open scope and one for every live object
+    std::atomic<int64_t> refs{1};
+
+    static thread_local StructureArena *current;
+    static std::atomic<int64_t> liveArenas;
+};
+
+/*
+ * Mix this into a structure type (struct Zone : ..., StructureArenaAllocated) to have
+ * new and delete of that type go through the StructureArena.
+ */
+struct StructureArenaAllocated
+{
+    static void *operator new(size_t size) { return StructureArena::allocate(size); }
+    static void operator delete(void *p) { StructureArena::release(p); }
+};
+} // namespace scxt::engine
+
+#endif // SCXT_SRC_SCXT_CORE_ENGINE_STRUCTURE_ARENA_H
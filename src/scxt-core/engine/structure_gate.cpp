@@ -0,0 +1,88 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "structure_gate.h"
+
+#include <thread>
+
+namespace scxt::engine
+{
+void StructureGate::enterRead()
+{
+    using namespace std::chrono_literals;
+
+    // Let a deferred mutation land first. If audio has stopped it never will, so
+    // don't wait forever, and once we've given up drop the flag so every read after
+    // us doesn't pay the wait too. If the writer is just slow it raises it again the
+    // next time we turn it away.
+    if (writerWaiting.load(std::memory_order_acquire))
+    {
+        auto giveUp = std::chrono::steady_clock::now() + writerWaitLimit;
+        while (writerWaiting.load(std::memory_order_acquire))
+        {
+            if (std::chrono::steady_clock::now() >= giveUp)
+            {
+                writerWaiting.store(false, std::memory_order_release);
+                break;
+            }
+            std::this_thread::sleep_for(50us);
+        }
+    }
+
+    while (true)
+    {
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        if (!writing.load(std::memory_order_seq_cst))
+            return;
+
+        // Raced a mutation in flight; back out and let it finish
+        readers.fetch_sub(1, std::memory_order_seq_cst);
+        while (writing.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+}
+
+void StructureGate::exitRead() { readers.fetch_sub(1, std::memory_order_seq_cst); }
+
+void StructureGate::writerStopped() { writerWaiting.store(false, std::memory_order_release); }
+
+bool StructureGate::tryEnterWrite()
+{
+    writing.store(true, std::memory_order_seq_cst);
+    if (readers.load(std::memory_order_seq_cst) == 0)
+    {
+        writerWaiting.store(false, std::memory_order_release);
+        return true;
+    }
+    writing.store(false, std::memory_order_release);
+    writerWaiting.store(true, std::memory_order_release);
+    deferredWrites.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void StructureGate::exitWrite() { writing.store(false, std::memory_order_release); }
+} // namespace scxt::engine
@@ -0,0 +1,93 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_ENGINE_STRUCTURE_GATE_H
+#define SCXT_SRC_SCXT_CORE_ENGINE_STRUCTURE_GATE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "utils.h"
+
+namespace scxt::engine
+{
+/*
+ * Structure changes (add a group, remove a zone, swap a lookup index) run as callbacks
+ * on the audio thread, while the serialization thread walks parts, groups and zones
+ * to answer the client. The two must not overlap, but the audio thread must never
+ * wait on the serialization thread to get out of the way.
+ *
+ * So the serialization thread announces a read section and the audio thread only
+ * mutates when no read section is open. If one is, tryEnterWrite fails at once and
+ * the engine keeps the callback (and everything queued behind it) for the next
+ * block. The failed attempt leaves a flag up which stops the serialization thread
+ * opening another read section until the mutation has gone through, so a busy
+ * serialization thread can't starve structure changes. It only ever waits for a
+ * bounded audio thread mutation. If audio stops with a write parked, the first
+ * reader waits at most writerWaitLimit and then drops the flag, as does
+ * writerStopped once the serialization thread notices, so later reads don't stall.
+ *
+ * Both sides announce themselves then look at the other with sequentially
+ * consistent atomics, so at least one of them always sees the other.
+ */
+struct StructureGate : MoveableOnly<StructureGate>
+{
+    StructureGate() = default;
+
+    // Serialization thread
+    void enterRead();
+    void exitRead();
+
+    struct ReadGuard
+    {
+        StructureGate &gate;
+        explicit ReadGuard(StructureGate &g) : gate(g) { gate.enterRead(); }
+        ~ReadGuard() { gate.exitRead(); }
+    };
+
+    // Serialization thread, once audio has stopped. Nothing is coming back to retry a
+    // deferred write, so stop holding readers back for it.
+    void writerStopped();
+
+    // Audio thread. Never blocks.
+    bool tryEnterWrite();
+    void exitWrite();
+
+    static constexpr std::chrono::milliseconds writerWaitLimit{20};
+
+    uint64_t getDeferredWrites() const { return deferredWrites.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<int32_t> readers{0};
+    std::atomic<bool> writing{false};
+    std::atomic<bool> writerWaiting{false};
+    std::atomic<uint64_t> deferredWrites{0};
+};
+} // namespace scxt::engine
+
+#endif // SCXT_SRC_SCXT_CORE_ENGINE_STRUCTURE_GATE_H
@@ -0,0 +1,205 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "voice_render_pool.h"
+
+#include <algorithm>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "voice/voice.h"
+
+namespace scxt::engine
+{
+namespace
+{
+/*
+ * Best effort only. Workers which cannot get a realtime priority or a core
+ * still render correctly, they just may wake a little later.
+ */
+void promoteWorkerThread(std::thread &t, int workerIndex)
+{
+#if defined(__linux__)
+    auto hc = std::thread::hardware_concurrency();
+    if (hc > 1)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET((workerIndex + 1) % hc, &cpus);
+        pthread_setaffinity_np(t.native_handle(), sizeof(cpus), &cpus);
+    }
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+    sched_param sp{};
+    sp.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    pthread_setschedparam(t.native_handle(), SCHED_FIFO, &sp);
+#endif
+}
+} // namespace
+
+VoiceRenderPool::VoiceRenderPool(int numWorkers)
+{
+    numWorkers = std::clamp(numWorkers, 0, maxWorkers);
+    laneCount = numWorkers + 1;
+    workers.reserve(numWorkers);
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.emplace_back([this, lane = i + 1]() { workerLoop(lane); });
+        promoteWorkerThread(workers.back(), i);
+    }
+    SCLOG_IF(always, "Voice render pool started with " << numWorkers << " workers");
+}
+
+VoiceRenderPool::~VoiceRenderPool()
+{
+    keepRunning.store(false, std::memory_order_seq_cst);
+    wakeWorkers.wake();
+    for (auto &t : workers)
+    {
+        t.join();
+    }
+}
+
+bool VoiceRenderPool::claimFromLane(int lane, uint32_t gen, uint32_t &jobIndex)
+{
+    auto &word = lanes[lane].word;
+    auto cur = word.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto laneGen = (uint32_t)(cur >> (2 * laneFieldBits));
+        auto next = (uint32_t)((cur >> laneFieldBits) & laneFieldMask);
+        auto end = (uint32_t)(cur & laneFieldMask);
+        if (laneGen != gen || next >= end)
+            return false;
+
+        if (word.compare_exchange_weak(cur, packLane(gen, next + 1, end),
+                                       std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            jobIndex = next;
+            return true;
+        }
+    }
+}
+
+void VoiceRenderPool::drain(int startLane, uint32_t gen)
+{
+    // Our own lane first, then steal from everyone else
+    for (int i = 0; i < laneCount; ++i)
+    {
+        auto lane = (startLane + i) % laneCount;
+        uint32_t idx;
+        while (claimFromLane(lane, gen, idx))
+        {
+            jobs[idx]->preRender();
+            completed.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+}
+
+void VoiceRenderPool::workerLoop(int lane)
+{
+    auto seen = generation.load(std::memory_order_acquire);
+    while (keepRunning.load(std::memory_order_acquire))
+    {
+        auto gen = generation.load(std::memory_order_acquire);
+        if (gen != seen)
+        {
+            seen = gen;
+            drain(lane, gen);
+            continue;
+        }
+
+        wakeWorkers.sleepUnless(
+            [this, seen]() {
+                return !keepRunning.load(std::memory_order_seq_cst) ||
+                       generation.load(std::memory_order_seq_cst) != seen;
+            },
+            workerWakeLimit);
+    }
+}
+
+void VoiceRenderPool::runJobs()
+{
+    auto n = (uint32_t)jobCount;
+    if (workers.empty() || n < minJobsForParallelRender)
+    {
+        renderSerially();
+        return;
+    }
+    if (serialBlocksLeft > 0)
+    {
+        serialBlocksLeft--;
+        renderSerially();
+        return;
+    }
+
+    auto gen = generation.load(std::memory_order_relaxed) + 1;
+    completed.store(0, std::memory_order_relaxed);
+    for (int l = 0; l < laneCount; ++l)
+    {
+        auto b = (uint32_t)((uint64_t)n * l / laneCount);
+        auto e = (uint32_t)((uint64_t)n * (l + 1) / laneCount);
+        lanes[l].word.store(packLane(gen, b, e), std::memory_order_release);
+    }
+    generation.store(gen, std::memory_order_seq_cst);
+    wakeWorkers.wake();
+
+    // The audio thread renders its own lane and then takes every job no worker has
+    // claimed yet, so when this returns the only jobs left are ones already running
+    drain(0, gen);
+    waitForStragglers(n);
+}
+
+void VoiceRenderPool::renderSerially()
+{
+    for (uint32_t i = 0; i < (uint32_t)jobCount; ++i)
+    {
+        jobs[i]->preRender();
+    }
+}
+
+void VoiceRenderPool::waitForStragglers(uint32_t n)
+{
+    if (completed.load(std::memory_order_acquire) >= n)
+        return;
+
+    auto deadline = std::chrono::steady_clock::now() + stragglerDeadline;
+    bool overran{false};
+    while (completed.load(std::memory_order_acquire) < n)
+    {
+        if (!overran && std::chrono::steady_clock::now() > deadline)
+        {
+            overran = true;
+            stragglerOverruns.fetch_add(1, std::memory_order_relaxed);
+            serialBlocksLeft = overrunSerialBlocks;
+        }
+    }
+}
+} // namespace scxt::engine
@@ -0,0 +1,154 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_ENGINE_VOICE_RENDER_POOL_H
+#define SCXT_SRC_SCXT_CORE_ENGINE_VOICE_RENDER_POOL_H
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "configuration.h"
+#include "utils.h"
+#include "infrastructure/worker_wake.h"
+
+namespace scxt::voice
+{
+struct Voice;
+}
+
+namespace scxt::engine
+{
+/*
+ * The VoiceRenderPool is an optional set of pre-spawned worker threads which
+ * render voices in parallel with the audio thread. It is driven entirely from
+ * the audio thread: a group collects its voices with addJob, then calls runJobs
+ * which returns once every voice has rendered into its own output buffer.
+ *
+ * The audio thread never locks or allocates here. The job list is split into one
+ * contiguous lane per participant (the audio thread is lane 0) and each participant
+ * drains its own lane and then steals from the others. Workers sleep between
+ * generations and runJobs wakes them through a WorkerWake, which never locks and only
+ * enters the kernel if a worker is actually asleep. A worker which wakes late only
+ * costs parallelism, since the audio thread steals whatever is left. A lane is a
+ * single 64 bit atomic word holding the generation, the next job and the end of the
+ * lane, so a worker which wakes late can never claim a job from a later generation.
+ *
+ * Once the audio thread has claimed every job left, the only thing it can wait for is
+ * a voice a worker is rendering right now; that voice's state can't be shared, so it
+ * spins for it and never sleeps. If that takes longer than stragglerDeadline the
+ * worker was descheduled, and runJobs renders every voice on the audio thread itself
+ * for the next overrunSerialBlocks calls rather than depend on the workers again.
+ *
+ * The pool only renders. Summation into zone, group and bus buffers stays on the
+ * audio thread in voice order, so output is bit-identical to serial rendering.
+ */
+struct VoiceRenderPool : MoveableOnly<VoiceRenderPool>
+{
+    static constexpr int maxWorkers{15};
+    // Below this many voices in a group the fork/join costs more than it saves
+    static constexpr size_t minJobsForParallelRender{4};
+
+    explicit VoiceRenderPool(int numWorkers);
+    ~VoiceRenderPool();
+
+    int getWorkerCount() const { return (int)workers.size(); }
+
+    void beginJobs() { jobCount = 0; }
+    void addJob(voice::Voice *v)
+    {
+        assert(jobCount < jobs.size());
+        jobs[jobCount++] = v;
+    }
+    size_t getJobCount() const { return jobCount; }
+    bool shouldRenderInParallel(size_t voiceCount) const
+    {
+        return !workers.empty() && voiceCount >= minJobsForParallelRender;
+    }
+
+    /*
+     * Render every added job and return when all are complete. Audio thread only.
+     */
+    void runJobs();
+
+    // A worker re-checks for work this often even without a wake up
+    static constexpr std::chrono::microseconds workerWakeLimit{1000};
+    // How long the audio thread waits on voices already mid render before it stops
+    // handing voices to the workers, and for how many runJobs calls
+    static constexpr std::chrono::microseconds stragglerDeadline{100};
+    static constexpr int overrunSerialBlocks{256};
+
+    uint64_t getStragglerOverruns() const
+    {
+        return stragglerOverruns.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static constexpr uint64_t laneFieldBits{16};
+    static constexpr uint64_t laneFieldMask{(1ULL << laneFieldBits) - 1};
+    static_assert(maxVoices <= laneFieldMask);
+
+    static uint64_t packLane(uint32_t gen, uint32_t next, uint32_t end)
+    {
+        return ((uint64_t)gen << (2 * laneFieldBits)) | ((uint64_t)next << laneFieldBits) |
+               (uint64_t)end;
+    }
+
+    struct alignas(64) Lane
+    {
+        std::atomic<uint64_t> word{0};
+    };
+
+    bool claimFromLane(int lane, uint32_t gen, uint32_t &jobIndex);
+    void drain(int startLane, uint32_t gen);
+    void workerLoop(int lane);
+    void waitForStragglers(uint32_t n);
+    void renderSerially();
+
+    std::array<voice::Voice *, maxVoices> jobs{};
+    size_t jobCount{0};
+
+    int laneCount{1};
+    std::array<Lane, maxWorkers + 1> lanes{};
+    alignas(64) std::atomic<uint32_t> generation{0};
+    alignas(64) std::atomic<uint32_t> completed{0};
+    std::atomic<bool> keepRunning{true};
+    infrastructure::WorkerWake wakeWorkers;
+
+    // Audio thread only
+    int serialBlocksLeft{0};
+    std::atomic<uint64_t> stragglerOverruns{0};
+
+    std::vector<std::thread> workers;
+};
+} // namespace scxt::engine
+
+#endif // SCXT_SRC_SCXT_CORE_ENGINE_VOICE_RENDER_POOL_H
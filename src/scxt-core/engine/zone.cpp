@@ -33,6 +33,7 @@
 #include "engine.h"
 #include "messaging/messaging.h"
 #include "voice/voice.h"
+#include "voice_render_pool.h"
 
 #include "sst/basic-blocks/mechanics/block-ops.h"
 #include "group_and_zone_impl.h"
@@ -63,10 +64,24 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
     }
     constexpr size_t osBlock{blockSize << (OS ? 1 : 0)};
     namespace blk = sst::basic_blocks::mechanics;
-    // TODO these memsets are probably gratuitous
-    memset(output, 0, sizeof(output));
 
-    mUILag.process();
+    if (voicesPreRendered)
+    {
+        // addVoicesToRenderPool already started the block
+        voicesPreRendered = false;
+    }
+    else
+    {
+        // TODO these memsets are probably gratuitous
+        memset(output, 0, sizeof(output));
+
+        mUILag.process();
+
+        if (shouldProcessVoicesInLockstep())
+        {
+            processVoicesInLockstep();
+        }
+    }
 
     std::array<voice::Voice *, maxVoices> toCleanUp;
     size_t cleanupIdx{0};
@@ -75,7 +90,9 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
     {
         if (v && v->isVoiceAssigned)
         {
-            if (v->process())
+            auto rendered = v->preRendered ? v->preRenderResult : v->process();
+            v->preRendered = false;
+            if (rendered)
             {
                 if (outputInfo.routeTo == DEFAULT_BUS)
                 {
@@ -95,7 +112,7 @@ template <bool OS> void Zone::processWithOS(scxt::engine::Engine &onto)
                     }
                 }
             }
-            if (!v->isVoicePlaying)
+            if (!v->isSounding())
             {
                 toCleanUp[cleanupIdx++] = v;
             }
@@ -286,6 +303,7 @@ bool Zone::attachToSample(const sample::SampleManager &manager, int index, int s
             }
         }
     }
+    markVoiceStartDescriptorsDirty();
     return samplePointers[index] != nullptr;
 }
 
@@ -390,6 +408,93 @@ Zone::LoopDirection Zone::fromStringLoopDirection(const std::string &s)
 
 void Zone::onSampleRateChanged() { mUILag.setRate(120, blockSize, sampleRate); }
 
+bool Zone::canProcessConcurrently()
+{
+    if (outputInfo.routeTo != DEFAULT_BUS)
+        return false;
+
+    for (auto &v : voiceWeakPointers)
+    {
+        if (v && v->isVoiceAssigned && !v->processorsMatchZone())
+            return false;
+    }
+    return true;
+}
+
+void Zone::addVoicesToRenderPool(VoiceRenderPool &pool)
+{
+    // Termination cleans up voices so leave it to process() on the audio thread, and a
+    // zone filtering in lanes keeps to them there rather than switch to each voice's filter
+    if (terminateOnNextProcess || shouldProcessVoicesInLockstep())
+        return;
+
+    memset(output, 0, sizeof(output));
+    mUILag.process();
+    voicesPreRendered = true;
+
+    for (auto &v : voiceWeakPointers)
+    {
+        if (v && v->isVoiceAssigned && v->processorsMatchZone())
+        {
+            pool.addJob(v);
+        }
+    }
+}
+
+bool Zone::shouldProcessVoicesInLockstep() const
+{
+    // Even a lone voice takes this path, so a held note's filter never moves off the lanes
+    if (activeVoices == 0 || outputInfo.procRouting != procRoute_linear ||
+        !getEngine()->getQuadVoiceFilters())
+        return false;
+
+    for (const auto &ps : processorStorage)
+    {
+        if (ps.isActive && dsp::processor::QuadVoiceSVF::supports(ps.type, ps.intParams.data()))
+            return true;
+    }
+    return false;
+}
+
+void Zone::processVoicesInLockstep()
+{
+    std::array<voice::Voice *, lockstepBatchSize> batch{};
+    size_t batchCount{0};
+
+    auto runBatch = [&]() {
+        for (size_t b = 0; b < batchCount; ++b)
+            batch[b]->beginLockstepBlock();
+
+        for (int slot = 0; slot < processorsPerZoneAndGroup; ++slot)
+        {
+            if (voice::Voice::processLockstepSlotInLanes(batch.data(), batchCount, slot))
+                continue;
+            for (size_t b = 0; b < batchCount; ++b)
+                batch[b]->processLockstepSlot(slot);
+        }
+
+        for (size_t b = 0; b < batchCount; ++b)
+        {
+            batch[b]->preRenderResult = batch[b]->endLockstepBlock();
+            batch[b]->preRendered = true;
+        }
+        batchCount = 0;
+    };
+
+    // A voice with only its start offset carry left to play goes through process()
+    for (auto &v : voiceWeakPointers)
+    {
+        if (v && v->isVoiceAssigned && v->isVoicePlaying)
+        {
+            batch[batchCount++] = v;
+            if (batchCount == lockstepBatchSize)
+                runBatch();
+        }
+    }
+    if (batchCount)
+        runBatch();
+}
+
 void Zone::terminateAllVoices()
 {
     std::array<voice::Voice *, maxVoices> toCleanUp{};
@@ -518,6 +623,94 @@ void Zone::deleteVariant(int idx)
         variantData.variants[maxVariantsPerZone - 1] = {};
         samplePointers[maxVariantsPerZone - 1] = {};
     }
+    markVoiceStartDescriptorsDirty();
+}
+
+uint64_t Zone::nextVoiceStartGeneration()
+{
+    static std::atomic<uint64_t> generationSource{1};
+    return generationSource.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Zone::markVoiceStartDescriptorsDirty()
+{
+    voiceStartGeneration.value.store(nextVoiceStartGeneration(), std::memory_order_release);
+    if (parentGroup && parentGroup->parentPart)
+        parentGroup->parentPart->voiceStartDescriptorsNeedRefresh.store(true,
+                                                                       std::memory_order_release);
+}
+
+std::unique_ptr<Zone::VoiceStartDescriptors>
+Zone::compileVoiceStartDescriptors(uint64_t generation) const
+{
+    auto res = std::make_unique<VoiceStartDescriptors>();
+    res->generation = generation;
+    for (int i = 0; i < maxVariantsPerZone; ++i)
+        compileVoiceStartDescriptor(i, res->variants[i]);
+    return res;
+}
+
+void Zone::compileVoiceStartDescriptor(int i, VoiceStartDescriptor &d) const
+{
+    d = {};
+
+    const auto &s = samplePointers[i];
+    if (!s || s->isMissingPlaceholder)
+        return;
+
+    const auto &v = variantData.variants[i];
+    d.playable = true;
+
+    if (s->bitDepth == sample::Sample::BD_I16)
+    {
+        d.io.sampleDataL = s->GetSamplePtrI16(0);
+        d.io.sampleDataR = s->GetSamplePtrI16(1);
+    }
+    else if (s->bitDepth == sample::Sample::BD_F32)
+    {
+        d.io.sampleDataL = s->GetSamplePtrF32(0);
+        d.io.sampleDataR = s->GetSamplePtrF32(1);
+    }
+    else
+    {
+        assert(false);
+    }
+    d.io.waveSize = s->sampleLengthPerChannel;
+
+    auto &st = d.state;
+    st.samplePos = v.startSample;
+    st.sampleSubPos = 0;
+    st.loopLowerBound = v.startSample;
+    st.loopUpperBound = v.endSample;
+    st.loopFade = v.loopFade;
+    st.playbackLowerBound = v.startSample;
+    st.playbackUpperBound = v.endSample;
+    st.direction = 1;
+    st.isFinished = false;
+
+    if (v.loopActive)
+    {
+        st.loopLowerBound = v.startLoop;
+        st.loopUpperBound = v.endLoop;
+    }
+
+    if (v.playReverse)
+    {
+        st.samplePos = st.playbackUpperBound;
+        st.direction = -1;
+    }
+    st.directionAtOutset = st.direction;
+    st.interpolationType = v.interpolationType;
+
+    d.allowOversampling = !(v.interpolationType == dsp::ZeroOrderHold ||
+                            v.interpolationType == dsp::ZOHAA);
+    d.mono = s->channels == 1;
+    d.generator = dsp::GetFPtrGeneratorSample(
+        !d.mono, s->bitDepth == sample::Sample::BD_F32, v.loopActive,
+        v.loopDirection == FORWARD_ONLY,
+
+        // We doo loop count by gating on loopCount < maxLoopCount
+        v.loopMode == LOOP_WHILE_GATED || v.loopMode == LOOP_COUNT);
 }
 
 void Zone::onProcessorTypeChanged(int idx, dsp::processor::ProcessorType)
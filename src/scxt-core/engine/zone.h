@@ -28,6 +28,7 @@
 #define SCXT_SRC_SCXT_CORE_ENGINE_ZONE_H
 
 #include <array>
+#include <atomic>
 
 #include "configuration.h"
 #include "utils.h"
@@ -37,6 +38,7 @@
 #include "sst/basic-blocks/dsp/Lag.h"
 #include "sample/sample_manager.h"
 #include "dsp/processor/processor.h"
+#include "dsp/processor/quad_voice_filter.h"
 #include "modulation/voice_matrix.h"
 #include "modulation/modulator_storage.h"
 
@@ -45,6 +47,7 @@
 #include <fmt/core.h>
 #include "dsp/generator.h"
 #include "bus.h"
+#include "structure_arena.h"
 
 namespace scxt::voice
 {
@@ -55,10 +58,14 @@ namespace scxt::engine
 {
 struct Group;
 struct Engine;
+struct VoiceRenderPool;
 
 constexpr int lfosPerZone{scxt::lfosPerZone};
 
-struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSupport
+struct Zone : MoveableOnly<Zone>,
+              HasGroupZoneProcessors<Zone>,
+              SampleRateSupport,
+              StructureArenaAllocated
 {
     static constexpr int maxVariantsPerZone{scxt::maxVariantsPerZone};
     Zone() : id(ZoneID::next()) { initialize(); }
@@ -161,6 +168,54 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
 
     void deleteVariant(int idx);
 
+    /*
+     * Everything a voice needs to start a variant's generator which doesn't depend on
+     * the note: sample data, bounds, loop and direction setup and the generator
+     * function. Anything which changes the variants or their samples marks them dirty;
+     * the serialization thread then compiles them and swaps them in with an audio thread
+     * callback (see Patch::refreshVoiceStartDescriptors), so starting a voice is a copy
+     * plus the pitch calculation. A voice starting before a fresh set lands compiles
+     * just the variant it needs into its own scratch.
+     */
+    struct VoiceStartDescriptor
+    {
+        bool playable{false}; // there is a sample and it isn't a missing placeholder
+        bool mono{true};
+        bool allowOversampling{true};
+        dsp::GeneratorState state{};
+        dsp::GeneratorIO io{}; // outputs are the voice's own so are left null
+        dsp::GeneratorFPtr generator{nullptr};
+    };
+    struct VoiceStartDescriptors
+    {
+        uint64_t generation{0};
+        std::array<VoiceStartDescriptor, maxVariantsPerZone> variants{};
+    };
+    const VoiceStartDescriptor &getVoiceStartDescriptor(int variant,
+                                                        VoiceStartDescriptor &scratch) const
+    {
+        if (voiceStartDescriptors &&
+            voiceStartDescriptors->generation ==
+                voiceStartGeneration.value.load(std::memory_order_acquire))
+            return voiceStartDescriptors->variants[variant];
+
+        compileVoiceStartDescriptor(variant, scratch);
+        return scratch;
+    }
+    static uint64_t nextVoiceStartGeneration();
+    void markVoiceStartDescriptorsDirty();
+    void compileVoiceStartDescriptor(int variant, VoiceStartDescriptor &into) const;
+    std::unique_ptr<VoiceStartDescriptors> compileVoiceStartDescriptors(uint64_t generation) const;
+    std::unique_ptr<VoiceStartDescriptors> voiceStartDescriptors; // audio thread owned
+    // wrapped so the zone stays moveable
+    struct VoiceStartGeneration
+    {
+        std::atomic<uint64_t> value{nextVoiceStartGeneration()};
+        VoiceStartGeneration() = default;
+        VoiceStartGeneration(VoiceStartGeneration &&o) : value(o.value.load()) {}
+    } voiceStartGeneration;
+    uint64_t voiceStartScheduledGeneration{0}; // serialization thread only
+
     struct ZoneOutputInfo
     {
         float amplitude{1.f}, pan{0.f};
@@ -177,6 +232,27 @@ struct Zone : MoveableOnly<Zone>, HasGroupZoneProcessors<Zone>, SampleRateSuppor
     void process(Engine &onto);
     template <bool OS> void processWithOS(Engine &onto);
 
+    /*
+     * Start this block and hand the voices which can render off the audio thread
+     * to the pool. The following process() then mixes their results in voice order.
+     */
+    void addVoicesToRenderPool(VoiceRenderPool &pool);
+    bool voicesPreRendered{false};
+
+    /*
+     * When the engine runs quad voice filters and the zone chain is linear and holds a filter
+     * QuadVoiceSVF can stand in for, render the voices in batches of lockstepBatchSize,
+     * running each processor slot across the batch before moving to the next. A filter slot
+     * then runs the whole batch at once with a voice in each SIMD lane. Results land in
+     * preRenderResult like the render pool path.
+     */
+    static constexpr size_t lockstepBatchSize{dsp::processor::QuadVoiceSVF::lanes};
+    bool shouldProcessVoicesInLockstep() const;
+    void processVoicesInLockstep();
+
+    // See Part::canProcessConcurrently
+    bool canProcessConcurrently();
+
     std::string givenName{};
     std::string getName() const
     {
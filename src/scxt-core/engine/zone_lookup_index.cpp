@@ -0,0 +1,104 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "zone_lookup_index.h"
+
+#include <algorithm>
+
+#include "part.h"
+#include "group.h"
+#include "zone.h"
+
+namespace scxt::engine
+{
+std::unique_ptr<ZoneLookupIndex> ZoneLookupIndex::build(const Part &part, uint64_t generation)
+{
+    struct Span
+    {
+        Candidate c;
+        int16_t k0, k1, b0, b1;
+        bool wide;
+    };
+    std::vector<Span> spans;
+
+    for (const auto &[gidx, group] : sst::cpputils::enumerate(part.getGroups()))
+    {
+        for (const auto &[zidx, zone] : sst::cpputils::enumerate(group->getZones()))
+        {
+            const auto &kr = zone->mapping.keyboardRange;
+            const auto &vr = zone->mapping.velocityRange;
+
+            if (kr.keyStart < 0 || kr.keyEnd > 127 || vr.velStart < 0 || vr.velEnd > 127)
+                return nullptr;
+
+            // Skip zones which map nothing
+            auto k0 = kr.keyStart, k1 = kr.keyEnd;
+            auto v0 = vr.velStart, v1 = vr.velEnd;
+            if (k1 < k0 || v1 < v0)
+                continue;
+
+            int16_t b0 = v0 / velocityBandSize, b1 = v1 / velocityBandSize;
+            auto coverage = (size_t)(k1 - k0 + 1) * (size_t)(b1 - b0 + 1);
+            spans.push_back(
+                {{(uint32_t)gidx, (uint32_t)zidx}, k0, k1, b0, b1, coverage > wideZoneBucketLimit});
+        }
+    }
+
+    auto res = std::make_unique<ZoneLookupIndex>();
+    res->generation = generation;
+    res->groupCount = part.getGroups().size();
+    res->groupPlays.resize(res->groupCount, 0);
+
+    // Count into bucketStart[b + 1], prefix sum, then fill in part order
+    for (const auto &s : spans)
+    {
+        if (s.wide)
+        {
+            res->wideCandidates.push_back(s.c);
+            continue;
+        }
+        for (auto k = s.k0; k <= s.k1; ++k)
+            for (auto b = s.b0; b <= s.b1; ++b)
+                res->bucketStart[k * numVelocityBands + b + 1]++;
+    }
+    for (size_t b = 0; b < numBuckets; ++b)
+        res->bucketStart[b + 1] += res->bucketStart[b];
+
+    res->candidates.resize(res->bucketStart[numBuckets]);
+    auto fill = res->bucketStart;
+    for (const auto &s : spans)
+    {
+        if (s.wide)
+            continue;
+        for (auto k = s.k0; k <= s.k1; ++k)
+            for (auto b = s.b0; b <= s.b1; ++b)
+                res->candidates[fill[k * numVelocityBands + b]++] = s.c;
+    }
+
+    return res;
+}
+} // namespace scxt::engine
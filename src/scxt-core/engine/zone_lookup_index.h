@@ -0,0 +1,128 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_ENGINE_ZONE_LOOKUP_INDEX_H
+#define SCXT_SRC_SCXT_CORE_ENGINE_ZONE_LOOKUP_INDEX_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "utils.h"
+
+namespace scxt::engine
+{
+struct Part;
+
+/*
+ * A ZoneLookupIndex answers "which zones in this part could sound for this key and
+ * velocity" without walking every zone. It is a bucket table of 128 keys by
+ * numVelocityBands velocity bands, stored as one flat candidate array with per bucket
+ * offsets. Candidates are in group-then-zone order, which is the order a full walk of
+ * the part would find them in.
+ *
+ * Zones which cover more than wideZoneBucketLimit buckets (large layered zones) are
+ * kept in a single side list and checked on every lookup rather than copied into
+ * thousands of buckets.
+ *
+ * The index is built on the serialization thread from a part's structure at a given
+ * generation, handed to the audio thread, and only trusted by Engine::findZone while
+ * that generation is still current. Generations are unique across all parts so an
+ * index can never be mistaken for one built from another part. It holds group and zone
+ * indices so anything which changes zone mapping or part structure must call
+ * Part::markZoneLookupDirty.
+ */
+struct ZoneLookupIndex : MoveableOnly<ZoneLookupIndex>
+{
+    static constexpr int16_t velocityBandSize{8};
+    static constexpr int16_t numVelocityBands{128 / velocityBandSize};
+    static constexpr size_t numBuckets{128 * numVelocityBands};
+    static constexpr size_t wideZoneBucketLimit{256};
+
+    struct Candidate
+    {
+        uint32_t group{0};
+        uint32_t zone{0};
+    };
+
+    /*
+     * Returns nullptr if the part has a mapping the table can't represent (a key or
+     * velocity range outside 0..127); findZone then walks that part in full.
+     */
+    static std::unique_ptr<ZoneLookupIndex> build(const Part &part, uint64_t generation);
+
+    uint64_t generation{0};
+    size_t groupCount{0};
+
+    // Scratch for findZone on the audio thread; sized here so lookup never allocates
+    std::vector<uint8_t> groupPlays;
+
+    /*
+     * Call f(group, zone) for every candidate at key and velocity in part order. The
+     * caller still has to check the zone's exact ranges since buckets are banded.
+     */
+    template <typename F> void forEachCandidate(int16_t key, int16_t velocity, F &&f) const
+    {
+        if (key < 0 || key > 127 || velocity < 0 || velocity > 127)
+            return;
+
+        auto b = bucketFor(key, velocity);
+        auto bi = bucketStart[b], be = bucketStart[b + 1];
+        auto wi = 0U, we = (uint32_t)wideCandidates.size();
+
+        // Merge the bucket and the wide list, both of which are in part order
+        while (bi < be || wi < we)
+        {
+            const Candidate *c;
+            if (wi == we || (bi < be && precedes(candidates[bi], wideCandidates[wi])))
+                c = &candidates[bi++];
+            else
+                c = &wideCandidates[wi++];
+            f(c->group, c->zone);
+        }
+    }
+
+    size_t candidateCount() const { return candidates.size() + wideCandidates.size(); }
+
+  private:
+    static size_t bucketFor(int16_t key, int16_t velocity)
+    {
+        return (size_t)key * numVelocityBands + (size_t)(velocity / velocityBandSize);
+    }
+    static bool precedes(const Candidate &a, const Candidate &b)
+    {
+        return a.group < b.group || (a.group == b.group && a.zone < b.zone);
+    }
+
+    std::array<uint32_t, numBuckets + 1> bucketStart{};
+    std::vector<Candidate> candidates;
+    std::vector<Candidate> wideCandidates;
+};
+} // namespace scxt::engine
+
+#endif // SCXT_SRC_SCXT_CORE_ENGINE_ZONE_LOOKUP_INDEX_H
@@ -0,0 +1,231 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "audio_thread_guard.h"
+
+#if SCXT_AUDIO_THREAD_GUARD
+
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#include <execinfo.h>
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+namespace scxt::infrastructure::audio_thread_guard
+{
+namespace detail
+{
+thread_local bool armed{false};
+// Our own bookkeeping (backtrace, dlsym) may allocate; don't recurse into it
+thread_local bool inGuard{false};
+
+static constexpr size_t logSize{1024};
+struct Slot
+{
+    Violation violation;
+    std::atomic<bool> published{false};
+};
+std::array<Slot, logSize> violationLog;
+std::atomic<size_t> violationCount{0};
+
+inline void record(ViolationType type, size_t bytes)
+{
+    if (!armed || inGuard)
+        return;
+
+    inGuard = true;
+    auto idx = violationCount.fetch_add(1, std::memory_order_acq_rel);
+    if (idx < logSize)
+    {
+        auto &slot = violationLog[idx];
+        slot.violation.type = type;
+        slot.violation.bytes = bytes;
+        slot.violation.frameCount = backtrace(slot.violation.frames, maxFrames);
+        slot.published.store(true, std::memory_order_release);
+    }
+    inGuard = false;
+}
+} // namespace detail
+
+void armCurrentThread()
+{
+    if (detail::armed)
+        return;
+
+    // backtrace loads its unwinder on first use, so take that hit before arming
+    void *warm[2];
+    backtrace(warm, 2);
+    detail::armed = true;
+}
+
+size_t mark() { return detail::violationCount.load(std::memory_order_acquire); }
+size_t violationsSince(size_t m) { return mark() - m; }
+
+std::string describe(size_t index)
+{
+    if (index >= detail::logSize ||
+        !detail::violationLog[index].published.load(std::memory_order_acquire))
+        return {};
+
+    const auto &v = detail::violationLog[index].violation;
+    std::ostringstream oss;
+    switch (v.type)
+    {
+    case ALLOCATION:
+        oss << "Allocation of " << v.bytes << " bytes";
+        break;
+    case DEALLOCATION:
+        oss << "Deallocation";
+        break;
+    case MUTEX_LOCK:
+        oss << "Mutex lock";
+        break;
+    }
+    oss << " on the audio thread\n";
+
+    auto syms = backtrace_symbols(v.frames, v.frameCount);
+    for (int i = 0; i < v.frameCount; ++i)
+    {
+        oss << "    " << (syms ? syms[i] : "??") << "\n";
+    }
+    free(syms);
+    return oss.str();
+}
+} // namespace scxt::infrastructure::audio_thread_guard
+
+namespace atgd = scxt::infrastructure::audio_thread_guard::detail;
+namespace atg = scxt::infrastructure::audio_thread_guard;
+
+#if defined(__GLIBC__)
+/*
+ * On glibc replace the C allocator itself, which catches C++ allocation as well
+ * as anything our libraries do with malloc directly.
+ */
+extern "C"
+{
+    void *__libc_malloc(size_t);
+    void *__libc_calloc(size_t, size_t);
+    void *__libc_realloc(void *, size_t);
+    void *__libc_memalign(size_t, size_t);
+    void __libc_free(void *);
+
+    void *malloc(size_t sz) noexcept
+    {
+        atgd::record(atg::ALLOCATION, sz);
+        return __libc_malloc(sz);
+    }
+
+    void *calloc(size_t n, size_t sz) noexcept
+    {
+        atgd::record(atg::ALLOCATION, n * sz);
+        return __libc_calloc(n, sz);
+    }
+
+    void *realloc(void *p, size_t sz) noexcept
+    {
+        atgd::record(atg::ALLOCATION, sz);
+        return __libc_realloc(p, sz);
+    }
+
+    void *aligned_alloc(size_t al, size_t sz) noexcept
+    {
+        atgd::record(atg::ALLOCATION, sz);
+        return __libc_memalign(al, sz);
+    }
+
+    int posix_memalign(void **res, size_t al, size_t sz) noexcept
+    {
+        atgd::record(atg::ALLOCATION, sz);
+        auto p = __libc_memalign(al, sz);
+        if (!p)
+            return ENOMEM;
+        *res = p;
+        return 0;
+    }
+
+    void free(void *p) noexcept
+    {
+        if (p)
+            atgd::record(atg::DEALLOCATION, 0);
+        __libc_free(p);
+    }
+}
+#else
+/*
+ * Elsewhere replace the global operator new and delete.
+ */
+void *operator new(size_t sz)
+{
+    atgd::record(atg::ALLOCATION, sz);
+    if (auto p = std::malloc(sz))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](size_t sz) { return ::operator new(sz); }
+void *operator new(size_t sz, const std::nothrow_t &) noexcept
+{
+    atgd::record(atg::ALLOCATION, sz);
+    return std::malloc(sz);
+}
+void *operator new[](size_t sz, const std::nothrow_t &t) noexcept
+{
+    return ::operator new(sz, t);
+}
+void operator delete(void *p) noexcept
+{
+    if (p)
+        atgd::record(atg::DEALLOCATION, 0);
+    std::free(p);
+}
+void operator delete[](void *p) noexcept { ::operator delete(p); }
+void operator delete(void *p, size_t) noexcept { ::operator delete(p); }
+void operator delete[](void *p, size_t) noexcept { ::operator delete(p); }
+#endif
+
+#if defined(__linux__)
+extern "C" int pthread_mutex_lock(pthread_mutex_t *m) noexcept
+{
+    using lock_t = int (*)(pthread_mutex_t *);
+    // Constant initialized so there is no static guard (which could itself lock)
+    static lock_t realLock{nullptr};
+    if (!realLock)
+        realLock = (lock_t)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+
+    atgd::record(atg::MUTEX_LOCK, 0);
+    return realLock(m);
+}
+#endif
+
+#endif // SCXT_AUDIO_THREAD_GUARD
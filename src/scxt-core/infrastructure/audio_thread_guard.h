@@ -0,0 +1,73 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_AUDIO_THREAD_GUARD_H
+#define SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_AUDIO_THREAD_GUARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * A testing aid, built only with -DSCXT_AUDIO_THREAD_GUARD=TRUE, which interposes the
+ * allocator and (on linux) pthread_mutex_lock. Any such call made by a thread which
+ * registered itself with ThreadingChecker::registerAsAudioThread is recorded, with its
+ * call stack, in a fixed size lock free log which tests can inspect.
+ *
+ * Never ship a build with this on.
+ */
+namespace scxt::infrastructure::audio_thread_guard
+{
+enum ViolationType : uint8_t
+{
+    ALLOCATION,
+    DEALLOCATION,
+    MUTEX_LOCK
+};
+
+static constexpr int maxFrames{24};
+struct Violation
+{
+    ViolationType type{ALLOCATION};
+    size_t bytes{0};
+    int frameCount{0};
+    void *frames[maxFrames]{};
+};
+
+#if SCXT_AUDIO_THREAD_GUARD
+void armCurrentThread();
+
+// The running count of violations. Take a mark before an operation and compare after.
+size_t mark();
+size_t violationsSince(size_t mark);
+
+// A readable report of violation number index, or empty if the log had filled by then
+std::string describe(size_t index);
+#endif
+} // namespace scxt::infrastructure::audio_thread_guard
+
+#endif // SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_AUDIO_THREAD_GUARD_H
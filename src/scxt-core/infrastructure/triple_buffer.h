@@ -0,0 +1,83 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_TRIPLE_BUFFER_H
+#define SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace scxt::infrastructure
+{
+
+/**
+ * A wait free single writer single reader channel for a whole value. The writer
+ * fills writeBuffer() and calls publish(); the reader calls acquireLatest() and
+ * then reads read(), which stays put until its next acquireLatest(). Neither side
+ * ever sees the other half way through, and neither ever waits.
+ *
+ * Three copies of T: one the writer owns, one the reader owns, and the most recently
+ * published one in the middle which they trade with an atomic exchange. If the
+ * writer publishes twice before the reader looks, the older value is simply dropped.
+ */
+template <typename T> struct TripleBuffer
+{
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // Writer side
+    T &writeBuffer() { return buffers[back]; }
+    void publish()
+    {
+        auto prior = middle.exchange(back | freshBit, std::memory_order_acq_rel);
+        back = prior & indexMask;
+    }
+
+    // Reader side. Returns false, leaving read() alone, if nothing new was published
+    bool acquireLatest()
+    {
+        if (!(middle.load(std::memory_order_relaxed) & freshBit))
+            return false;
+        auto prior = middle.exchange(front, std::memory_order_acq_rel);
+        front = prior & indexMask;
+        return true;
+    }
+    const T &read() const { return buffers[front]; }
+
+  private:
+    static constexpr uint8_t indexMask{0x3}, freshBit{0x4};
+
+    std::array<T, 3> buffers{};
+    alignas(64) std::atomic<uint8_t> middle{1};
+    alignas(64) uint8_t back{0};
+    alignas(64) uint8_t front{2};
+};
+} // namespace scxt::infrastructure
+
+#endif // SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_TRIPLE_BUFFER_H
@@ -49,6 +49,10 @@ enum DefaultKeys
     browserPreviewAmplitude,
     useSoftwareRenderer,
     showUndoRedo,
+    voiceRenderWorkerThreads,
+    pipelinedBusEffects,
+    jsonWireFormat,
+    quadVoiceFilters,
 
     nKeys // must be last K?
 };
@@ -88,6 +92,14 @@ inline std::string defaultKeyToString(DefaultKeys k)
         return "useSoftwareRenderer";
     case showUndoRedo:
         return "showUndoRedo";
+    case voiceRenderWorkerThreads:
+        return "voiceRenderWorkerThreads";
+    case pipelinedBusEffects:
+        return "pipelinedBusEffects";
+    case jsonWireFormat:
+        return "jsonWireFormat";
+    case quadVoiceFilters:
+        return "quadVoiceFilters";
     default:
         std::terminate(); // for now
     }
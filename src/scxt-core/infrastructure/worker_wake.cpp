@@ -0,0 +1,104 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "worker_wake.h"
+
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#elif defined(_WIN32)
+#include <climits>
+#include <windows.h>
+#else
+#include <cerrno>
+#include <ctime>
+#include <semaphore.h>
+#endif
+
+namespace scxt::infrastructure
+{
+/*
+ * std::counting_semaphore isn't available on our oldest macOS target, so wrap the
+ * native one. Each of these only enters the kernel on post if a thread is waiting.
+ */
+#if defined(__APPLE__)
+struct WorkerWake::Semaphore
+{
+    dispatch_semaphore_t sem{dispatch_semaphore_create(0)};
+    ~Semaphore() { dispatch_release(sem); }
+    void post() { dispatch_semaphore_signal(sem); }
+    void waitFor(std::chrono::microseconds limit)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(limit).count();
+        dispatch_semaphore_wait(sem, dispatch_time(DISPATCH_TIME_NOW, ns));
+    }
+};
+#elif defined(_WIN32)
+struct WorkerWake::Semaphore
+{
+    HANDLE sem{CreateSemaphore(nullptr, 0, LONG_MAX, nullptr)};
+    ~Semaphore() { CloseHandle(sem); }
+    void post() { ReleaseSemaphore(sem, 1, nullptr); }
+    void waitFor(std::chrono::microseconds limit)
+    {
+        auto ms = std::chrono::ceil<std::chrono::milliseconds>(limit).count();
+        WaitForSingleObject(sem, (DWORD)ms);
+    }
+};
+#else
+struct WorkerWake::Semaphore
+{
+    sem_t sem;
+    Semaphore() { sem_init(&sem, 0, 0); }
+    ~Semaphore() { sem_destroy(&sem); }
+    void post() { sem_post(&sem); }
+    void waitFor(std::chrono::microseconds limit)
+    {
+        // sem_timedwait takes an absolute CLOCK_REALTIME deadline
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        auto ns = (int64_t)ts.tv_nsec +
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(limit).count();
+        ts.tv_sec += (time_t)(ns / 1000000000);
+        ts.tv_nsec = (long)(ns % 1000000000);
+        while (sem_timedwait(&sem, &ts) != 0 && errno == EINTR)
+        {
+        }
+    }
+};
+#endif
+
+WorkerWake::WorkerWake() : semaphore(std::make_unique<Semaphore>()) {}
+WorkerWake::~WorkerWake() = default;
+
+void WorkerWake::waitForToken(std::chrono::microseconds limit) { semaphore->waitFor(limit); }
+
+void WorkerWake::postTokens(int32_t n)
+{
+    for (int32_t i = 0; i < n; ++i)
+        semaphore->post();
+}
+} // namespace scxt::infrastructure
@@ -0,0 +1,87 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_WORKER_WAKE_H
+#define SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_WORKER_WAKE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace scxt::infrastructure
+{
+/**
+ * Lets the audio thread wake sleeping worker threads without taking a lock and
+ * without losing a wake up.
+ *
+ * A worker announces itself as a sleeper, re-checks its condition and only then
+ * blocks on a counting semaphore. The audio thread publishes its work and then posts
+ * one token per announced sleeper. Both sides use sequentially consistent atomics,
+ * so either the worker sees the work or the audio thread sees the sleeper, and a
+ * token posted before the worker blocks is still there when it does. When nobody is
+ * asleep wake is a single atomic load, so the audio thread only makes a system call
+ * when it really has a thread to wake.
+ *
+ * Left over tokens just make a later sleep return early, and the worker re-checks.
+ */
+struct WorkerWake
+{
+    WorkerWake();
+    ~WorkerWake();
+    WorkerWake(const WorkerWake &) = delete;
+    WorkerWake &operator=(const WorkerWake &) = delete;
+
+    // Worker. Sleeps until woken or for at most limit, unless ready() is already true.
+    template <typename F> void sleepUnless(F &&ready, std::chrono::microseconds limit)
+    {
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if (!ready())
+            waitForToken(limit);
+        sleepers.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    // Any thread, including the audio thread. Publish the work with a sequentially
+    // consistent store before calling this.
+    void wake()
+    {
+        auto n = sleepers.load(std::memory_order_seq_cst);
+        if (n > 0)
+            postTokens(n);
+    }
+
+  private:
+    void waitForToken(std::chrono::microseconds limit);
+    void postTokens(int32_t n);
+
+    std::atomic<int32_t> sleepers{0};
+    struct Semaphore;
+    std::unique_ptr<Semaphore> semaphore;
+};
+} // namespace scxt::infrastructure
+
+#endif // SCXT_SRC_SCXT_CORE_INFRASTRUCTURE_WORKER_WAKE_H
@@ -73,6 +73,8 @@ std::string streamEngineState(const engine::Engine &e, bool pretty)
 void unstreamEngineState(engine::Engine &e, const std::string &data, bool msgPack)
 {
     e.clearAll(false);
+    // Everything this load builds is released together, so pack it into one arena
+    engine::StructureArena::Scope arenaScope;
     if (msgPack)
     {
         tao::json::events::transformer<tao::json::events::to_basic_value<scxt_traits>> consumer;
@@ -91,11 +93,66 @@ void unstreamEngineState(engine::Engine &e, const std::string &data, bool msgPac
     e.sendFullRefreshToClient();
 }
 
+void unstreamEngineStateInBackground(engine::Engine &e, const std::string &data, bool msgPack,
+                                     std::function<void(engine::Engine &)> onSwapped)
+{
+    assert(e.getMessageController()->threadingChecker.isSerialThread());
+
+    tao::json::events::transformer<tao::json::events::to_basic_value<scxt_traits>> consumer;
+    if (msgPack)
+        tao::json::msgpack::events::from_string(consumer, data);
+    else
+        tao::json::events::from_string(consumer, data);
+    auto jv = std::move(consumer.value);
+
+    auto sv{0};
+    findIf(jv, "streamingVersion", sv);
+    SCLOG_IF(always, "Unstreaming engine state in background. Stream version : "
+                         << scxt::humanReadableVersion(sv));
+    engine::Engine::UnstreamGuard sg(sv);
+
+    // Mirrors the Engine SC_TO, except the patch is built to the side of the live one
+    auto swap = std::make_unique<engine::Engine::PatchSwap>();
+    swap->stagedSamples = e.getSampleManager()->makeStaging();
+    {
+        engine::StructureArena::Scope arenaScope;
+        engine::Engine::SampleManagerStagingGuard staging(e, swap->stagedSamples);
+        findIf(jv, "sampleManager", *(e.getSampleManager()));
+
+        swap->patch = std::make_unique<engine::Patch>();
+        swap->patch->parentEngine = &e;
+        findIf(jv, "patch", *(swap->patch));
+        swap->patch->setupPatchOnUnstream(e);
+        swap->patch->setSampleRate(e.getSampleRate());
+    }
+    swap->runtimeConfig = e.runtimeConfig;
+    findIf(jv, "runtimeConfig", swap->runtimeConfig);
+
+    // Selections are addresses into the new patch, so they wait until it is live
+    std::shared_ptr<scxt_value> selection;
+    if (auto sel = jv.find("selectionManager"))
+        selection = std::make_shared<scxt_value>(std::move(*sel));
+
+    swap->onSwapped = [selection, sv, f = std::move(onSwapped)](engine::Engine &e) {
+        if (selection)
+        {
+            engine::Engine::UnstreamGuard sg(sv);
+            selection->to(*(e.getSelectionManager()));
+        }
+        e.getSampleManager()->purgeUnreferencedSamples();
+        e.sendFullRefreshToClient();
+        if (f)
+            f(e);
+    };
+    e.swapPatchInBackground(std::move(swap));
+}
+
 void unstreamPartState(engine::Engine &e, int part, const std::string &data, bool msgPack,
                        bool setStreamGuard)
 {
     e.getPatch()->getPart(part)->clearGroups();
     {
+        engine::StructureArena::Scope arenaScope;
         std::unique_ptr<engine::Engine::StreamGuard> sg;
         if (setStreamGuard)
         {
@@ -37,6 +37,14 @@ namespace scxt::json
 std::string streamPatch(const engine::Patch &p, bool pretty = false);
 std::string streamEngineState(const engine::Engine &e, bool pretty = false);
 void unstreamEngineState(engine::Engine &e, const std::string &jsonData, bool msgPack = false);
+
+/*
+ * Builds the new patch on the calling (serialization) thread while the current one
+ * keeps playing, then has the audio thread swap it in; see Engine::PatchSwap.
+ * onSwapped runs on the serialization thread once the new patch is live.
+ */
+void unstreamEngineStateInBackground(engine::Engine &e, const std::string &data, bool msgPack,
+                                     std::function<void(engine::Engine &)> onSwapped = nullptr);
 void unstreamPartState(engine::Engine &e, int part, const std::string &jsonData,
                        bool msgPack = false, bool setStreamGuard = true);
 } // namespace scxt::json
@@ -213,6 +213,11 @@ enum ClientToSerializationMessagesIds
 
     c2s_begin_zone_mapping_modification,
 
+    c2s_request_memory_pool_stats,
+    c2s_set_latency_tracing,
+    c2s_request_latency_report,
+    c2s_set_client_frame_rate,
+
     num_clientToSerializationMessages
 };
 
@@ -268,6 +273,10 @@ enum SerializationToClientMessageIds
 
     s2c_update_omni_flavor,
 
+    s2c_send_memory_pool_stats,
+    s2c_send_pgz_structure_delta,
+    s2c_send_latency_report,
+
     num_serializationToClientMessages
 };
 
@@ -298,9 +307,19 @@ template <typename T> void clientSendToSerialization(const T &message, MessageCo
 template <typename T>
 void serializationSendToClient(SerializationToClientMessageIds id, const T &payload,
                                messaging::MessageController &mc);
+// Holds payload until the next UI frame, replacing anything held for (id, address)
+template <typename T>
+void serializationSendToClientCoalesced(SerializationToClientMessageIds id, uint64_t address,
+                                        const T &payload, messaging::MessageController &mc);
 
 void serializationThreadExecuteClientMessage(const std::string &msgView, engine::Engine &e,
                                              MessageController &mc);
+// True if a message from outside the process decodes and names a message we handle. A
+// flat frame must also be exactly the size of that message's payload.
+bool isWellFormedClientMessage(const std::string &msg);
+// Drops parameter updates in a batch of inbound messages which a later message in the
+// same batch overwrites. Returns the number dropped.
+size_t coalesceClientMessages(std::vector<InboundMessage> &batch);
 template <typename Client>
 void clientThreadExecuteSerializationMessage(const std::string &msgView, Client *c);
 
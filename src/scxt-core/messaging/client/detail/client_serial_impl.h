@@ -39,6 +39,14 @@
 #include "tao/json/msgpack/to_stream.hpp"
 #include "tao/json/msgpack/to_string.hpp"
 
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
 #include "messaging/client/detail/client_json_details.h"
 
 // This is a 'details only' file which you can safely ignore
@@ -46,19 +54,120 @@
 namespace scxt::messaging::client
 {
 /*
- * Inter-process messages can pack as JSON (the streaming format we use)
- * or as msgpack messages which are a lot smaller and faster. PROCESS_AS_JSON
- * is really just useful for debugging where you actually want to see a message
+ * Messages pack as msgpack, or as JSON (the streaming format we use) when the
+ * MessageController wireFormat asks for it, which is really just useful for debugging
+ * where you actually want to see a message. Payloads which are a scalar or a tuple of
+ * scalars, which is every knob drag and most small updates, skip the value tree and
+ * go as a flat frame: a tag byte, the message id and the raw scalar bytes. Those bytes
+ * are only meaningful to the same build, which in process is a given. Anything carrying
+ * frames between processes has to establish that first, as the engine server does with
+ * its connection handshake, and should check frames with isWellFormedClientMessage.
+ *
+ * Receivers look at the first byte to decide how to decode, so the format can change
+ * at any time.
  */
-#define PROCESS_AS_JSON 0
-#if PROCESS_AS_JSON
-namespace encoder = tao::json;
-#else
-namespace encoder = tao::json::msgpack;
-#endif
-
 namespace detail
 {
+// 0xC1 is never used by msgpack and JSON messages open with '{'
+static constexpr char flatFrameTag{(char)0xC1};
+
+template <typename T>
+struct isFlatScalar : std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T>>
+{
+};
+template <typename T> struct FlatLayout
+{
+    static constexpr bool value{isFlatScalar<T>::value};
+};
+template <typename... Ts> struct FlatLayout<std::tuple<Ts...>>
+{
+    static constexpr bool value{(isFlatScalar<Ts>::value && ...)};
+};
+template <typename A, typename B> struct FlatLayout<std::pair<A, B>>
+{
+    static constexpr bool value{isFlatScalar<A>::value && isFlatScalar<B>::value};
+};
+
+template <typename T> void flatPack(std::string &s, const T &v)
+{
+    if constexpr (isFlatScalar<T>::value)
+    {
+        s.append(reinterpret_cast<const char *>(&v), sizeof(T));
+    }
+    else
+    {
+        std::apply([&s](const auto &...e) { (flatPack(s, e), ...); }, v);
+    }
+}
+
+template <typename T> bool flatUnpack(const char *&p, const char *end, T &v)
+{
+    if constexpr (isFlatScalar<T>::value)
+    {
+        if (end - p < (ptrdiff_t)sizeof(T))
+            return false;
+        memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+    else
+    {
+        return std::apply([&p, end](auto &...e) { return (flatUnpack(p, end, e) && ...); }, v);
+    }
+}
+
+template <typename T> std::string flatFrame(int32_t id, const T &payload)
+{
+    std::string res;
+    res.reserve(1 + sizeof(int32_t) + sizeof(T));
+    res.push_back(flatFrameTag);
+    flatPack(res, id);
+    flatPack(res, payload);
+    return res;
+}
+
+inline bool isFlatFrame(const std::string &msg) { return !msg.empty() && msg[0] == flatFrameTag; }
+inline int32_t flatFrameId(const std::string &msg)
+{
+    int32_t id{-1};
+    const char *p = msg.data() + 1;
+    if (!flatUnpack(p, msg.data() + msg.size(), id))
+        return -1;
+    return id;
+}
+template <typename T> bool flatFramePayload(const std::string &msg, T &payload)
+{
+    const char *p = msg.data() + 1 + sizeof(int32_t);
+    const char *end = msg.data() + msg.size();
+    return flatUnpack(p, end, payload) && p == end;
+}
+
+inline std::string encodeValue(const client_message_value &v, const MessageController &mc)
+{
+    if (mc.wireFormat.load(std::memory_order_relaxed) == MessageController::WireFormat::JSON)
+        return tao::json::to_string(v);
+    return tao::json::msgpack::to_string(v);
+}
+
+inline client_message_value decodeValue(const std::string &msg)
+{
+    using namespace tao::json;
+
+    // We need to unpack with the client message traits
+    events::transformer<events::to_basic_value<detail::client_message_traits>> consumer;
+    if (!msg.empty() && msg[0] == '{')
+        events::from_string(consumer, msg);
+    else
+        msgpack::events::from_string(consumer, msg);
+    return std::move(consumer.value);
+}
+
+template <typename T>
+inline bool useFlatFrame(const MessageController &mc)
+{
+    return FlatLayout<T>::value &&
+           mc.wireFormat.load(std::memory_order_relaxed) == MessageController::WireFormat::BINARY;
+}
 template <typename T> struct MessageWrapper
 {
     const T &msg;
@@ -118,6 +227,40 @@ void doExecOnSerialization(tao::json::basic_value<Traits> &o, engine::Engine &e,
     }
 }
 
+template <size_t I>
+void doExecFlatOnSerialization(const std::string &msg, engine::Engine &e, MessageController &mc)
+{
+    typedef typename ClientToSerializationType<(ClientToSerializationMessagesIds)I>::T handler_t;
+    if constexpr (std::is_same<handler_t, unimpl_t>::value)
+    {
+        assert(false);
+    }
+    else if constexpr (!FlatLayout<typename handler_t::c2s_payload_t>::value)
+    {
+        // Only scalar payloads are ever sent flat
+        assert(false);
+    }
+    else
+    {
+        typename handler_t::c2s_payload_t payload;
+        if (!flatFramePayload(msg, payload))
+        {
+            assert(false);
+            return;
+        }
+        handler_t::executeOnSerialization(payload, e, mc);
+    }
+}
+
+template <size_t... Is>
+void executeFlatOnSerializationFor(size_t ft, const std::string &msg, engine::Engine &e,
+                                   MessageController &mc, std::index_sequence<Is...>)
+{
+    using vtOp_t = void (*)(const std::string &, engine::Engine &, MessageController &);
+    constexpr vtOp_t fnc[] = {detail::doExecFlatOnSerialization<Is>...};
+    fnc[ft](msg, e, mc);
+}
+
 template <template <typename...> class Traits, size_t... Is>
 auto executeOnSerializationFor(size_t ft, typename tao::json::basic_value<Traits> &o,
                                engine::Engine &e, MessageController &mc, std::index_sequence<Is...>)
@@ -148,6 +291,38 @@ void doExecOnClient(tao::json::basic_value<Traits> &o, Client *c)
         handler_t::template executeOnClient<Client>(c, payload);
     }
 }
+template <size_t I, typename Client> void doExecFlatOnClient(const std::string &msg, Client *c)
+{
+    typedef typename SerializationToClientType<(SerializationToClientMessageIds)I>::T handler_t;
+    if constexpr (std::is_same<handler_t, unimpl_t>::value)
+    {
+        assert(false);
+    }
+    else if constexpr (!FlatLayout<typename handler_t::s2c_payload_t>::value)
+    {
+        assert(false);
+    }
+    else
+    {
+        typename handler_t::s2c_payload_t payload;
+        if (!flatFramePayload(msg, payload))
+        {
+            assert(false);
+            return;
+        }
+        handler_t::template executeOnClient<Client>(c, payload);
+    }
+}
+
+template <typename Client, size_t... Is>
+void executeFlatOnClientFor(size_t ft, const std::string &msg, Client *c,
+                            std::index_sequence<Is...>)
+{
+    using vtOp_t = void (*)(const std::string &, Client *);
+    constexpr vtOp_t fnc[] = {detail::doExecFlatOnClient<Is, Client>...};
+    fnc[ft](msg, c);
+}
+
 template <typename Client, template <typename...> class Traits, size_t... Is>
 auto executeOnClientFor(size_t ft, typename tao::json::basic_value<Traits> &o, Client *c,
                         std::index_sequence<Is...>)
@@ -157,17 +332,102 @@ auto executeOnClientFor(size_t ft, typename tao::json::basic_value<Traits> &o, C
     return fnc[ft](o, c);
 }
 
+/*
+ * A constrained (bound payload) message whose flat payload is a tuple ends with the value
+ * it sets; everything before that names the target. Two such messages with the same id
+ * and the same target bytes set the same thing, so only the later one needs to run.
+ * The table holds the size of that trailing value, or 0 if a message never coalesces.
+ */
+template <size_t I> constexpr uint8_t coalescedValueBytes()
+{
+    typedef typename ClientToSerializationType<(ClientToSerializationMessagesIds)I>::T handler_t;
+    if constexpr (std::is_same<handler_t, unimpl_t>::value)
+    {
+        return 0;
+    }
+    else if constexpr (!handler_t::hasBoundPayload ||
+                       !FlatLayout<typename handler_t::c2s_payload_t>::value)
+    {
+        return 0;
+    }
+    else
+    {
+        typedef typename handler_t::c2s_payload_t payload_t;
+        if constexpr (isFlatScalar<payload_t>::value)
+        {
+            return 0;
+        }
+        else
+        {
+            constexpr auto n = std::tuple_size_v<payload_t>;
+            return (uint8_t)sizeof(std::tuple_element_t<n - 1, payload_t>);
+        }
+    }
+}
+
+template <size_t... Is>
+constexpr std::array<uint8_t, sizeof...(Is)> coalescedValueBytesTable(std::index_sequence<Is...>)
+{
+    return {coalescedValueBytes<Is>()...};
+}
+
+template <typename T> struct FlatBytes
+{
+    static constexpr uint32_t value{sizeof(T)};
+};
+template <typename... Ts> struct FlatBytes<std::tuple<Ts...>>
+{
+    static constexpr uint32_t value{(sizeof(Ts) + ... + 0)};
+};
+template <typename A, typename B> struct FlatBytes<std::pair<A, B>>
+{
+    static constexpr uint32_t value{sizeof(A) + sizeof(B)};
+};
+
+/*
+ * For each client to serialization message, 0 if we don't handle it, otherwise 1 plus
+ * the size of its flat payload, or 1 if it never goes flat.
+ */
+template <size_t I> constexpr uint32_t inboundPayloadBytes()
+{
+    typedef typename ClientToSerializationType<(ClientToSerializationMessagesIds)I>::T handler_t;
+    if constexpr (std::is_same<handler_t, unimpl_t>::value)
+    {
+        return 0;
+    }
+    else if constexpr (!FlatLayout<typename handler_t::c2s_payload_t>::value)
+    {
+        return 1;
+    }
+    else
+    {
+        return 1 + FlatBytes<typename handler_t::c2s_payload_t>::value;
+    }
+}
+
+template <size_t... Is>
+constexpr std::array<uint32_t, sizeof...(Is)> inboundPayloadBytesTable(std::index_sequence<Is...>)
+{
+    return {inboundPayloadBytes<Is>()...};
+}
 } // namespace detail
 
 template <typename T>
 inline void clientSendToSerialization(const T &msg, messaging::MessageController &mc)
 {
     assert(mc.threadingChecker.isClientThread());
-    auto mw = detail::MessageWrapper(msg);
-    detail::client_message_value v = mw;
-    auto res = encoder::to_string(v);
+    auto t0 = mc.latencyTrace.start();
+    auto encode = [&]() {
+        if (detail::useFlatFrame<typename T::c2s_payload_t>(mc))
+            return detail::flatFrame((int32_t)T::c2s_id, msg.payload);
 
-    mc.sendRawFromClient(res);
+        auto mw = detail::MessageWrapper(msg);
+        detail::client_message_value v = mw;
+        return detail::encodeValue(v, mc);
+    };
+    auto encoded = encode();
+    mc.latencyTrace.recordSince(LatencyTrace::CLIENT_ENCODE, (int32_t)T::c2s_id, t0);
+    mc.sendRawFromClient(encoded);
 }
 
 template <typename T>
@@ -178,24 +438,33 @@ inline void serializationSendToClient(SerializationToClientMessageIds id, const
 
     try
     {
+        auto encode = [&]() {
+            if (detail::useFlatFrame<T>(mc))
+                return detail::flatFrame((int32_t)id, msg);
+
+            auto mw = detail::ResponseWrapper<T>(msg, id);
+            detail::client_message_value v = mw;
+            return detail::encodeValue(v, mc);
+        };
+
+        // Anything of this kind still held for the next frame is older, so goes first
+        if (!mc.outboundCoalescer.empty())
+            mc.outboundCoalescer.flushId((int32_t)id);
+
         auto lk = mc.acquireClientCallbackMutex();
         // TODO - consider waht to do here. Dropping the message is probably best
         if (!mc.clientCallback)
         {
             if (cacheSerializationMessagesAbsentClient(id))
             {
-                auto mw = detail::ResponseWrapper<T>(msg, id);
-                detail::client_message_value v = mw;
-                auto res = encoder::to_string(v);
-                mc.preClientConnectionCache.push_back(res);
+                mc.preClientConnectionCache.push_back(encode());
             }
             return;
         }
 
-        auto mw = detail::ResponseWrapper<T>(msg, id);
-        detail::client_message_value v = mw;
-        auto res = encoder::to_string(v);
-        mc.clientCallback(res);
+        auto t0 = mc.latencyTrace.start();
+        mc.clientCallback(encode());
+        mc.latencyTrace.recordSince(LatencyTrace::S2C_SEND, (int32_t)id, t0);
     }
     catch (const std::exception &e)
     {
@@ -206,45 +475,178 @@ inline void serializationSendToClient(SerializationToClientMessageIds id, const
     }
 }
 
+template <typename T>
+inline void serializationSendToClientCoalesced(SerializationToClientMessageIds id, uint64_t address,
+                                               const T &msg, messaging::MessageController &mc)
+{
+    assert(mc.threadingChecker.isSerialThread());
+    mc.outboundCoalescer.add((int32_t)id, address,
+                             [id, msg, &mc]() { serializationSendToClient(id, msg, mc); });
+}
+
 inline void serializationThreadExecuteClientMessage(const std::string &msgView, engine::Engine &e,
                                                     MessageController &mc)
 {
     assert(mc.threadingChecker.isSerialThread());
-    using namespace tao::json;
 
-    // We need to unpack with the client message traits
-    events::transformer<events::to_basic_value<detail::client_message_traits>> consumer;
-    encoder::events::from_string(consumer, msgView);
-    auto jv = std::move(consumer.value);
+    if (detail::isFlatFrame(msgView))
+    {
+        auto idv = detail::flatFrameId(msgView);
+        if (idv < 0 ||
+            idv >= (int)ClientToSerializationMessagesIds::num_clientToSerializationMessages)
+            return;
+        mc.currentInboundMessageId = idv;
+        detail::executeFlatOnSerializationFor(
+            (size_t)idv, msgView, e, mc,
+            std::make_index_sequence<(
+                size_t)ClientToSerializationMessagesIds::num_clientToSerializationMessages>());
+        return;
+    }
 
-    auto o = jv.get_object();
-    int idv{-1};
-    o["id"].to(idv);
+    try
+    {
+        auto jv = detail::decodeValue(msgView);
+
+        auto o = jv.get_object();
+        int idv{-1};
+        o["id"].to(idv);
+        if (idv < 0 ||
+            idv >= (int)ClientToSerializationMessagesIds::num_clientToSerializationMessages)
+            return;
+        mc.currentInboundMessageId = idv;
+
+        detail::executeOnSerializationFor(
+            (ClientToSerializationMessagesIds)idv, jv, e, mc,
+            std::make_index_sequence<(
+                size_t)ClientToSerializationMessagesIds::num_clientToSerializationMessages>());
+    }
+    catch (const std::exception &err)
+    {
+        RAISE_ERROR_CONT(mc, "Client Message Error", err.what());
+    }
+}
+
+inline bool isWellFormedClientMessage(const std::string &msg)
+{
+    static constexpr auto payloadBytes = detail::inboundPayloadBytesTable(std::make_index_sequence<(
+        size_t)ClientToSerializationMessagesIds::num_clientToSerializationMessages>());
+
+    if (detail::isFlatFrame(msg))
+    {
+        auto idv = detail::flatFrameId(msg);
+        if (idv < 0 || idv >= (int)payloadBytes.size() || payloadBytes[idv] <= 1)
+            return false;
+        return msg.size() == sizeof(int32_t) + payloadBytes[idv];
+    }
 
-    detail::executeOnSerializationFor(
-        (ClientToSerializationMessagesIds)idv, jv, e, mc,
-        std::make_index_sequence<(
-            size_t)ClientToSerializationMessagesIds::num_clientToSerializationMessages>());
+    try
+    {
+        auto jv = detail::decodeValue(msg);
+        if (!jv.is_object())
+            return false;
+        auto *id = jv.find("id");
+        if (!id || !id->is_integer() || !jv.find("object"))
+            return false;
+        int64_t idv{-1};
+        id->to(idv);
+        return idv >= 0 && idv < (int64_t)payloadBytes.size() && payloadBytes[idv] > 0;
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+}
+
+inline size_t coalesceClientMessages(std::vector<InboundMessage> &batch)
+{
+    static constexpr auto valueBytes = detail::coalescedValueBytesTable(std::make_index_sequence<(
+        size_t)ClientToSerializationMessagesIds::num_clientToSerializationMessages>());
+    static constexpr size_t headerBytes{1 + sizeof(int32_t)};
+
+    if (batch.size() < 2)
+        return 0;
+
+    // Walk backwards so the last write to each target is the one we see first. Any
+    // message which doesn't coalesce (a selection change, a structure edit, a JSON
+    // frame) is a barrier, since the same bytes may name a different target after it.
+    std::vector<bool> keep(batch.size(), true);
+    std::unordered_set<std::string_view> seen;
+    size_t dropped{0};
+    for (auto i = batch.size(); i-- > 0;)
+    {
+        const auto &m = batch[i].msg;
+        size_t vb{0};
+        if (detail::isFlatFrame(m))
+        {
+            auto idv = detail::flatFrameId(m);
+            if (idv >= 0 && idv < (int)valueBytes.size())
+                vb = valueBytes[idv];
+        }
+        if (vb == 0 || m.size() < headerBytes + vb)
+        {
+            seen.clear();
+            continue;
+        }
+        if (!seen.insert(std::string_view(m.data(), m.size() - vb)).second)
+        {
+            keep[i] = false;
+            dropped++;
+        }
+    }
+
+    if (dropped)
+    {
+        size_t w{0};
+        for (size_t r = 0; r < batch.size(); ++r)
+        {
+            if (keep[r])
+            {
+                if (w != r)
+                    batch[w] = std::move(batch[r]);
+                w++;
+            }
+        }
+        batch.resize(w);
+    }
+    return dropped;
 }
 
 template <typename Client>
 inline void clientThreadExecuteSerializationMessage(const std::string &msgView, Client *c)
 {
-    using namespace tao::json;
+    if (detail::isFlatFrame(msgView))
+    {
+        auto idv = detail::flatFrameId(msgView);
+        if (idv < 0 ||
+            idv >= (int)SerializationToClientMessageIds::num_serializationToClientMessages)
+            return;
+        detail::executeFlatOnClientFor(
+            (size_t)idv, msgView, c,
+            std::make_index_sequence<(
+                size_t)SerializationToClientMessageIds::num_serializationToClientMessages>());
+        return;
+    }
 
-    // We need to unpack with the client message traits
-    events::transformer<events::to_basic_value<detail::client_message_traits>> consumer;
-    encoder::events::from_string(consumer, msgView);
-    auto jv = std::move(consumer.value);
+    try
+    {
+        auto jv = detail::decodeValue(msgView);
 
-    auto o = jv.get_object();
-    int idv{-1};
-    o["id"].to(idv);
+        auto o = jv.get_object();
+        int idv{-1};
+        o["id"].to(idv);
+        if (idv < 0 ||
+            idv >= (int)SerializationToClientMessageIds::num_serializationToClientMessages)
+            return;
 
-    detail::executeOnClientFor(
-        (SerializationToClientMessageIds)idv, jv, c,
-        std::make_index_sequence<(
-            size_t)SerializationToClientMessageIds::num_serializationToClientMessages>());
+        detail::executeOnClientFor(
+            (SerializationToClientMessageIds)idv, jv, c,
+            std::make_index_sequence<(
+                size_t)SerializationToClientMessageIds::num_serializationToClientMessages>());
+    }
+    catch (const std::exception &err)
+    {
+        SCLOG_IF(warnings, "Dropping a serialization message which didn't decode: " << err.what());
+    }
 }
 
 } // namespace scxt::messaging::client
@@ -68,6 +68,14 @@ updateZoneLeadMemberValue(M m, const diffMsg_t<VT> &payload, const engine::Engin
                 {
                     *(VT *)(((uint8_t *)&dat) + d) = v;
                 }
+                if constexpr (std::is_same_v<M, decltype(&engine::Zone::mapping)>)
+                {
+                    eng.getPatch()->getPart(p)->markZoneLookupDirty();
+                }
+                if constexpr (std::is_same_v<M, decltype(&engine::Zone::variantData)>)
+                {
+                    zn->markVoiceStartDescriptorsDirty();
+                }
             },
             responseCB);
     }
@@ -107,6 +115,14 @@ inline void updateZoneMemberValue(M m, const diffMsg_t<VT> &payload, const engin
                     {
                         *(VT *)(((uint8_t *)&dat) + d) = v;
                     }
+                    if constexpr (std::is_same_v<M, decltype(&engine::Zone::mapping)>)
+                    {
+                        eng.getPatch()->getPart(p)->markZoneLookupDirty();
+                    }
+                    if constexpr (std::is_same_v<M, decltype(&engine::Zone::variantData)>)
+                    {
+                        zn->markVoiceStartDescriptorsDirty();
+                    }
                 }
             },
             responseCB);
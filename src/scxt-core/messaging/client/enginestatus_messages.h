@@ -160,6 +160,64 @@ using omniFlavorUpdate_t = std::pair<int, bool>;
 SERIAL_TO_CLIENT(UpdateOmniFlavor, s2c_update_omni_flavor, omniFlavorUpdate_t,
                  onOmniFlavorFromEngine);
 
+// Per size class: block size, reserved blocks, free blocks, outstanding, high watermark,
+// fallback grows, reserved bytes, owner processor bitmask
+using memoryPoolClassStats_t =
+    std::tuple<int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, int64_t, uint64_t>;
+// total pool bytes, fallback allocations, classes
+using memoryPoolStats_t = std::tuple<int64_t, int64_t, std::vector<memoryPoolClassStats_t>>;
+SERIAL_TO_CLIENT(SendMemoryPoolStats, s2c_send_memory_pool_stats, memoryPoolStats_t,
+                 onMemoryPoolStats);
+
+inline void doRequestMemoryPoolStats(engine::Engine &engine, MessageController &cont)
+{
+    auto &pool = engine.getMemoryPool();
+    memoryPoolStats_t res;
+    std::get<0>(res) = (int64_t)pool->getReservedBytes();
+    std::get<1>(res) = (int64_t)pool->getFallbackAllocations();
+    for (const auto &s : pool->getStats())
+    {
+        std::get<2>(res).emplace_back((int64_t)s.blockSize, (int64_t)s.reservedBlocks,
+                                      (int64_t)s.freeBlocks, (int64_t)s.outstanding,
+                                      (int64_t)s.highWatermark, (int64_t)s.fallbackGrows,
+                                      (int64_t)s.reservedBytes, s.ownerBits);
+    }
+    serializationSendToClient(s2c_send_memory_pool_stats, res, cont);
+}
+CLIENT_TO_SERIAL(RequestMemoryPoolStats, c2s_request_memory_pool_stats, bool,
+                 doRequestMemoryPoolStats(engine, cont));
+
+// Turning tracing on clears whatever an earlier trace left behind
+inline void doSetLatencyTracing(bool enable, MessageController &cont)
+{
+    if (enable && !cont.latencyTrace.enabled)
+        cont.latencyTrace.reset();
+    cont.latencyTrace.enabled = enable;
+}
+CLIENT_TO_SERIAL(SetLatencyTracing, c2s_set_latency_tracing, bool,
+                 doSetLatencyTracing(payload, cont));
+
+using latencyReport_t = LatencyTrace::report_t;
+SERIAL_TO_CLIENT(SendLatencyReport, s2c_send_latency_report, latencyReport_t, onLatencyReport);
+
+// Payload is whether to start over after reporting
+inline void doRequestLatencyReport(bool reset, MessageController &cont)
+{
+    serializationSendToClient(s2c_send_latency_report, cont.latencyTrace.report(), cont);
+    if (reset)
+        cont.latencyTrace.reset();
+}
+CLIENT_TO_SERIAL(RequestLatencyReport, c2s_request_latency_report, bool,
+                 doRequestLatencyReport(payload, cont));
+
+// The client's repaint rate in Hz, which paces coalesced updates back to it
+inline void doSetClientFrameRate(int32_t hz, MessageController &cont)
+{
+    cont.outboundCoalescer.setFrameRate(hz);
+}
+CLIENT_TO_SERIAL(SetClientFrameRate, c2s_set_client_frame_rate, int32_t,
+                 doSetClientFrameRate(payload, cont));
+
 } // namespace scxt::messaging::client
 
 #endif // SHORTCIRCUIT_ENGINESTATUS_MESSAGES_H
@@ -115,7 +115,7 @@ CLIENT_TO_SERIAL(UpdateGroupOutputInfoMidiChannel, c2s_update_group_output_info_
                  doUpdateGroupOutputInfoMidiChannel(payload, engine, cont));
 
 using muteOrSoloGroup_t = std::tuple<int32_t, int32_t, bool, bool, bool>; // p, g, m, s, selected
-inline void doMuteOrSoloGroup(const muteOrSoloGroup_t &payload, const engine::Engine &engine,
+inline void doMuteOrSoloGroup(const muteOrSoloGroup_t &payload, engine::Engine &engine,
                               messaging::MessageController &cont)
 {
     auto &[p, g, m, s, sel] = payload;
@@ -150,8 +150,7 @@ inline void doMuteOrSoloGroup(const muteOrSoloGroup_t &payload, const engine::En
             }
         },
         [](auto &engine) {
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *engine.getMessageController());
+            engine.sendPartGroupZoneStructureToClient();
         });
 }
 CLIENT_TO_SERIAL(MuteOrSoloGroup, c2s_mute_solo_group, muteOrSoloGroup_t,
@@ -236,17 +236,17 @@ inline void doRenameGroup(const renameGroupZonePayload_t &payload, engine::Engin
     engine.undoManager.storeUndoStep(std::move(undoItem));
 
     engine.getPatch()->getPart(p)->getGroup(g)->name = std::get<1>(payload);
-    serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(), cont);
+    engine.sendPartGroupZoneStructureToClient();
 }
 CLIENT_TO_SERIAL(RenameGroup, c2s_rename_group, renameGroupZonePayload_t,
                  doRenameGroup(payload, engine, cont));
 
-inline void doRenameZone(const renameGroupZonePayload_t &payload, const engine::Engine &engine,
+inline void doRenameZone(const renameGroupZonePayload_t &payload, engine::Engine &engine,
                          MessageController &cont)
 {
     const auto &[p, g, z] = std::get<0>(payload);
     engine.getPatch()->getPart(p)->getGroup(g)->getZone(z)->givenName = std::get<1>(payload);
-    serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(), cont);
+    engine.sendPartGroupZoneStructureToClient();
     serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                               engine.getPatch()->getPart(p)->getZoneMappingSummary(),
                               *(engine.getMessageController()));
@@ -40,15 +40,19 @@ namespace scxt::messaging::client
  * Send the full structure of all groups and zones or for a single part
  * in a single message
  */
-inline void pgzSerialSide(const int &partNum, const engine::Engine &engine, MessageController &cont)
+inline void pgzSerialSide(const int &partNum, engine::Engine &engine, MessageController &cont)
 {
-    serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(), cont);
+    // An explicit request is a client which has lost track, so always send it all
+    engine.sendPartGroupZoneStructureToClient(true);
 }
 
 CLIENT_SERIAL_REQUEST_RESPONSE(PartGroupZoneStructure, c2s_request_pgz_structure, int32_t,
-                               s2c_send_pgz_structure, engine::Engine::pgzStructure_t,
+                               s2c_send_pgz_structure, engine::Engine::pgzVersionedStructure_t,
                                pgzSerialSide(payload, engine, cont), onStructureUpdated);
 
+SERIAL_TO_CLIENT(SendPartGroupZoneStructureDelta, s2c_send_pgz_structure_delta,
+                 engine::Engine::pgzStructureDelta_t, onStructureDelta);
+
 SERIAL_TO_CLIENT(SendAllProcessorDescriptions, s2c_send_all_processor_descriptions,
                  std::vector<dsp::processor::ProcessorDescription>, onAllProcessorDescriptions);
 
@@ -161,8 +165,7 @@ inline void createGroupIn(int partNumber, engine::Engine &engine, MessageControl
         [p = partNumber](auto &e) { e.getPatch()->getPart(p)->addGroup(); },
         [p = partNumber](auto &engine) {
             SCLOG_IF(groupZoneMutation, "Responding with part group zone structure in " << p);
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *(engine.getMessageController()));
+            engine.sendPartGroupZoneStructureToClient();
 
             serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                                       engine.getPatch()->getPart(p)->getZoneMappingSummary(),
@@ -196,8 +199,7 @@ inline void removeZone(const selection::SelectionManager::ZoneAddress &a, engine
         [t = a](auto &engine) {
             engine.getSampleManager()->purgeUnreferencedSamples();
             engine.getSelectionManager()->guaranteeConsistencyAfterDeletes(engine, true, t);
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *(engine.getMessageController()));
+            engine.sendPartGroupZoneStructureToClient();
             serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                                       engine.getPatch()->getPart(t.part)->getZoneMappingSummary(),
                                       *(engine.getMessageController()));
@@ -259,8 +261,7 @@ inline void removeSelectedZones(const bool &, engine::Engine &engine, MessageCon
             engine.getSelectionManager()->guaranteeConsistencyAfterDeletes(engine, true,
                                                                            {t, -1, -1});
 
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *(engine.getMessageController()));
+            engine.sendPartGroupZoneStructureToClient();
             serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                                       engine.getPatch()->getPart(t)->getZoneMappingSummary(),
                                       *(engine.getMessageController()));
@@ -304,8 +305,7 @@ inline void deleteGroupHandler(const selection::SelectionManager::ZoneAddress &a
             engine.getSampleManager()->purgeUnreferencedSamples();
             engine.getSelectionManager()->guaranteeConsistencyAfterDeletes(engine, false, t);
 
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *(engine.getMessageController()));
+            engine.sendPartGroupZoneStructureToClient();
             serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                                       engine.getPatch()->getPart(t.part)->getZoneMappingSummary(),
                                       *(engine.getMessageController()));
@@ -339,8 +339,7 @@ inline void clearPart(const int p, engine::Engine &engine, MessageController &co
             engine.getSelectionManager()->guaranteeConsistencyAfterDeletes(engine, false,
                                                                            {pt, -1, -1});
 
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *(engine.getMessageController()));
+            engine.sendPartGroupZoneStructureToClient();
             serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                                       engine.getPatch()->getPart(pt)->getZoneMappingSummary(),
                                       *(engine.getMessageController()));
@@ -442,8 +441,7 @@ inline void moveZonesFromTo(const zoneAddressFromTo_t &payload, engine::Engine &
                 }
             }
 
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *(engine.getMessageController()));
+            engine.sendPartGroupZoneStructureToClient();
             serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                                       engine.getPatch()->getPart(t.part)->getZoneMappingSummary(),
                                       *(engine.getMessageController()));
@@ -486,8 +484,7 @@ inline void moveGroupTo(const moveGroupAddress_t &payload, engine::Engine &engin
             }
         },
         [tt = tgt](auto &engine) {
-            serializationSendToClient(s2c_send_pgz_structure, engine.getPartGroupZoneStructure(),
-                                      *(engine.getMessageController()));
+            engine.sendPartGroupZoneStructureToClient();
             serializationSendToClient(s2c_send_selected_group_zone_mapping_summary,
                                       engine.getPatch()->getPart(tt.part)->getZoneMappingSummary(),
                                       *(engine.getMessageController()));
@@ -511,7 +508,7 @@ inline void doActivateNextPart(messaging::MessageController &cont)
                 }
             }
         },
-        [](const auto &e) { e.sendFullRefreshToClient(); });
+        [](auto &e) { e.sendFullRefreshToClient(); });
 }
 CLIENT_TO_SERIAL(ActivateNextPart, c2s_activate_next_part, bool, doActivateNextPart(cont));
 
@@ -532,7 +529,7 @@ inline void doDeactivatePart(int part, messaging::MessageController &cont)
                 e.getPatch()->getPart(0)->configuration.active = true;
             }
         },
-        [part](const auto &e) {
+        [part](auto &e) {
             if (e.getSelectionManager()->selectedPart == part)
             {
                 int tpt{0}, spt{-1};
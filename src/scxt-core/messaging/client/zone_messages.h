@@ -60,6 +60,7 @@ inline void doUpdateLeadZoneMapping(const engine::Zone::ZoneMappingData &payload
             [zs = *sz, mapv = mapping](auto &eng) {
                 auto [p, g, z] = zs;
                 eng.getPatch()->getPart(p)->getGroup(g)->getZone(z)->mapping = mapv;
+                eng.getPatch()->getPart(p)->markZoneLookupDirty();
             },
             [p = sz->part](const auto &eng) {
                 serializationSendToClient(
@@ -150,6 +151,7 @@ inline void doApplyZoneDelta(const applyZoneDeltaPayload_t &payload, const engin
                     }
                 }
             }
+            eng.getPatch()->getPart(pt)->markZoneLookupDirty();
         });
     }
 }
@@ -199,7 +201,9 @@ inline void doUpdateLeadZoneSingleVariant(const updateLeadZoneSingleVariantPaylo
         auto [ps, gs, zs] = *sz;
         cont.scheduleAudioThreadCallback([p = ps, g = gs, z = zs, sampv = samples](auto &eng) {
             auto &[idx, smp] = sampv;
-            eng.getPatch()->getPart(p)->getGroup(g)->getZone(z)->variantData.variants[idx] = smp;
+            auto &zn = eng.getPatch()->getPart(p)->getGroup(g)->getZone(z);
+            zn->variantData.variants[idx] = smp;
+            zn->markVoiceStartDescriptorsDirty();
         });
     }
 }
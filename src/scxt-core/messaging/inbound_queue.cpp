@@ -0,0 +1,128 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "inbound_queue.h"
+
+namespace scxt::messaging
+{
+InboundQueue::InboundQueue() : head(&stub), tail(&stub) {}
+
+InboundQueue::~InboundQueue()
+{
+    InboundMessage discard;
+    while (pop(discard))
+    {
+    }
+}
+
+void InboundQueue::pushNode(Node *n)
+{
+    n->next.store(nullptr, std::memory_order_relaxed);
+    auto prev = head.exchange(n, std::memory_order_seq_cst);
+    // Between the exchange and this store the list is briefly disconnected; the
+    // consumer sees that as "not empty but nothing to pop yet" and retries
+    prev->next.store(n, std::memory_order_release);
+}
+
+void InboundQueue::push(InboundMessage &&msg)
+{
+    auto n = new Node();
+    n->msg = std::move(msg);
+    pushNode(n);
+
+    if (consumerSleeping.load(std::memory_order_seq_cst))
+    {
+        {
+            std::lock_guard<std::mutex> g(sleepMutex);
+            wakePending = true;
+        }
+        sleepConditionVar.notify_one();
+    }
+}
+
+bool InboundQueue::pop(InboundMessage &msg)
+{
+    auto t = tail;
+    auto next = t->next.load(std::memory_order_acquire);
+    if (t == &stub)
+    {
+        if (!next)
+            return false;
+        tail = next;
+        t = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if (next)
+    {
+        tail = next;
+        msg = std::move(t->msg);
+        delete t;
+        return true;
+    }
+
+    // t is the last linked node. If a producer has already swapped head past it we
+    // have to wait for the link; otherwise put the stub back behind it so t can go.
+    if (t != head.load(std::memory_order_acquire))
+        return false;
+
+    pushNode(&stub);
+    next = t->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        tail = next;
+        msg = std::move(t->msg);
+        delete t;
+        return true;
+    }
+    return false;
+}
+
+bool InboundQueue::maybeHasMessages() const
+{
+    return !(tail == &stub && head.load(std::memory_order_seq_cst) == &stub);
+}
+
+void InboundQueue::waitFor(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    consumerSleeping.store(true, std::memory_order_seq_cst);
+    // A push between our last look and the flag going up would not signal, so look again
+    if (!wakePending && !maybeHasMessages())
+        sleepConditionVar.wait_for(lock, timeout, [this]() { return wakePending; });
+    wakePending = false;
+    consumerSleeping.store(false, std::memory_order_relaxed);
+}
+
+void InboundQueue::wakeConsumer()
+{
+    {
+        std::lock_guard<std::mutex> g(sleepMutex);
+        wakePending = true;
+    }
+    sleepConditionVar.notify_all();
+}
+} // namespace scxt::messaging
@@ -0,0 +1,93 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_MESSAGING_INBOUND_QUEUE_H
+#define SCXT_SRC_SCXT_CORE_MESSAGING_INBOUND_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "utils.h"
+
+namespace scxt::messaging
+{
+struct InboundMessage
+{
+    std::string msg;
+    // Zero unless latency tracing is on
+    std::chrono::steady_clock::time_point enqueued{};
+};
+
+/*
+ * Client to serialization messages arrive from the UI thread, and also from the browser
+ * scanner and writer threads. Producers link onto an intrusive multi-producer single
+ * consumer list with a single atomic exchange, so they never wait on each other or on
+ * the serialization thread draining the queue.
+ *
+ * Wakeups go through a condition variable, but only when the serialization thread has
+ * said it is about to sleep. A busy serialization thread is never signalled, and a
+ * producer only touches the mutex on the idle to busy transition.
+ */
+struct InboundQueue : MoveableOnly<InboundQueue>
+{
+    InboundQueue();
+    ~InboundQueue();
+
+    // Any thread
+    void push(InboundMessage &&msg);
+
+    // Consumer (serialization thread) only
+    bool pop(InboundMessage &msg);
+    bool maybeHasMessages() const;
+    void waitFor(std::chrono::milliseconds timeout);
+
+    // Any thread. Wakes a sleeping consumer without a message, for shutdown
+    void wakeConsumer();
+
+  private:
+    struct Node
+    {
+        std::atomic<Node *> next{nullptr};
+        InboundMessage msg;
+    };
+    void pushNode(Node *n);
+
+    std::atomic<Node *> head;
+    Node *tail{nullptr};
+    Node stub;
+
+    std::atomic<bool> consumerSleeping{false};
+    bool wakePending{false};
+    std::mutex sleepMutex;
+    std::condition_variable sleepConditionVar;
+};
+} // namespace scxt::messaging
+
+#endif // SCXT_SRC_SCXT_CORE_MESSAGING_INBOUND_QUEUE_H
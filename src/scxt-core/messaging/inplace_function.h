@@ -0,0 +1,122 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_MESSAGING_INPLACE_FUNCTION_H
+#define SCXT_SRC_SCXT_CORE_MESSAGING_INPLACE_FUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace scxt::messaging
+{
+/*
+ * A callable holder with a fixed inline buffer, used by the audio thread callback pool.
+ * Callables which fit (most of our lambdas capture a few ids and a value) are
+ * constructed in place, so setting one doesn't touch the allocator. Larger ones fall
+ * back to the heap. Either way the object is only set and reset on the serialization
+ * thread; the audio thread just invokes it.
+ *
+ * Unlike std::function this is neither copyable nor movable. It lives in a pool slot.
+ */
+template <typename Sig, size_t Capacity = 64> class InplaceFunction;
+
+template <typename R, typename... Args, size_t Capacity>
+class InplaceFunction<R(Args...), Capacity>
+{
+  public:
+    InplaceFunction() = default;
+    InplaceFunction(const InplaceFunction &) = delete;
+    InplaceFunction &operator=(const InplaceFunction &) = delete;
+    ~InplaceFunction() { reset(); }
+
+    template <typename F> static bool isEmptyCallable(const F &f)
+    {
+        if constexpr (std::is_same_v<std::decay_t<F>, std::nullptr_t>)
+            return true;
+        else if constexpr (std::is_constructible_v<bool, const F &>)
+            return !static_cast<bool>(f);
+        else
+            return false;
+    }
+
+    template <typename F> void set(F &&f)
+    {
+        reset();
+        using D = std::decay_t<F>;
+        if constexpr (std::is_same_v<D, std::nullptr_t>)
+        {
+            return;
+        }
+        else if (isEmptyCallable(f))
+        {
+            return;
+        }
+        else if constexpr (fitsInline<D>())
+        {
+            new (storage) D(std::forward<F>(f));
+            invoker = [](void *p, Args... a) -> R {
+                return (*static_cast<D *>(p))(std::forward<Args>(a)...);
+            };
+            destroyer = [](void *p) { static_cast<D *>(p)->~D(); };
+        }
+        else
+        {
+            new (storage) D *(new D(std::forward<F>(f)));
+            invoker = [](void *p, Args... a) -> R {
+                return (**static_cast<D **>(p))(std::forward<Args>(a)...);
+            };
+            destroyer = [](void *p) { delete *static_cast<D **>(p); };
+        }
+    }
+
+    void reset()
+    {
+        if (destroyer)
+            destroyer(storage);
+        invoker = nullptr;
+        destroyer = nullptr;
+    }
+
+    explicit operator bool() const { return invoker != nullptr; }
+    R operator()(Args... a) { return invoker(storage, std::forward<Args>(a)...); }
+
+    template <typename D> static constexpr bool fitsInline()
+    {
+        return sizeof(D) <= Capacity && alignof(D) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<D>;
+    }
+
+  private:
+    alignas(std::max_align_t) unsigned char storage[Capacity];
+    R (*invoker)(void *, Args...){nullptr};
+    void (*destroyer)(void *){nullptr};
+};
+} // namespace scxt::messaging
+
+#endif // SCXT_SRC_SCXT_CORE_MESSAGING_INPLACE_FUNCTION_H
@@ -0,0 +1,159 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "latency_trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace scxt::messaging
+{
+const char *LatencyTrace::hopName(Hop h)
+{
+    switch (h)
+    {
+    case CLIENT_ENCODE:
+        return "client encode";
+    case INBOUND_QUEUE:
+        return "inbound queue";
+    case SERIAL_EXECUTE:
+        return "serial execute";
+    case AUDIO_ROUND_TRIP:
+        return "audio round trip";
+    case S2C_SEND:
+        return "s2c send";
+    case numHops:
+        break;
+    }
+    return "unknown";
+}
+
+void LatencyTrace::setup(size_t clientToSerialIds, size_t serialToClientIds)
+{
+    for (int h = 0; h < numHops; ++h)
+    {
+        auto n = h == S2C_SEND ? serialToClientIds : clientToSerialIds;
+        histograms[h] = std::make_unique<Histogram[]>(n);
+        histogramCount[h] = n;
+    }
+}
+
+void LatencyTrace::record(Hop h, int32_t id, clock_t::duration d)
+{
+    if (id < 0 || (size_t)id >= histogramCount[h])
+        return;
+    auto &hi = histograms[h][id];
+    auto ns = (uint64_t)std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+
+    // bucket 0 is under a microsecond, bucket b is [2^(b-1), 2^b) microseconds
+    size_t b{0};
+    for (auto us = ns / 1000; us > 0 && b < numBuckets - 1; us >>= 1)
+        b++;
+
+    hi.buckets[b].fetch_add(1, std::memory_order_relaxed);
+    hi.count.fetch_add(1, std::memory_order_relaxed);
+    hi.totalNs.fetch_add(ns, std::memory_order_relaxed);
+    auto prior = hi.maxNs.load(std::memory_order_relaxed);
+    while (ns > prior && !hi.maxNs.compare_exchange_weak(prior, ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyTrace::reset()
+{
+    for (int h = 0; h < numHops; ++h)
+    {
+        for (size_t i = 0; i < histogramCount[h]; ++i)
+        {
+            auto &hi = histograms[h][i];
+            for (auto &b : hi.buckets)
+                b = 0;
+            hi.count = 0;
+            hi.totalNs = 0;
+            hi.maxNs = 0;
+        }
+    }
+}
+
+LatencyTrace::report_t LatencyTrace::report() const
+{
+    report_t res;
+    for (int h = 0; h < numHops; ++h)
+    {
+        for (size_t i = 0; i < histogramCount[h]; ++i)
+        {
+            const auto &hi = histograms[h][i];
+            auto ct = hi.count.load(std::memory_order_relaxed);
+            if (ct == 0)
+                continue;
+
+            std::array<uint32_t, numBuckets> bk;
+            uint64_t inBuckets{0};
+            for (size_t b = 0; b < numBuckets; ++b)
+            {
+                bk[b] = hi.buckets[b].load(std::memory_order_relaxed);
+                inBuckets += bk[b];
+            }
+            auto pct = [&](double p) {
+                auto target = (uint64_t)(p * inBuckets);
+                uint64_t seen{0};
+                for (size_t b = 0; b < numBuckets; ++b)
+                {
+                    seen += bk[b];
+                    if (seen > target)
+                        return (double)(1ULL << b);
+                }
+                return (double)(1ULL << (numBuckets - 1));
+            };
+
+            res.emplace_back(h, (int32_t)i, (int64_t)ct,
+                             hi.totalNs.load(std::memory_order_relaxed) / 1000.0 / ct, pct(0.5),
+                             pct(0.99), hi.maxNs.load(std::memory_order_relaxed) / 1000.0);
+        }
+    }
+    return res;
+}
+
+std::string LatencyTrace::formatReport(const report_t &r)
+{
+    std::ostringstream oss;
+    oss << "Message latency (us; percentiles are bucket upper bounds)\n";
+    char line[256];
+    snprintf(line, sizeof(line), "%-18s %5s %8s %10s %8s %8s %10s\n", "hop", "id", "count",
+             "mean", "p50", "p99", "max");
+    oss << line;
+    for (const auto &[h, id, ct, mean, p50, p99, mx] : r)
+    {
+        snprintf(line, sizeof(line), "%-18s %5d %8lld %10.1f %8.0f %8.0f %10.1f\n",
+                 hopName((Hop)h), (int)id, (long long)ct, mean, p50, p99, mx);
+        oss << line;
+    }
+    return oss.str();
+}
+} // namespace scxt::messaging
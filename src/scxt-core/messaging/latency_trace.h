@@ -0,0 +1,111 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_MESSAGING_LATENCY_TRACE_H
+#define SCXT_SRC_SCXT_CORE_MESSAGING_LATENCY_TRACE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "utils.h"
+
+namespace scxt::messaging
+{
+/*
+ * Per message id latency histograms for each hop a message takes through the
+ * MessageController. When tracing is off the only cost is checking the flag.
+ *
+ * Hops are keyed by the client to serialization id, apart from S2C_SEND which is
+ * keyed by the serialization to client id. AUDIO_ROUND_TRIP runs from scheduling an
+ * audio thread callback to its completion arriving back on the serialization thread,
+ * charged to the inbound message which scheduled it.
+ *
+ * Buckets are powers of two in microseconds, so percentiles are upper bounds
+ * good to a factor of two. That's enough to see which hop is eating the time.
+ */
+struct LatencyTrace : MoveableOnly<LatencyTrace>
+{
+    enum Hop : int32_t
+    {
+        CLIENT_ENCODE,
+        INBOUND_QUEUE,
+        SERIAL_EXECUTE,
+        AUDIO_ROUND_TRIP,
+        S2C_SEND,
+
+        numHops
+    };
+    static const char *hopName(Hop h);
+
+    using clock_t = std::chrono::steady_clock;
+    static constexpr size_t numBuckets{28};
+
+    // hop, id, count, mean us, p50 us, p99 us, max us
+    using reportRow_t = std::tuple<int32_t, int32_t, int64_t, double, double, double, double>;
+    using report_t = std::vector<reportRow_t>;
+
+    LatencyTrace() = default;
+
+    // Sizes the tables. Call before any thread can record.
+    void setup(size_t clientToSerialIds, size_t serialToClientIds);
+
+    std::atomic<bool> enabled{false};
+
+    // A zero time point if tracing is off, so recordSince can skip it
+    clock_t::time_point start() const
+    {
+        return enabled.load(std::memory_order_relaxed) ? clock_t::now() : clock_t::time_point{};
+    }
+    void recordSince(Hop h, int32_t id, clock_t::time_point since)
+    {
+        if (since != clock_t::time_point{})
+            record(h, id, clock_t::now() - since);
+    }
+    void record(Hop h, int32_t id, clock_t::duration d);
+
+    void reset();
+    report_t report() const;
+    static std::string formatReport(const report_t &r);
+
+  private:
+    struct Histogram
+    {
+        std::array<std::atomic<uint32_t>, numBuckets> buckets{};
+        std::atomic<uint64_t> count{0}, totalNs{0}, maxNs{0};
+    };
+    std::array<std::unique_ptr<Histogram[]>, numHops> histograms;
+    std::array<size_t, numHops> histogramCount{};
+};
+} // namespace scxt::messaging
+
+#endif // SCXT_SRC_SCXT_CORE_MESSAGING_LATENCY_TRACE_H
@@ -31,6 +31,7 @@
 #include "messaging/client/detail/client_serial_impl.h"
 #include "client/client_messages.h"
 #include "messaging/client/client_serial.h"
+#include <algorithm>
 
 namespace scxt::messaging
 {
@@ -43,23 +44,32 @@ void MessageController::parseAudioMessageOnSerializationThread(
     switch (as.id)
     {
     case audio::a2s_pointer_complete:
-        returnAudioThreadCallback(static_cast<AudioThreadCallback *>(as.payload.p));
-        break;
+    {
+        auto cb = static_cast<AudioThreadCallback *>(as.payload.p);
+        while (cb)
+        {
+            auto nx = cb->next;
+            returnAudioThreadCallback(cb);
+            cb = nx;
+        }
+    }
+    break;
     case audio::a2s_note_on:
     case audio::a2s_note_off:
         throw std::logic_error("Implement this");
     case audio::a2s_structure_refresh:
         // TODO: Factor this a bit better
-        serializationSendToClient(client::s2c_send_pgz_structure,
-                                  engine.getPartGroupZoneStructure(), *this);
+        engine.sendPartGroupZoneStructureToClient();
         break;
     case audio::a2s_macro_updated:
     {
         int16_t pt = as.payload.i[0];
         int16_t idx = as.payload.i[1];
 
-        macroSetValueCompressorUsed = true;
-        macroSetValueCompressor[pt][idx] = true;
+        client::serializationSendToClientCoalesced(
+            client::s2c_update_macro_value, ((uint64_t)pt << 32) | (uint32_t)idx,
+            client::macroValue_t{pt, idx, engine.getPatch()->getPart(pt)->macros[idx].value},
+            *this);
     }
     break;
     case audio::a2s_processor_refresh:
@@ -67,7 +77,9 @@ void MessageController::parseAudioMessageOnSerializationThread(
         SCLOG_ONCE_IF(debug, "Processor Refresh Requestioned. TODO: Minimize this message "
                                  << (as.payload.i[0] ? "Zone" : "Group") << " slot "
                                  << as.payload.i[1]);
-        engine.getSelectionManager()->sendClientDataForLeadSelectionState();
+        outboundCoalescer.add(coalesceLeadSelectionRefresh, 0, [this]() {
+            engine.getSelectionManager()->sendClientDataForLeadSelectionState();
+        });
         break;
     }
     case audio::a2s_delete_this_pointer:
@@ -95,6 +107,11 @@ void MessageController::parseAudioMessageOnSerializationThread(
         engine.getSampleManager()->purgeUnreferencedSamples();
     }
     break;
+    case audio::a2s_patch_swapped:
+    {
+        engine.completePatchSwap((engine::Engine::PatchSwap *)as.payload.p);
+    }
+    break;
     case audio::a2s_none:
         break;
     }
@@ -102,17 +119,20 @@ void MessageController::parseAudioMessageOnSerializationThread(
 
 MessageController::~MessageController()
 {
-    while (!cbStore.empty())
+    auto cb = pendingCallbackHead;
+    while (cb)
     {
-        auto res = cbStore.top();
-        delete res;
-        cbStore.pop();
+        auto nx = cb->next;
+        releaseAudioThreadCallback(cb);
+        cb = nx;
     }
 }
 
 void MessageController::start()
 {
     assert(!serializationThread);
+    latencyTrace.setup((size_t)client::num_clientToSerializationMessages,
+                       (size_t)client::num_serializationToClientMessages);
     shouldRun = true;
     serializationThread = std::make_unique<std::thread>([this]() { this->runSerialization(); });
 }
@@ -122,7 +142,7 @@ void MessageController::stop()
     assert(serializationThread);
     // TODO: Send queue goes away interrupt message
     shouldRun = false;
-    clientToSerializationConditionVar.notify_all();
+    clientToSerializationQueue.wakeConsumer();
 
     serializationThread->join();
     serializationThread.reset(nullptr);
@@ -132,53 +152,102 @@ MessageController::AudioThreadCallback *MessageController::getAudioThreadCallbac
     assert(threadingChecker.isSerialThread());
     if (cbStore.empty())
     {
+        heapAudioThreadCallbackCount.fetch_add(1, std::memory_order_relaxed);
         return new AudioThreadCallback();
     }
-    auto res = cbStore.top();
-    cbStore.pop();
+    auto res = cbStore.back();
+    cbStore.pop_back();
     return res;
 }
 
 void MessageController::returnAudioThreadCallback(AudioThreadCallback *r)
 {
     assert(threadingChecker.isSerialThread());
+    latencyTrace.recordSince(LatencyTrace::AUDIO_ROUND_TRIP, r->traceId, r->scheduledAt);
     r->execCompleteOnSer(engine);
-    cbStore.push(r);
+    releaseAudioThreadCallback(r);
 }
 
-void MessageController::scheduleAudioThreadFunctionCallback(
-    audio::SerializationToAudioMessageId sid, std::function<void(engine::Engine &)> cb,
-    std::function<void(const engine::Engine &)> sercb)
+void MessageController::releaseAudioThreadCallback(AudioThreadCallback *r)
+{
+    // Reset here rather than at next use so captured state dies on this thread, now
+    r->f.reset();
+    r->serialOnComplete.reset();
+    r->next = nullptr;
+    r->scheduledAt = {};
+    r->traceId = -1;
+    if (r->pooled)
+        cbStore.push_back(r);
+    else
+        delete r;
+}
+
+void MessageController::dispatchAudioThreadCallback(audio::SerializationToAudioMessageId sid,
+                                                    AudioThreadCallback *pt)
 {
     assert(threadingChecker.isSerialThread());
 
     if (!localCopyOfIsAudioRunning)
     {
+        // Nobody will drain the queue, so anything already batched runs here, ahead of us
+        auto head = pt;
+        if (pendingCallbackHead)
+        {
+            pendingCallbackTail->next = pt;
+            head = pendingCallbackHead;
+            pendingCallbackHead = nullptr;
+            pendingCallbackTail = nullptr;
+            pendingCallbackId = audio::s2a_none;
+        }
+
         // In this case our audio thread checks will be wrong.
         // We could elevate ourselves to audio thread for as econd or just...
         threadingChecker.bypassThreadChecks = true;
-        if (cb)
-            cb(engine);
-        if (sercb)
-            sercb(engine);
-
+        head->execBatch(engine);
+        for (auto q = head; q; q = q->next)
+            q->execCompleteOnSer(engine);
         threadingChecker.bypassThreadChecks = false;
+
+        while (head)
+        {
+            auto nx = head->next;
+            releaseAudioThreadCallback(head);
+            head = nx;
+        }
+        return;
+    }
+
+    if (pendingCallbackHead && pendingCallbackId != sid)
+        flushAudioThreadCallbacks();
+
+    if (!pendingCallbackHead)
+    {
+        pendingCallbackHead = pt;
+        pendingCallbackId = sid;
     }
     else
     {
-        auto pt = getAudioThreadCallback();
-        pt->setFunction(cb);
-        if (sercb)
-            pt->setSerialCompleteFunction(sercb);
-        else
-            pt->nullSerialCompleteFunction();
-        auto s2a = audio::SerializationToAudio();
-        s2a.id = sid;
-        s2a.payload.p = (void *)pt;
-        s2a.payloadType = audio::SerializationToAudio::VOID_STAR;
-
-        serializationToAudioQueue.push(s2a);
+        pendingCallbackTail->next = pt;
     }
+    pendingCallbackTail = pt;
+}
+
+void MessageController::flushAudioThreadCallbacks()
+{
+    assert(threadingChecker.isSerialThread());
+    if (!pendingCallbackHead)
+        return;
+
+    auto s2a = audio::SerializationToAudio();
+    s2a.id = pendingCallbackId;
+    s2a.payload.p = (void *)pendingCallbackHead;
+    s2a.payloadType = audio::SerializationToAudio::VOID_STAR;
+
+    pendingCallbackHead = nullptr;
+    pendingCallbackTail = nullptr;
+    pendingCallbackId = audio::s2a_none;
+
+    serializationToAudioQueue.push(s2a);
 }
 
 void MessageController::stopAudioThreadThenRunOnSerial(
@@ -192,8 +261,11 @@ void MessageController::stopAudioThreadThenRunOnSerial(
 void MessageController::restartAudioThreadFromSerial()
 {
     assert(threadingChecker.isSerialThread());
-    scheduleAudioThreadCallbackUnderStructureLock(
-        [](engine::Engine &e) { e.stopEngineRequests--; });
+    scheduleAudioThreadCallbackUnderStructureLock([](engine::Engine &e) {
+        // Whatever ran while we were stopped may have reshaped parts without telling them
+        e.getPatch()->markAllZoneLookupsDirty();
+        e.stopEngineRequests--;
+    });
 }
 
 void MessageController::runSerialization()
@@ -204,39 +276,67 @@ void MessageController::runSerialization()
     {
         using namespace std::chrono_literals;
 
-        clientToSerializationMessage_t inbound;
         bool audioStateChanged{false};
-        bool receivedMessageFromClient{false};
+        auto clientFrameDue = [this]() {
+            return !outboundCoalescer.empty() &&
+                   outboundCoalescer.isFrameDue(OutboundCoalescer::clock_t::now());
+        };
+        while (shouldRun && !clientToSerializationQueue.maybeHasMessages() &&
+               (audioToSerializationQueue.empty()) && !audioStateChanged && !clientFrameDue())
         {
-            std::unique_lock<std::mutex> lock(clientToSerializationMutex);
-            while (shouldRun && clientToSerializationQueue.empty() &&
-                   (audioToSerializationQueue.empty()) && !audioStateChanged)
-            {
-                clientToSerializationConditionVar.wait_for(lock, 50ms);
-                audioStateChanged = updateAudioRunning(clientToSerializationQueue.empty() &&
-                                                       audioToSerializationQueue.empty());
-            }
-            if (!clientToSerializationQueue.empty())
-            {
-                inbound = clientToSerializationQueue.front();
-                clientToSerializationQueue.pop();
-                receivedMessageFromClient = true;
-            }
+            // Held client updates shorten the wait to the next frame. Only full waits
+            // count towards deciding audio has stopped.
+            auto wait = std::chrono::milliseconds(50);
+            if (!outboundCoalescer.empty())
+                wait = std::clamp(std::chrono::ceil<std::chrono::milliseconds>(
+                                      outboundCoalescer.getNextFrame() -
+                                      OutboundCoalescer::clock_t::now()),
+                                  1ms, wait);
+            clientToSerializationQueue.waitFor(wait);
+            audioStateChanged =
+                updateAudioRunning(wait == 50ms && !clientToSerializationQueue.maybeHasMessages() &&
+                                   audioToSerializationQueue.empty());
         }
+        if (audioStateChanged && !isAudioRunning)
+            engine.structureGate.writerStopped();
+
+        inboundBatch.clear();
+        InboundMessage inbound;
+        while (clientToSerializationQueue.pop(inbound))
+            inboundBatch.push_back(std::move(inbound));
+
         if (shouldRun)
         {
-            if (receivedMessageFromClient)
+            if (!inboundBatch.empty())
             {
-                std::lock_guard<std::mutex> g(engine.modifyStructureMutex);
-                client::serializationThreadExecuteClientMessage(inbound, engine, *this);
-                inboundClientMessageCount++;
-#if BUILD_IS_DEBUG
-                if (inboundClientMessageCount % 1000 == 0)
+                if (coalesceInboundMessages.load(std::memory_order_relaxed))
+                    coalescedClientMessageCount += client::coalesceClientMessages(inboundBatch);
+                for (const auto &in : inboundBatch)
                 {
-                    SCLOG_IF(debug,
-                             "Client -> Serial Message Count: " << inboundClientMessageCount);
-                }
+                    auto execStart = latencyTrace.start();
+                    {
+                        engine::StructureGate::ReadGuard g(engine.structureGate);
+                        client::serializationThreadExecuteClientMessage(in.msg, engine, *this);
+                    }
+                    if (execStart != LatencyTrace::clock_t::time_point{} &&
+                        in.enqueued != LatencyTrace::clock_t::time_point{})
+                    {
+                        latencyTrace.record(LatencyTrace::INBOUND_QUEUE, currentInboundMessageId,
+                                            execStart - in.enqueued);
+                    }
+                    latencyTrace.recordSince(LatencyTrace::SERIAL_EXECUTE, currentInboundMessageId,
+                                             execStart);
+                    currentInboundMessageId = -1;
+                    inboundClientMessageCount++;
+#if BUILD_IS_DEBUG
+                    if (inboundClientMessageCount % 1000 == 0)
+                    {
+                        SCLOG_IF(debug, "Client -> Serial Message Count: "
+                                            << inboundClientMessageCount << " coalesced "
+                                            << coalescedClientMessageCount);
+                    }
 #endif
+                }
             }
 
             if (audioStateChanged && isClientConnected)
@@ -246,19 +346,37 @@ void MessageController::runSerialization()
 
             // TODO: Drain SerToAudioQ if there's no audio thread
             bool tryToDrain{true};
-            prepareSerializationThreadForAudioQueueDrain();
             while (tryToDrain && !audioToSerializationQueue.empty())
             {
                 auto msgopt = audioToSerializationQueue.pop();
                 if (msgopt.has_value())
                 {
-                    std::lock_guard<std::mutex> g(engine.modifyStructureMutex);
+                    engine::StructureGate::ReadGuard g(engine.structureGate);
                     parseAudioMessageOnSerializationThread(*msgopt);
                 }
                 else
                     tryToDrain = false;
             }
-            serializationThreadPostAudioQueueDrain();
+
+            if (engine.getPatch()->zoneLookupIndicesNeedRefresh())
+            {
+                engine::StructureGate::ReadGuard g(engine.structureGate);
+                engine.getPatch()->refreshZoneLookupIndices();
+            }
+
+            if (engine.getPatch()->voiceStartDescriptorsNeedRefresh())
+            {
+                engine::StructureGate::ReadGuard g(engine.structureGate);
+                engine.getPatch()->refreshVoiceStartDescriptors();
+            }
+
+            if (clientFrameDue())
+            {
+                engine::StructureGate::ReadGuard g(engine.structureGate);
+                outboundCoalescer.flush(OutboundCoalescer::clock_t::now());
+            }
+
+            flushAudioThreadCallbacks();
         }
         else
         {
@@ -342,22 +460,16 @@ void MessageController::unregisterClient()
 }
 void MessageController::sendRawFromClient(const clientToSerializationMessage_t &s)
 {
-    {
-        std::lock_guard<std::mutex> g(clientToSerializationMutex);
-        clientToSerializationQueue.push(s);
-
 #if BUILD_IS_DEBUG
-        c2sMessageCount++;
-        c2sMessageBytes += s.size();
-        if (c2sMessageCount % 100 == 0)
-        {
-            SCLOG_IF(debug, "Client -> Serial Message Count : "
-                                << c2sMessageCount << " size " << c2sMessageBytes
-                                << " avgmsg: " << 1.f * c2sMessageBytes / c2sMessageCount);
-        }
-#endif
+    auto ct = ++c2sMessageCount;
+    auto by = (c2sMessageBytes += s.size());
+    if (ct % 100 == 0)
+    {
+        SCLOG_IF(debug, "Client -> Serial Message Count : " << ct << " size " << by
+                                                            << " avgmsg: " << 1.f * by / ct);
     }
-    clientToSerializationConditionVar.notify_one();
+#endif
+    clientToSerializationQueue.push({s, latencyTrace.start()});
 }
 
 void MessageController::reportErrorToClient(const std::string &title, const std::string &body,
@@ -375,34 +487,6 @@ void MessageController::reportErrorToClient(const std::string &title, const std:
                                       client::s2cError_t{title, body, source, line}, *(this));
 }
 
-void MessageController::prepareSerializationThreadForAudioQueueDrain()
-{
-    assert(!macroSetValueCompressorUsed);
-}
-void MessageController::serializationThreadPostAudioQueueDrain()
-{
-    if (macroSetValueCompressorUsed)
-    {
-        for (int pt = 0; pt < numParts; ++pt)
-        {
-            for (int idx = 0; idx < macrosPerPart; ++idx)
-            {
-                if (macroSetValueCompressor[pt][idx])
-                {
-                    serializationSendToClient(
-                        client::s2c_update_macro_value,
-                        messaging::client::macroValue_t{
-                            pt, idx, engine.getPatch()->getPart(pt)->macros[idx].value},
-                        *this);
-                    macroSetValueCompressor[pt][idx] = false;
-                }
-            }
-        }
-
-        macroSetValueCompressorUsed = false;
-    }
-}
-
 void MessageController::updateClientActivityNotification(const std::string &msg, int idx)
 {
     serializationSendToClient(client::s2c_send_activity_notification,
@@ -38,6 +38,10 @@
 #include <stack>
 #include <chrono>
 
+#include "inbound_queue.h"
+#include "inplace_function.h"
+#include "latency_trace.h"
+#include "outbound_coalescer.h"
 #include "client/client_serial.h"
 #include "audio/audio_serial.h"
 #include "sst/cpputils/ring_buffer.h"
@@ -160,9 +164,13 @@ struct MessageController : MoveableOnly<MessageController>
         serializationToAudioQueue.subscribe();
         audioToSerializationQueue.subscribe();
 
-        for (auto &ma : macroSetValueCompressor)
-            for (auto &m : ma)
-                m = false;
+        cbPool = std::make_unique<AudioThreadCallback[]>(audioThreadCallbackPoolSize);
+        cbStore.reserve(audioThreadCallbackPoolSize);
+        for (size_t i = 0; i < audioThreadCallbackPoolSize; ++i)
+        {
+            cbPool[i].pooled = true;
+            cbStore.push_back(&cbPool[i]);
+        }
     }
     ~MessageController();
 
@@ -196,6 +204,19 @@ struct MessageController : MoveableOnly<MessageController>
     typedef std::string serialToClientMessage_t;
     typedef std::string clientToSerializationMessage_t;
 
+    /**
+     * How messages in either direction are encoded. BINARY is msgpack, with scalar
+     * payloads sent as a flat frame; JSON is for debugging when you want to read the
+     * traffic. Receivers detect the encoding per message, so this can change at any
+     * time. See client_serial_impl.h
+     */
+    enum struct WireFormat : int32_t
+    {
+        BINARY,
+        JSON
+    };
+    std::atomic<WireFormat> wireFormat{WireFormat::BINARY};
+
     typedef std::function<void(const serialToClientMessage_t &)> clientCallback_t;
     clientCallback_t clientCallback{nullptr};
     mutable std::mutex clientCallbackMutex;
@@ -205,6 +226,19 @@ struct MessageController : MoveableOnly<MessageController>
     }
     std::vector<std::string> preClientConnectionCache;
 
+    /**
+     * What the client was last sent of the part group zone structure, so the next
+     * send can be a delta. Serialization thread only; see
+     * Engine::sendPartGroupZoneStructureToClient
+     */
+    struct SentStructure
+    {
+        uint64_t version{0};
+        bool valid{false};
+        engine::Engine::pgzStructure_t structure;
+        std::vector<int64_t> keys;
+    } sentStructure;
+
     /**
      * Register a client. Called from the client thread.
      *
@@ -263,48 +297,65 @@ struct MessageController : MoveableOnly<MessageController>
      */
     void sendSerializationToAudio(const serializationToAudioMessage_t &m)
     {
+        flushAudioThreadCallbacks();
         serializationToAudioQueue.push(m);
     }
 
     /**
      * Schedule a function on the audio thread from the serialization thread.
+     * The callables are stored in a pooled AudioThreadCallback without going
+     * through std::function, and callbacks scheduled in the same pass of the
+     * serialization thread reach the audio thread as one dispatch.
      * @param f
      */
-    void scheduleAudioThreadCallback(std::function<void(engine::Engine &)> f,
-                                     std::function<void(const engine::Engine &)> cb = nullptr)
+    template <typename F, typename C = std::nullptr_t>
+    void scheduleAudioThreadCallback(F &&f, C &&cb = nullptr)
     {
-        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer, f, cb);
+        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer, std::forward<F>(f),
+                                            std::forward<C>(cb));
     }
 
-    void scheduleAudioThreadCallbackUnderStructureLock(
-        std::function<void(engine::Engine &)> f,
-        std::function<void(const engine::Engine &)> cb = nullptr)
+    template <typename F, typename C = std::nullptr_t>
+    void scheduleAudioThreadCallbackUnderStructureLock(F &&f, C &&cb = nullptr)
     {
-        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer_under_structurelock, f,
-                                            cb);
+        scheduleAudioThreadFunctionCallback(audio::s2a_dispatch_to_pointer_under_structurelock,
+                                            std::forward<F>(f), std::forward<C>(cb));
     }
 
-    void scheduleAudioThreadFunctionCallback(audio::SerializationToAudioMessageId id,
-                                             std::function<void(engine::Engine &)> f,
-                                             std::function<void(const engine::Engine &)> cb);
+    template <typename F, typename C>
+    void scheduleAudioThreadFunctionCallback(audio::SerializationToAudioMessageId id, F &&f,
+                                             C &&cb)
+    {
+        assert(threadingChecker.isSerialThread());
+        auto pt = getAudioThreadCallback();
+        pt->f.set(std::forward<F>(f));
+        pt->serialOnComplete.set(std::forward<C>(cb));
+        pt->scheduledAt = latencyTrace.start();
+        pt->traceId = currentInboundMessageId;
+        dispatchAudioThreadCallback(id, pt);
+    }
 
     void stopAudioThreadThenRunOnSerial(std::function<void(const engine::Engine &)> f);
     void restartAudioThreadFromSerial();
+
+    /**
+     * Send any audio thread callbacks batched so far. This happens at the end of
+     * each serialization thread pass and before any other message to the audio
+     * thread, so ordering is the same as if each had been sent on its own.
+     */
+    void flushAudioThreadCallbacks();
+
     struct AudioThreadCallback
     {
       public:
-        void setFunction(std::function<void(engine::Engine &)> &to) { f = std::move(to); }
-        void setSerialCompleteFunction(std::function<void(const engine::Engine &)> &q)
-        {
-            serialOnComplete = std::move(q);
-        }
-        void nullSerialCompleteFunction() { serialOnComplete = nullptr; }
-        inline void exec(engine::Engine &e)
+        // Run this and the rest of the batch chained behind it
+        inline void execBatch(engine::Engine &e)
         {
             assert(e.getMessageController()->threadingChecker.isAudioThread());
-            f(e);
+            for (auto q = this; q; q = q->next)
+                q->f(e);
         }
-        inline void execCompleteOnSer(const engine::Engine &e)
+        inline void execCompleteOnSer(engine::Engine &e)
         {
             assert(e.getMessageController()->threadingChecker.isSerialThread());
             if (serialOnComplete)
@@ -312,8 +363,13 @@ struct MessageController : MoveableOnly<MessageController>
         }
 
       private:
-        std::function<void(engine::Engine &)> f{nullptr};
-        std::function<void(const engine::Engine &)> serialOnComplete{nullptr};
+        friend struct MessageController;
+        InplaceFunction<void(engine::Engine &)> f;
+        InplaceFunction<void(engine::Engine &)> serialOnComplete;
+        AudioThreadCallback *next{nullptr};
+        bool pooled{false};
+        LatencyTrace::clock_t::time_point scheduledAt{};
+        int32_t traceId{-1};
     };
 
     // The engine has direct access to the audio queues
@@ -330,10 +386,24 @@ struct MessageController : MoveableOnly<MessageController>
     void reportErrorToClient(const std::string &title, const std::string &body,
                              const std::string &source, int line);
 
+    /*
+     * Per hop latency histograms, off unless a client or tool turns them on. The
+     * inbound id is the client message the serialization thread is executing, or -1.
+     */
+    LatencyTrace latencyTrace;
+    int32_t currentInboundMessageId{-1};
+
+    /*
+     * High frequency client updates wait here for the next UI frame; see
+     * client::serializationSendToClientCoalesced. The client sets the frame rate.
+     */
+    OutboundCoalescer outboundCoalescer;
+    static constexpr int32_t coalesceLeadSelectionRefresh{-1};
+
     /*
      * Some stats on messages back
      */
-    uint64_t c2sMessageCount{0}, c2sMessageBytes{0};
+    std::atomic<uint64_t> c2sMessageCount{0}, c2sMessageBytes{0};
 
     /*
      * This is a function which causes the plugin to issue a callback.
@@ -380,15 +450,20 @@ struct MessageController : MoveableOnly<MessageController>
     uint64_t inboundClientMessageCount{0};
     void runSerialization();
     void parseAudioMessageOnSerializationThread(const audio::AudioToSerialization &as);
-    void prepareSerializationThreadForAudioQueueDrain();
-    void serializationThreadPostAudioQueueDrain();
-    bool macroSetValueCompressorUsed{false};
-    std::array<std::array<bool, scxt::macrosPerPart>, scxt::numParts> macroSetValueCompressor{};
 
     // serialization thread only please
     AudioThreadCallback *getAudioThreadCallback();
     void returnAudioThreadCallback(AudioThreadCallback *);
-    std::stack<AudioThreadCallback *> cbStore;
+    void releaseAudioThreadCallback(AudioThreadCallback *);
+    void dispatchAudioThreadCallback(audio::SerializationToAudioMessageId id,
+                                     AudioThreadCallback *);
+
+    // A fixed slab of callbacks made once; if a burst outruns it we go to the heap
+    static constexpr size_t audioThreadCallbackPoolSize{256};
+    std::unique_ptr<AudioThreadCallback[]> cbPool;
+    std::vector<AudioThreadCallback *> cbStore;
+    AudioThreadCallback *pendingCallbackHead{nullptr}, *pendingCallbackTail{nullptr};
+    audio::SerializationToAudioMessageId pendingCallbackId{audio::s2a_none};
 
     sst::cpputils::SimpleRingBuffer<serializationToAudioMessage_t, 1024> serializationToAudioQueue;
     sst::cpputils::SimpleRingBuffer<audioToSerializationMessage_t, 1024 * 16>
@@ -402,10 +477,16 @@ struct MessageController : MoveableOnly<MessageController>
     std::atomic<bool> passWrapperEventsToWrapperQueue{false};
     sst::cpputils::SimpleRingBuffer<serializationToAudioMessage_t, 1024> engineToPluginWrapperQueue;
 
+    // How often a burst outran the audio thread callback pool and went to the heap
+    std::atomic<uint64_t> heapAudioThreadCallbackCount{0};
+    // Tests turn this off so a burst of edits to one target isn't folded into one
+    std::atomic<bool> coalesceInboundMessages{true};
+
   private:
-    std::queue<clientToSerializationMessage_t> clientToSerializationQueue;
-    std::mutex clientToSerializationMutex;
-    std::condition_variable clientToSerializationConditionVar;
+    InboundQueue clientToSerializationQueue;
+    // serialization thread only; kept around so the batch doesn't reallocate each wakeup
+    std::vector<InboundMessage> inboundBatch;
+    uint64_t coalescedClientMessageCount{0};
 
     int serializationToClientCallback;
 
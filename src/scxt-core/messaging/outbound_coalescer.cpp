@@ -0,0 +1,84 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "outbound_coalescer.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace scxt::messaging
+{
+void OutboundCoalescer::setFrameRate(double hz)
+{
+    frameRate = std::clamp(hz, minFrameRate, maxFrameRate);
+    frameInterval = std::chrono::duration_cast<clock_t::duration>(
+        std::chrono::duration<double>(1.0 / frameRate));
+}
+
+void OutboundCoalescer::add(int32_t id, uint64_t address, send_t &&send)
+{
+    // A frame rarely holds more than a handful of keys, so a scan beats hashing
+    for (auto &e : pending)
+    {
+        if (e.id == id && e.address == address)
+        {
+            e.send = std::move(send);
+            replacedCount++;
+            return;
+        }
+    }
+    pending.push_back({id, address, std::move(send)});
+}
+
+void OutboundCoalescer::flush(clock_t::time_point now)
+{
+    nextFrame = now + frameInterval;
+    if (pending.empty())
+        return;
+
+    // A send may itself add (or flushId), so run from a separate list
+    std::swap(pending, sending);
+    for (auto &e : sending)
+        e.send();
+    sending.clear();
+}
+
+void OutboundCoalescer::flushId(int32_t id)
+{
+    auto it = std::stable_partition(pending.begin(), pending.end(),
+                                    [id](const auto &e) { return e.id != id; });
+    if (it == pending.end())
+        return;
+
+    std::vector<Entry> due;
+    due.reserve(std::distance(it, pending.end()));
+    std::move(it, pending.end(), std::back_inserter(due));
+    pending.erase(it, pending.end());
+    for (auto &e : due)
+        e.send();
+}
+} // namespace scxt::messaging
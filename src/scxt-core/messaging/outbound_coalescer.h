@@ -0,0 +1,97 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#ifndef SCXT_SRC_SCXT_CORE_MESSAGING_OUTBOUND_COALESCER_H
+#define SCXT_SRC_SCXT_CORE_MESSAGING_OUTBOUND_COALESCER_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "utils.h"
+
+namespace scxt::messaging
+{
+/*
+ * Automation can move a macro or poke a processor hundreds of times a second, but
+ * an editor only repaints at its frame rate. Updates sent through here are held by
+ * (message id, address) and only the last one for each key goes out, once per UI
+ * frame, in the order the keys first arrived. That saves encoding and the client
+ * repainting for values nobody would ever see.
+ *
+ * The id is normally the serialization to client id being sent. Work which sends
+ * several messages (refreshing the lead selection, say) can pick a negative id.
+ *
+ * Serialization thread only.
+ */
+struct OutboundCoalescer : MoveableOnly<OutboundCoalescer>
+{
+    using clock_t = std::chrono::steady_clock;
+    using send_t = std::function<void()>;
+
+    OutboundCoalescer() { setFrameRate(defaultFrameRate); }
+
+    static constexpr double defaultFrameRate{60.0};
+    static constexpr double minFrameRate{1.0}, maxFrameRate{240.0};
+    void setFrameRate(double hz);
+    double getFrameRate() const { return frameRate; }
+
+    // Replaces whatever was waiting for (id, address)
+    void add(int32_t id, uint64_t address, send_t &&send);
+
+    bool empty() const { return pending.empty(); }
+    bool isFrameDue(clock_t::time_point now) const { return now >= nextFrame; }
+    clock_t::time_point getNextFrame() const { return nextFrame; }
+
+    // Sends everything waiting and starts the next frame
+    void flush(clock_t::time_point now);
+    /*
+     * Sends anything waiting under id straight away, so a message with that id sent
+     * around the coalescer can't be overtaken by an older update of the same kind.
+     */
+    void flushId(int32_t id);
+
+    uint64_t getReplacedCount() const { return replacedCount; }
+
+  private:
+    struct Entry
+    {
+        int32_t id;
+        uint64_t address;
+        send_t send;
+    };
+    std::vector<Entry> pending, sending;
+
+    double frameRate{defaultFrameRate};
+    clock_t::duration frameInterval{};
+    clock_t::time_point nextFrame{};
+    uint64_t replacedCount{0};
+};
+} // namespace scxt::messaging
+
+#endif // SCXT_SRC_SCXT_CORE_MESSAGING_OUTBOUND_COALESCER_H
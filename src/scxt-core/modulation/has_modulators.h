@@ -38,6 +38,7 @@
 #include "modulation/modulators/phasor_evaluator.h"
 #include "modulators/env_follower.h"
 #include "sst/cpputils/constructors.h"
+#include "sst/basic-blocks/dsp/RNG.h"
 
 namespace scxt::modulation::shared
 {
@@ -45,6 +46,17 @@ namespace scxt::modulation::shared
 static_assert(lfosPerGroup == lfosPerZone,
               "If this is false you need to template out the count below");
 
+/*
+ * An object which owns its random source, seeded from the engine, renders identically
+ * no matter which thread renders it. Inherit this ahead of HasModulators so it is
+ * constructed before the modulators bind to it.
+ */
+struct OwnedRNG
+{
+    explicit OwnedRNG(uint32_t seed) : ownedRNG(seed) {}
+    sst::basic_blocks::dsp::RNG ownedRNG;
+};
+
 template <typename T, size_t egsPerObject> struct HasModulators
 {
     struct DoubleRate
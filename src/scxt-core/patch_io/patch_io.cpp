@@ -735,34 +735,14 @@ bool initFromResourceBundle(scxt::engine::Engine &engine, const std::string &fil
         return false;
     }
 
-    auto &cont = engine.getMessageController();
-    if (cont->isAudioRunning)
+    try
     {
-        cont->stopAudioThreadThenRunOnSerial([payload, &nonconste = engine](auto &e) {
-            try
-            {
-                nonconste.immediatelyTerminateAllVoices();
-                scxt::json::unstreamEngineState(nonconste, payload, true);
-                auto &cont = *e.getMessageController();
-                cont.restartAudioThreadFromSerial();
-            }
-            catch (std::exception &err)
-            {
-                SCLOG_IF(patchIO, "Unable to load [" << err.what() << "]");
-            }
-        });
+        // The current patch keeps playing while this one builds
+        scxt::json::unstreamEngineStateInBackground(engine, payload, true);
     }
-    else
+    catch (std::exception &err)
     {
-        try
-        {
-            engine.immediatelyTerminateAllVoices();
-            scxt::json::unstreamEngineState(engine, payload, true);
-        }
-        catch (std::exception &err)
-        {
-            SCLOG_IF(patchIO, "Unable to load [" << err.what() << "]");
-        }
+        SCLOG_IF(patchIO, "Unable to load [" << err.what() << "]");
     }
     return true;
 }
@@ -807,46 +787,25 @@ bool loadMulti(const fs::path &p, scxt::engine::Engine &engine)
         return false;
     }
 
-    auto &cont = engine.getMessageController();
-    if (cont->isAudioRunning)
+    try
     {
-        cont->stopAudioThreadThenRunOnSerial(
-            [payload, multiPath = p, monolithBinaryIndex, &nonconste = engine](auto &e) {
-                try
-                {
-                    auto g = messaging::MessageController::ClientActivityNotificationGuard(
-                        "Loading Multi from " + multiPath.filename().u8string(),
-                        *nonconste.getMessageController());
-
-                    nonconste.getSampleManager()->setRelativeRoot(multiPath.parent_path());
-                    nonconste.getSampleManager()->setMonolithBinaryIndex(multiPath,
-                                                                         monolithBinaryIndex);
-                    nonconste.immediatelyTerminateAllVoices();
-                    scxt::json::unstreamEngineState(nonconste, payload, true);
-                    nonconste.getSampleManager()->clearReparenting();
-                    nonconste.getSampleManager()->clearMonolithBinaryIndex();
-                    nonconste.getSampleManager()->purgeUnreferencedSamples();
-
-                    auto &cont = *e.getMessageController();
-                    cont.restartAudioThreadFromSerial();
-                }
-                catch (std::exception &err)
-                {
-                    SCLOG_IF(patchIO, "Unable to load [" << err.what() << "]");
-                }
-            });
+        auto g = messaging::MessageController::ClientActivityNotificationGuard(
+            "Loading Multi from " + p.filename().u8string(), *engine.getMessageController());
+
+        // Samples resolve while the patch builds, so the reparenting is only needed
+        // until the build returns, not until the audio thread swaps the patch in
+        auto &sm = *engine.getSampleManager();
+        sm.setRelativeRoot(p.parent_path());
+        sm.setMonolithBinaryIndex(p, monolithBinaryIndex);
+        scxt::json::unstreamEngineStateInBackground(engine, payload, true);
+        sm.clearReparenting();
+        sm.clearMonolithBinaryIndex();
     }
-    else
+    catch (std::exception &err)
     {
-        try
-        {
-            engine.immediatelyTerminateAllVoices();
-            scxt::json::unstreamEngineState(engine, payload, true);
-        }
-        catch (std::exception &err)
-        {
-            SCLOG_IF(patchIO, "Unable to load [" << err.what() << "]");
-        }
+        SCLOG_IF(patchIO, "Unable to load [" << err.what() << "]");
+        engine.getSampleManager()->clearReparenting();
+        engine.getSampleManager()->clearMonolithBinaryIndex();
     }
     return true;
 }
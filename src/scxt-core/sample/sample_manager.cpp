@@ -91,6 +91,46 @@ void SampleManager::restoreFromSampleAddressesAndIDs(const sampleAddressesAndIds
 
 SampleManager::~SampleManager() {}
 
+std::unique_ptr<SampleManager> SampleManager::makeStaging() const
+{
+    auto res = std::make_unique<SampleManager>(threadingChecker);
+    res->relativeRoot = relativeRoot;
+    res->monolithPath = monolithPath;
+    res->monolithIndex = monolithIndex;
+    res->raiseError = raiseError;
+    res->informUI = informUI;
+    return res;
+}
+
+void SampleManager::mergeStaged(SampleManager &&staged)
+{
+    assert(threadingChecker.isSerialThread());
+    {
+        auto lk = acquireMapLock();
+        auto slk = staged.acquireMapLock();
+        for (auto &[id, s] : staged.samples)
+            samples[id] = std::move(s);
+        staged.samples.clear();
+    }
+    for (const auto &[from, to] : staged.idAliases)
+        idAliases[from] = to;
+
+    // The open files are only a cache for later loads, so keep whichever we had first
+    for (auto &[k, v] : staged.sf2FilesByPath)
+        sf2FilesByPath.try_emplace(k, std::move(v));
+    for (auto &[k, v] : staged.gigFilesByPath)
+        gigFilesByPath.try_emplace(k, std::move(v));
+    for (auto &[k, v] : staged.scxtMonolithFilesByPath)
+        scxtMonolithFilesByPath.try_emplace(k, std::move(v));
+    sf2MD5ByPath.insert(staged.sf2MD5ByPath.begin(), staged.sf2MD5ByPath.end());
+    gigMD5ByPath.insert(staged.gigMD5ByPath.begin(), staged.gigMD5ByPath.end());
+    scxtMonolithMD5ByPath.insert(staged.scxtMonolithMD5ByPath.begin(),
+                                 staged.scxtMonolithMD5ByPath.end());
+
+    streamingVersion = staged.streamingVersion;
+    updateSampleMemory();
+}
+
 std::optional<SampleID>
 SampleManager::loadSampleByFileAddress(const Sample::SampleFileAddress &addr, const SampleID &id)
 {
@@ -189,6 +189,15 @@ struct SampleManager : MoveableOnly<SampleManager>
 
     void purgeUnreferencedSamples();
 
+    /*
+     * A background load restores its samples into a staging manager, so this one (and
+     * the patch playing from it) is undisturbed until the new patch goes live, and
+     * untouched if it never does. The staging manager resolves paths and monoliths as
+     * we do and reports through our callbacks; mergeStaged adopts what it loaded.
+     */
+    std::unique_ptr<SampleManager> makeStaging() const;
+    void mergeStaged(SampleManager &&staged);
+
     void reset()
     {
         {
@@ -122,9 +122,7 @@ void GroupRenameItem::store(engine::Engine &e, int16_t part, int16_t group)
 void GroupRenameItem::restore(engine::Engine &e)
 {
     e.getPatch()->getPart(partIndex)->getGroup(groupIndex)->name = oldName;
-    messaging::client::serializationSendToClient(messaging::client::s2c_send_pgz_structure,
-                                                 e.getPartGroupZoneStructure(),
-                                                 *(e.getMessageController()));
+    e.sendPartGroupZoneStructureToClient();
 }
 
 std::unique_ptr<UndoableItem> GroupRenameItem::makeRedo(engine::Engine &e)
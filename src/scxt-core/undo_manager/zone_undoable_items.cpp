@@ -62,6 +62,7 @@ void ZoneMappingDataUndoableItem::restore(engine::Engine &e)
                 auto &zone =
                     eng.getPatch()->getPart(zs[i].part)->getGroup(zs[i].group)->getZone(zs[i].zone);
                 zone->mapping = mappings[i];
+                eng.getPatch()->getPart(zs[i].part)->markZoneLookupDirty();
             }
         },
         [](auto &eng) {
@@ -45,6 +45,10 @@
 #include "filesystem/import.h"
 #include <cassert>
 
+#if SCXT_AUDIO_THREAD_GUARD
+#include "infrastructure/audio_thread_guard.h"
+#endif
+
 namespace scxt
 {
 /**
@@ -244,7 +248,13 @@ struct ThreadingChecker
         return true;
 #endif
     }
-    void registerAsAudioThread() { audioThreadId = std::this_thread::get_id(); }
+    void registerAsAudioThread()
+    {
+        audioThreadId = std::this_thread::get_id();
+#if SCXT_AUDIO_THREAD_GUARD
+        infrastructure::audio_thread_guard::armCurrentThread();
+#endif
+    }
     inline bool isAudioThread() const
     {
 #if BUILD_IS_DEBUG
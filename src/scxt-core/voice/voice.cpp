@@ -40,7 +40,8 @@ namespace scxt::voice
 {
 
 Voice::Voice(engine::Engine *e, engine::Zone *z)
-    : scxt::modulation::shared::HasModulators<Voice, egsPerZone>(this, e->rng), engine(e), zone(z),
+    : scxt::modulation::shared::OwnedRNG(e->rng.unifU32()),
+      scxt::modulation::shared::HasModulators<Voice, egsPerZone>(this, ownedRNG), engine(e), zone(z),
       sampleIndex(zone->sampleIndex), halfRate(6, true), endpoints(nullptr) // see comment
 {
     assert(zone);
@@ -75,6 +76,7 @@ Voice::~Voice()
         SCLOG_IF(warnings, "Destroying assigned voice. (OK in shutdown)");
     }
 #endif
+    returnUnisonGenerators();
     for (auto i = 0; i < engine::processorCount; ++i)
     {
         dsp::processor::unspawnProcessor(processors[i]);
@@ -84,11 +86,25 @@ Voice::~Voice()
 
 void Voice::cleanupVoice()
 {
+    auto *part = zone->parentGroup->parentPart;
     zone->removeVoice(this);
     zone = nullptr;
     isVoiceAssigned = false;
+
+    if (part && part->processingConcurrently)
+    {
+        // The voice manager and memory pool are shared between parts
+        part->deferVoiceRelease(this);
+        return;
+    }
+    releaseFromEngine();
+}
+
+void Voice::releaseFromEngine()
+{
     engine->voiceManagerResponder.doVoiceEndCallback(this);
     engine->activeVoices--;
+    returnUnisonGenerators();
 
     // We cleanup processors here since they may have, say,
     // memory pool resources checked out that others could
@@ -111,6 +127,13 @@ void Voice::voiceStarted()
 
     forceOversample = zone->parentGroup->outputInfo.oversample;
 
+    startOffset = engine->noteEventSampleOffset;
+    memset(startOffsetCarry, 0, sizeof(startOffsetCarry));
+    carryState = startOffset ? CarryState::CARRYING : CarryState::NO_CARRY;
+    releaseShift = 0;
+    releaseShiftPending = false;
+    hasRenderedBlock = false;
+
     lfosActive = zone->lfosActive;
     egsActive = zone->egsActive;
     phasorsActive = zone->phasorsActive;
@@ -146,7 +169,7 @@ void Voice::voiceStarted()
             stepLfos[i].setSampleRate(sampleRate, sampleRateInv);
 
             stepLfos[i].assign(&zone->modulatorStorage[i], endpoints->lfo[i].rateP,
-                               &engine->transport, engine->rng);
+                               &engine->transport, ownedRNG);
         }
         else if (lfoEvaluator[i] == CURVE)
         {
@@ -166,7 +189,7 @@ void Voice::voiceStarted()
     }
 
     randomEvaluator.evaluate(zone->miscSourceStorage);
-    phasorEvaluator.attack(engine->transport, zone->miscSourceStorage, engine->rng);
+    phasorEvaluator.attack(engine->transport, zone->miscSourceStorage, ownedRNG);
 
     for (int i = 0; i < envFollowersPerGroupOrZone; ++i)
     {
@@ -218,20 +241,193 @@ void Voice::voiceStarted()
 
 bool Voice::process()
 {
+    if (carryState == CarryState::DRAINING)
+    {
+        // The voice finished last block, so all that is left is the end it carried over
+        memset(output, 0, sizeof(output));
+        applyStartOffset();
+        carryState = CarryState::NO_CARRY;
+        return true;
+    }
+
+    bool res;
     if (forceOversample)
-        return processWithOS<true>();
+        res = processWithOS<true>();
     else
-        return processWithOS<false>();
+        res = processWithOS<false>();
+    afterBlockRendered();
+
+    return res;
+}
+
+void Voice::afterBlockRendered()
+{
+    hasRenderedBlock = true;
+
+    if (carryState == CarryState::CARRYING)
+    {
+        applyStartOffset();
+        if (!isVoicePlaying)
+            carryState = CarryState::DRAINING;
+    }
+}
+
+void Voice::release()
+{
+    // A note on and off inside one block just releases from the start of the voice
+    if (isGated && hasRenderedBlock)
+    {
+        releaseShift = (int16_t)engine->noteEventSampleOffset - (int16_t)startOffset;
+        releaseShiftPending = releaseShift != 0;
+    }
+    setIsGated(false);
+}
+
+template <bool OS> const float *Voice::shiftAEGRelease(const float *curve, float *into)
+{
+    static constexpr int n{blockSize << (OS ? 1 : 0)};
+    auto shift = releaseShift * (OS ? 2 : 1);
+    auto first = releaseShiftPending;
+    releaseShiftPending = false;
+
+    if (shift < 0)
+    {
+        // The release began in output we already rendered into the carry. Fade that down
+        // to where the curve starts, so this block can run the curve from its start.
+        releaseShift = 0;
+        if (releaseHeldLevel > 0.f)
+        {
+            auto d = startOffset * (OS ? 2 : 1);
+            auto r = curve[0] / releaseHeldLevel - 1.f;
+            for (int j = 1; j <= -shift; ++j)
+            {
+                auto g = 1.f + r * j / (1 - shift);
+                startOffsetCarry[0][d + shift + j - 1] *= g;
+                startOffsetCarry[1][d + shift + j - 1] *= g;
+            }
+        }
+        return curve;
+    }
+
+    // Before the release hold the level we had, and after it run the curve delayed by
+    // shift, picking up where the end of the last block's curve left off
+    for (int i = 0; i < shift; ++i)
+        into[i] = first ? releaseHeldLevel : releaseCurveCarry[i];
+    for (int i = shift; i < n; ++i)
+        into[i] = curve[i - shift];
+    memcpy(releaseCurveCarry, curve + n - shift, shift * sizeof(float));
+    return into;
+}
+
+void Voice::applyStartOffset()
+{
+    auto n = blockSize << (forceOversample ? 1 : 0);
+    auto d = startOffset << (forceOversample ? 1 : 0);
+    assert(d < n);
+
+    float tail alignas(16)[blockSize << 1];
+    for (int c = 0; c < 2; ++c)
+    {
+        memcpy(tail, output[c] + n - d, d * sizeof(float));
+        memmove(output[c] + d, output[c], (n - d) * sizeof(float));
+        memcpy(output[c], startOffsetCarry[c], d * sizeof(float));
+        memcpy(startOffsetCarry[c], tail, d * sizeof(float));
+    }
 }
 
+#define CALL_ROUTE(FNN)                                                                            \
+    if (chainIsMono)                                                                               \
+    {                                                                                              \
+        if constexpr (OS)                                                                          \
+        {                                                                                          \
+            scxt::dsp::processor::FNN<OS, false>(fpitch, processors, processorConsumesMono,        \
+                                                 processorMixOS, processorLevelOS,                 \
+                                                 endpoints.get(), chainIsMono, output);            \
+        }                                                                                          \
+        else                                                                                       \
+        {                                                                                          \
+            scxt::dsp::processor::FNN<OS, false>(fpitch, processors, processorConsumesMono,        \
+                                                 processorMix, processorLevel, endpoints.get(),    \
+                                                 chainIsMono, output);                             \
+        }                                                                                          \
+    }                                                                                              \
+    else                                                                                           \
+    {                                                                                              \
+        if constexpr (OS)                                                                          \
+        {                                                                                          \
+            scxt::dsp::processor::FNN<OS, true>(fpitch, processors, processorConsumesMono,         \
+                                                processorMixOS, processorLevelOS, endpoints.get(), \
+                                                chainIsMono, output);                              \
+        }                                                                                          \
+        else                                                                                       \
+        {                                                                                          \
+            scxt::dsp::processor::FNN<OS, true>(fpitch, processors, processorConsumesMono,         \
+                                                processorMix, processorLevel, endpoints.get(),     \
+                                                chainIsMono, output);                              \
+        }                                                                                          \
+    }
+
 template <bool OS> bool Voice::processWithOS()
+{
+    if (!beginBlockWithOS<OS>())
+        return true;
+
+    if (blockHasProcs)
+    {
+        bool chainIsMono{blockChainIsMono};
+        auto fpitch{blockPitch};
+
+        switch (zone->outputInfo.procRouting)
+        {
+        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_linear:
+        {
+            CALL_ROUTE(processSequential);
+        }
+        break;
+        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_ser2:
+        {
+            CALL_ROUTE(processSer2Pattern);
+        }
+        break;
+        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_ser3:
+        {
+            CALL_ROUTE(processSer3Pattern);
+        }
+        break;
+        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_par1:
+        {
+            CALL_ROUTE(processPar1Pattern);
+        }
+        break;
+        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_par2:
+        {
+            CALL_ROUTE(processPar2Pattern);
+        }
+        break;
+        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_par3:
+        {
+            CALL_ROUTE(processPar3Pattern);
+        }
+        break;
+        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_bypass:
+            break;
+        }
+
+        blockChainIsMono = chainIsMono;
+    }
+
+    finishBlockWithOS<OS>();
+    return true;
+}
+
+template <bool OS> bool Voice::beginBlockWithOS()
 {
     namespace mech = sst::basic_blocks::mechanics;
 
     if (!isVoicePlaying || !isVoiceAssigned || !zone)
     {
         memset(output, 0, sizeof(output));
-        return true;
+        return false;
     }
 
     noteExpressionLags.processAll();
@@ -326,6 +522,13 @@ template <bool OS> bool Voice::processWithOS()
     doEGRetrigger[0] = false;
     auto aegGate =
         getEnvSpecificGate(envGate, zone->egStorage[0], aeg.stage, isAnyGeneratorRunning);
+    if (releaseShiftPending)
+    {
+        if constexpr (OS)
+            releaseHeldLevel = aegOS.outputCache[(blockSize << 1) - 1];
+        else
+            releaseHeldLevel = aeg.outputCache[blockSize - 1];
+    }
     if constexpr (OS)
     {
         if (rtaeg)
@@ -387,7 +590,7 @@ template <bool OS> bool Voice::processWithOS()
          * pushes past loop end, start which pushes past end, and more. Just a
          * placeholder implementation to get started on that.
          */
-        auto [firstIndex, lastIndex] = sampleIndexRange();
+        auto [firstIndex, lastIndex] = activeSampleIndexRange();
         if (firstIndex >= 0 && lastIndex >= 0)
         {
             int currGen{0};
@@ -397,10 +600,11 @@ template <bool OS> bool Voice::processWithOS()
                 auto &variantData = zone->variantData.variants[currIndex];
                 if (!variantData.playReverse && s)
                 {
-                    GD[currGen].samplePos = std::clamp(
-                        (int64_t)(GD[currGen].playbackLowerBound +
+                    auto &gd = generator(currGen).state;
+                    gd.samplePos = std::clamp(
+                        (int64_t)(gd.playbackLowerBound +
                                   (*endpoints->sampleTarget.startPosP * s->sampleLengthPerChannel)),
-                        (int64_t)0, (int64_t)GD[currGen].playbackUpperBound);
+                        (int64_t)0, (int64_t)gd.playbackUpperBound);
                 }
                 currGen++;
             }
@@ -413,7 +617,7 @@ template <bool OS> bool Voice::processWithOS()
 
     if (samplePlaying)
     {
-        auto [firstIndex, lastIndex] = sampleIndexRange();
+        auto [firstIndex, lastIndex] = activeSampleIndexRange();
         if (firstIndex >= 0)
         {
             for (auto i = firstIndex; i < lastIndex; ++i)
@@ -430,7 +634,7 @@ template <bool OS> bool Voice::processWithOS()
 
         if (useOversampling)
             for (auto i = 0; i < numGeneratorsActive; ++i)
-                GD[i].ratio = GD[i].ratio >> 1;
+                generator(i).state.ratio = generator(i).state.ratio >> 1;
         fpitch -= 69;
 
         memset(output, 0, sizeof(output));
@@ -447,23 +651,25 @@ template <bool OS> bool Voice::processWithOS()
                 auto &variantData = zone->variantData.variants[idx];
 
                 auto gidx = idx - firstIndex;
-                if (isGeneratorRunning[gidx])
+                auto &gen = generator(gidx);
+                auto &gd = gen.state;
+                if (gen.running)
                 {
                     auto &s = zone->samplePointers[idx];
                     assert(s);
 
                     if (gidx == 0)
                     {
-                        GDIO[gidx].outputL = output[0];
-                        GDIO[gidx].outputR = output[1];
+                        gen.io.outputL = output[0];
+                        gen.io.outputR = output[1];
                     }
                     else
                     {
-                        GDIO[gidx].outputL = loutput[0];
-                        GDIO[gidx].outputR = loutput[1];
+                        gen.io.outputL = loutput[0];
+                        gen.io.outputR = loutput[1];
                     }
-                    GD[gidx].sampleStart = 0;
-                    GD[gidx].sampleStop = s->sampleLengthPerChannel;
+                    gd.sampleStart = 0;
+                    gd.sampleStop = s->sampleLengthPerChannel;
 
                     /*
                      * We implement loop for count by gating on loop count
@@ -471,37 +677,36 @@ template <bool OS> bool Voice::processWithOS()
                     if (variantData.loopMode == engine::Zone::LOOP_COUNT)
                     {
                         // first loop is zero so don't skip -1
-                        GD[gidx].gated = GD[gidx].loopCount < variantData.loopCountWhenCounted - 1;
+                        gd.gated = gd.loopCount < variantData.loopCountWhenCounted - 1;
                     }
                     else
                     {
-                        GD[gidx].gated = isGated;
+                        gd.gated = isGated;
                     }
-                    GD[gidx].loopInvertedBounds =
-                        1.f / std::max(1, GD[gidx].loopUpperBound - GD[gidx].loopLowerBound);
-                    GD[gidx].playbackInvertedBounds =
-                        1.f /
-                        std::max(1, GD[gidx].playbackUpperBound - GD[gidx].playbackLowerBound);
+                    gd.loopInvertedBounds =
+                        1.f / std::max(1, gd.loopUpperBound - gd.loopLowerBound);
+                    gd.playbackInvertedBounds =
+                        1.f / std::max(1, gd.playbackUpperBound - gd.playbackLowerBound);
 
-                    if (!GD[gidx].isFinished && Generator[gidx])
+                    if (!gd.isFinished && gen.kernel)
                     {
-                        Generator[gidx](&GD[gidx], &GDIO[gidx]);
+                        gen.kernel(&gd, &gen.io);
                     }
 
-                    inloop = inloop || GD[gidx].isInLoop;
+                    inloop = inloop || gd.isInLoop;
 
-                    if (GD[gidx].isInLoop)
+                    if (gd.isInLoop)
                     {
                         currentLoopPercentageF =
-                            1.0 * (GD[gidx].samplePos - GD[gidx].loopLowerBound) /
-                            (GD[gidx].loopUpperBound - GD[gidx].loopLowerBound);
+                            1.0 * (gd.samplePos - gd.loopLowerBound) /
+                            (gd.loopUpperBound - gd.loopLowerBound);
                     }
                     currentSamplePercentageF =
-                        1.0 * (GD[gidx].samplePos - GD[gidx].playbackLowerBound) /
-                        (GD[gidx].playbackUpperBound - GD[gidx].playbackLowerBound);
+                        1.0 * (gd.samplePos - gd.playbackLowerBound) /
+                        (gd.playbackUpperBound - gd.playbackLowerBound);
 
-                    isGeneratorRunning[gidx] = !GD[gidx].isFinished;
-                    isAnyGeneratorRunning = isAnyGeneratorRunning || isGeneratorRunning[gidx];
+                    gen.running = !gd.isFinished;
+                    isAnyGeneratorRunning = isAnyGeneratorRunning || gen.running;
 
                     if (variantData.normalizationAmplitude != 1.0 || variantData.amplitude != 1.0)
                     {
@@ -509,7 +714,7 @@ template <bool OS> bool Voice::processWithOS()
                                       variantData.amplitude * variantData.amplitude;
                         auto *sl = (gidx == 0 ? output[0] : loutput[0]);
                         auto *sr = (gidx == 0 ? output[1] : loutput[1]);
-                        if (monoGenerator[gidx])
+                        if (gen.mono)
                         {
                             mech::scale_by<scxt::blockSize << (OS ? 1 : 0)>(normBy, sl);
                         }
@@ -530,7 +735,7 @@ template <bool OS> bool Voice::processWithOS()
 
                         auto *sl = (gidx == 0 ? output[0] : loutput[0]);
                         auto *sr = (gidx == 0 ? output[1] : loutput[1]);
-                        if (monoGenerator[gidx])
+                        if (gen.mono)
                         {
                             pl::monoEqualPowerUnityGainAtExtrema(pv, pmat);
                             for (int i = 0; i < blockSize << (OS ? 1 : 0); ++i)
@@ -555,7 +760,7 @@ template <bool OS> bool Voice::processWithOS()
 
                     if (gidx == 0)
                     {
-                        if (monoGenerator[gidx] && !allGeneratorsMono && !panOverridesMono)
+                        if (gen.mono && !allGeneratorsMono && !panOverridesMono)
                         {
                             mech::copy_from_to<scxt::blockSize << (OS ? 1 : 0)>(output[0],
                                                                                 output[1]);
@@ -565,7 +770,7 @@ template <bool OS> bool Voice::processWithOS()
                     {
                         mech::accumulate_from_to<scxt::blockSize << (OS ? 1 : 0)>(loutput[0],
                                                                                   output[0]);
-                        if (!monoGenerator[gidx] && !panOverridesMono)
+                        if (!gen.mono && !panOverridesMono)
                         {
                             mech::accumulate_from_to<scxt::blockSize << (OS ? 1 : 0)>(loutput[1],
                                                                                       output[1]);
@@ -584,7 +789,7 @@ template <bool OS> bool Voice::processWithOS()
                                   zone->variantData.variants[sampleIndex].loopMode ==
                                       engine::Zone::LOOP_COUNT &&
                                   zone->variantData.variants[sampleIndex].loopCountWhenCounted > 0
-                              ? ((float)GD[0].loopCount /
+                              ? ((float)firstGenerator.state.loopCount /
                                  zone->variantData.variants[sampleIndex].loopCountWhenCounted)
                               : 0.f);
 
@@ -683,38 +888,6 @@ template <bool OS> bool Voice::processWithOS()
         }
     }
 
-#define CALL_ROUTE(FNN)                                                                            \
-    if (chainIsMono)                                                                               \
-    {                                                                                              \
-        if constexpr (OS)                                                                          \
-        {                                                                                          \
-            scxt::dsp::processor::FNN<OS, false>(fpitch, processors, processorConsumesMono,        \
-                                                 processorMixOS, processorLevelOS,                 \
-                                                 endpoints.get(), chainIsMono, output);            \
-        }                                                                                          \
-        else                                                                                       \
-        {                                                                                          \
-            scxt::dsp::processor::FNN<OS, false>(fpitch, processors, processorConsumesMono,        \
-                                                 processorMix, processorLevel, endpoints.get(),    \
-                                                 chainIsMono, output);                             \
-        }                                                                                          \
-    }                                                                                              \
-    else                                                                                           \
-    {                                                                                              \
-        if constexpr (OS)                                                                          \
-        {                                                                                          \
-            scxt::dsp::processor::FNN<OS, true>(fpitch, processors, processorConsumesMono,         \
-                                                processorMixOS, processorLevelOS, endpoints.get(), \
-                                                chainIsMono, output);                              \
-        }                                                                                          \
-        else                                                                                       \
-        {                                                                                          \
-            scxt::dsp::processor::FNN<OS, true>(fpitch, processors, processorConsumesMono,         \
-                                                processorMix, processorLevel, endpoints.get(),     \
-                                                chainIsMono, output);                              \
-        }                                                                                          \
-    }
-
     /*
      * This is all voice time type reset logic basically.
      */
@@ -734,6 +907,7 @@ template <bool OS> bool Voice::processWithOS()
             zone->processorStorage[i].type != dsp::processor::proct_none)
         {
             processorType[i] = proct;
+            laneFilterState[i] = {};
             // this is copied below in the init.
             endpoints->processorTarget[i].snapValues();
             processors[i] = dsp::processor::spawnProcessorInPlace(
@@ -760,44 +934,18 @@ template <bool OS> bool Voice::processWithOS()
         hasProcs = hasProcs || processors[i];
     }
 
-    if (hasProcs)
-    {
-        switch (zone->outputInfo.procRouting)
-        {
-        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_linear:
-        {
-            CALL_ROUTE(processSequential);
-        }
-        break;
-        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_ser2:
-        {
-            CALL_ROUTE(processSer2Pattern);
-        }
-        break;
-        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_ser3:
-        {
-            CALL_ROUTE(processSer3Pattern);
-        }
-        break;
-        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_par1:
-        {
-            CALL_ROUTE(processPar1Pattern);
-        }
-        break;
-        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_par2:
-        {
-            CALL_ROUTE(processPar2Pattern);
-        }
-        break;
-        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_par3:
-        {
-            CALL_ROUTE(processPar3Pattern);
-        }
-        break;
-        case engine::HasGroupZoneProcessors<engine::Zone>::procRoute_bypass:
-            break;
-        }
-    }
+    blockPitch = fpitch;
+    blockChainIsMono = chainIsMono;
+    blockForceStereo = !chainIsMono;
+    blockHasProcs = hasProcs;
+    return true;
+}
+
+template <bool OS> void Voice::finishBlockWithOS()
+{
+    namespace mech = sst::basic_blocks::mechanics;
+
+    bool chainIsMono{blockChainIsMono};
 
     if (chainIsMono)
     {
@@ -881,37 +1029,46 @@ template <bool OS> bool Voice::processWithOS()
         }
     }
 
+    float shiftedAEG alignas(16)[blockSize << 1];
     if constexpr (OS)
     {
+        const float *curve = aegOS.outputCache;
+        if (releaseShift)
+            curve = shiftAEGRelease<true>(curve, shiftedAEG);
+
         // At the end of the voice we have to produce stereo
         if (chainIsMono)
         {
-            mech::scale_by<blockSize << 1>(aegOS.outputCache, output[0]);
+            mech::scale_by<blockSize << 1>(curve, output[0]);
             mech::copy_from_to<blockSize << 1>(output[0], output[1]);
         }
         else
         {
-            mech::scale_by<blockSize << 1>(aegOS.outputCache, output[0], output[1]);
+            mech::scale_by<blockSize << 1>(curve, output[0], output[1]);
         }
     }
     else
     {
+        const float *curve = aeg.outputCache;
+        if (releaseShift)
+            curve = shiftAEGRelease<false>(curve, shiftedAEG);
+
         // At the end of the voice we have to produce stereo
         if (chainIsMono)
         {
-            mech::scale_by<blockSize>(aeg.outputCache, output[0]);
+            mech::scale_by<blockSize>(curve, output[0]);
             mech::copy_from_to<blockSize>(output[0], output[1]);
         }
         else
         {
-            mech::scale_by<blockSize>(aeg.outputCache, output[0], output[1]);
+            mech::scale_by<blockSize>(curve, output[0], output[1]);
         }
     }
 
     /*
      * Finally do voice state update
      */
-    if (isAEGRunning && (hasProcs || isAnyGeneratorRunning))
+    if (isAEGRunning && (blockHasProcs || isAnyGeneratorRunning))
     {
         isVoicePlaying = true;
     }
@@ -933,6 +1090,177 @@ template <bool OS> bool Voice::processWithOS()
     {
         keyChangedInLegatoModeTrigger = 0;
     }
+}
+
+bool Voice::beginLockstepBlock()
+{
+    if (forceOversample)
+        lockstepBlockStarted = beginBlockWithOS<true>();
+    else
+        lockstepBlockStarted = beginBlockWithOS<false>();
+    return lockstepBlockStarted;
+}
+
+template <bool OS> void Voice::processLockstepSlotWithOS(int slot)
+{
+    // This is processSequential unrolled one slot at a time, so the forceStereo
+    // choice is the one CALL_ROUTE would have made on entry to the chain
+    if (!dsp::processor::isActive(processors, slot))
+        return;
+
+    if constexpr (OS)
+    {
+        if (blockForceStereo)
+            dsp::processor::runSingleProcessor<OS, true>(
+                slot, blockPitch, processors, processorConsumesMono, processorMixOS,
+                processorLevelOS, endpoints.get(), blockChainIsMono, output, output);
+        else
+            dsp::processor::runSingleProcessor<OS, false>(
+                slot, blockPitch, processors, processorConsumesMono, processorMixOS,
+                processorLevelOS, endpoints.get(), blockChainIsMono, output, output);
+    }
+    else
+    {
+        if (blockForceStereo)
+            dsp::processor::runSingleProcessor<OS, true>(
+                slot, blockPitch, processors, processorConsumesMono, processorMix,
+                processorLevel, endpoints.get(), blockChainIsMono, output, output);
+        else
+            dsp::processor::runSingleProcessor<OS, false>(
+                slot, blockPitch, processors, processorConsumesMono, processorMix,
+                processorLevel, endpoints.get(), blockChainIsMono, output, output);
+    }
+}
+
+void Voice::processLockstepSlot(int slot)
+{
+    if (!lockstepBlockStarted || !blockHasProcs)
+        return;
+
+    if (forceOversample)
+        processLockstepSlotWithOS<true>(slot);
+    else
+        processLockstepSlotWithOS<false>(slot);
+}
+
+bool Voice::runsInLanes(int slot) const
+{
+    // The same test dsp::processor::isActive makes before running the processor
+    return lockstepBlockStarted && blockHasProcs && processors[slot] &&
+           !processors[slot]->isBypassed();
+}
+
+bool Voice::endLockstepBlock()
+{
+    if (lockstepBlockStarted)
+    {
+        if (forceOversample)
+            finishBlockWithOS<true>();
+        else
+            finishBlockWithOS<false>();
+        lockstepBlockStarted = false;
+    }
+    afterBlockRendered();
+
+    return true;
+}
+
+bool Voice::processLockstepSlotInLanes(Voice *const *batch, size_t count, int slot)
+{
+    assert(count <= dsp::processor::QuadVoiceSVF::lanes);
+
+    bool anyOS{false}, anyBase{false};
+    for (size_t b = 0; b < count; ++b)
+    {
+        auto *v = batch[b];
+        if (!v->runsInLanes(slot))
+            continue;
+        if (!dsp::processor::QuadVoiceSVF::supports(v->processors[slot]->getType(),
+                                                    v->processorIntParams[slot]))
+            return false;
+        anyOS = anyOS || v->forceOversample;
+        anyBase = anyBase || !v->forceOversample;
+    }
+
+    // The lanes run at one rate, so a batch straddling an oversample change takes two passes
+    if (anyOS)
+        processLockstepSlotInLanesWithOS<true>(batch, count, slot);
+    if (anyBase)
+        processLockstepSlotInLanesWithOS<false>(batch, count, slot);
+    return true;
+}
+
+template <bool OS>
+void Voice::processLockstepSlotInLanesWithOS(Voice *const *batch, size_t count, int slot)
+{
+    namespace mech = sst::basic_blocks::mechanics;
+    using svf_t = dsp::processor::QuadVoiceSVF;
+    static constexpr int n{blockSize << (OS ? 1 : 0)};
+
+    svf_t svf;
+    float wet alignas(16)[svf_t::lanes][2][blockSize << 2];
+    float *in[svf_t::lanes][2]{}, *out[svf_t::lanes][2]{};
+
+    for (size_t b = 0; b < count; ++b)
+    {
+        auto *v = batch[b];
+        if (!v->runsInLanes(slot) || v->forceOversample != OS)
+            continue;
+
+        auto *proc = v->processors[slot];
+        auto &pt = v->endpoints->processorTarget[slot];
+        pt.snapValues();
+
+        // Mono in and out where the processor would have been, otherwise stereo like it
+        auto monoOut = !v->blockForceStereo && v->blockChainIsMono &&
+                       v->processorConsumesMono[slot] && !proc->monoInputCreatesStereoOutput();
+        if (v->blockChainIsMono && !monoOut)
+        {
+            mech::copy_from_to<n>(v->output[0], v->output[1]);
+            v->blockChainIsMono = false;
+        }
+
+        auto pitch = proc->isKeytracked() ? v->blockPitch : 0.f;
+        svf.setLane(b, pt.fp, v->processorIntParams[slot], pitch,
+                    v->sampleRateInv * (OS ? 0.5 : 1.0), v->laneFilterState[slot]);
+        for (int c = 0; c < (monoOut ? 1 : 2); ++c)
+        {
+            in[b][c] = v->output[c];
+            out[b][c] = wet[b][c];
+        }
+    }
+
+    svf.process<n>(in, out);
+
+    for (size_t b = 0; b < count; ++b)
+    {
+        if (!in[b][0])
+            continue;
+
+        auto *v = batch[b];
+        svf.storeLane(b, v->laneFilterState[slot]);
+        if constexpr (OS)
+            dsp::processor::mixProcessorOutput(slot, v->processorMixOS, v->processorLevelOS,
+                                               v->endpoints.get(), v->blockChainIsMono, v->output,
+                                               wet[b]);
+        else
+            dsp::processor::mixProcessorOutput(slot, v->processorMix, v->processorLevel,
+                                               v->endpoints.get(), v->blockChainIsMono, v->output,
+                                               wet[b]);
+    }
+}
+
+bool Voice::processorsMatchZone() const
+{
+    for (int i = 0; i < processorsPerZoneAndGroup; ++i)
+    {
+        auto proct = processors[i] ? processors[i]->getType() : dsp::processor::proct_none;
+        if (zone->processorStorage[i].type != proct)
+            return false;
+        if (!processors[i] && zone->processorStorage[i].isActive &&
+            zone->processorStorage[i].type != dsp::processor::proct_none)
+            return false;
+    }
     return true;
 }
 
@@ -972,6 +1300,9 @@ void Voice::initializeGenerator()
     allGeneratorsMono = true;
     isAnyGeneratorRunning = false;
 
+    // The pitch is the same for every generator and the processors want it too
+    voiceStartPitch = calculateVoicePitch();
+
     if (sampleIndex < 0)
     {
         return;
@@ -980,95 +1311,56 @@ void Voice::initializeGenerator()
     // but the default of course is to use the sample index
     auto [firstIndex, lastIndex] = sampleIndexRange();
 
+    engine::Zone::VoiceStartDescriptor scratch;
     for (auto i = firstIndex; i < lastIndex; ++i)
     {
-        if (zone->samplePointers[i]->isMissingPlaceholder)
+        if (!zone->getVoiceStartDescriptor(i, scratch).playable)
         {
             return;
         }
     }
     numGeneratorsActive = lastIndex - firstIndex;
+    if (numGeneratorsActive > 1 && !checkoutUnisonGenerators())
+    {
+        SCLOG_IF(generatorInitialization, "No unison generators free; playing first variant");
+        numGeneratorsActive = 1;
+        lastIndex = firstIndex + 1;
+    }
 
     int currGen{0};
     allGeneratorsMono = true;
     for (auto currIndex = firstIndex; currIndex < lastIndex; currIndex++)
     {
-        auto &s = zone->samplePointers[currIndex];
+        const auto &vsd = zone->getVoiceStartDescriptor(currIndex, scratch);
 
-        auto &variantData = zone->variantData.variants[currIndex];
+        auto &gen = generator(currGen);
+        gen.state = vsd.state;
+        gen.io = vsd.io;
+        gen.io.outputL = output[0];
+        gen.io.outputR = output[1];
 
-        GDIO[currGen].outputL = output[0];
-        GDIO[currGen].outputR = output[1];
-        if (s->bitDepth == sample::Sample::BD_I16)
-        {
-            GDIO[currGen].sampleDataL = s->GetSamplePtrI16(0);
-            GDIO[currGen].sampleDataR = s->GetSamplePtrI16(1);
-        }
-        else if (s->bitDepth == sample::Sample::BD_F32)
-        {
-            GDIO[currGen].sampleDataL = s->GetSamplePtrF32(0);
-            GDIO[currGen].sampleDataR = s->GetSamplePtrF32(1);
-        }
-        else
-        {
-            assert(false);
-        }
-        GDIO[currGen].waveSize = s->sampleLengthPerChannel;
-
-        GD[currGen].samplePos = variantData.startSample;
-        GD[currGen].sampleSubPos = 0;
-        GD[currGen].loopLowerBound = variantData.startSample;
-        GD[currGen].loopUpperBound = variantData.endSample;
-        GD[currGen].loopFade = variantData.loopFade;
-        GD[currGen].playbackLowerBound = variantData.startSample;
-        GD[currGen].playbackUpperBound = variantData.endSample;
-        GD[currGen].direction = 1;
-        GD[currGen].isFinished = false;
-
-        if (variantData.loopActive)
-        {
-            GD[currGen].loopLowerBound = variantData.startLoop;
-            GD[currGen].loopUpperBound = variantData.endLoop;
-        }
-
-        if (variantData.playReverse)
-        {
-            GD[currGen].samplePos = GD[currGen].playbackUpperBound;
-            GD[currGen].direction = -1;
-        }
-        GD[currGen].directionAtOutset = GD[currGen].direction;
-
-        calculateGeneratorRatio(calculateVoicePitch(), currIndex, currGen);
+        calculateGeneratorRatio(voiceStartPitch, currIndex, currGen);
 
         // TODO: This constant came from SC. Wonder why it is this value. There was a comment
         // comparing with 167777216 so any speedup at all.
-        useOversampling = std::abs(GD[currGen].ratio) > 18000000 || forceOversample;
-        GD[currGen].blockSize = blockSize * (useOversampling ? 2 : 1);
+        useOversampling = std::abs(gen.state.ratio) > 18000000 || forceOversample;
+        gen.state.blockSize = blockSize * (useOversampling ? 2 : 1);
 
-        if (!forceOversample && (variantData.interpolationType == dsp::ZeroOrderHold ||
-                                 variantData.interpolationType == dsp::ZOHAA))
+        if (!forceOversample && !vsd.allowOversampling)
             useOversampling = false;
 
-        Generator[currGen] = nullptr;
-
-        monoGenerator[currGen] = s->channels == 1;
-        allGeneratorsMono = allGeneratorsMono && monoGenerator[currGen] &&
-                            (variantData.pan < 0.01f && variantData.pan > -0.01f);
-        Generator[currGen] = dsp::GetFPtrGeneratorSample(
-            !monoGenerator[currGen], s->bitDepth == sample::Sample::BD_F32, variantData.loopActive,
-            variantData.loopDirection == engine::Zone::FORWARD_ONLY,
-
-            // We doo loop count by gating on loopCount < maxLoopCount
-            variantData.loopMode == engine::Zone::LOOP_WHILE_GATED ||
-                variantData.loopMode == engine::Zone::LOOP_COUNT);
+        // pan can glide under the UI lag so it is read live rather than compiled
+        auto pan = zone->variantData.variants[currIndex].pan;
+        gen.mono = vsd.mono;
+        allGeneratorsMono = allGeneratorsMono && vsd.mono && (pan < 0.01f && pan > -0.01f);
+        gen.kernel = vsd.generator;
+        SCLOG_IF(generatorInitialization,
+                 "Generator : " << SCD(currGen) << SCD((size_t)gen.kernel));
         SCLOG_IF(generatorInitialization,
-                 "Generator : " << SCD(currGen) << SCD((size_t)Generator[currGen]));
-        SCLOG_IF(generatorInitialization, "     SMP  : " << SCD(GDIO[currGen].sampleDataL)
-                                                         << SCD(GDIO[currGen].sampleDataR));
-        SCLOG_IF(generatorInitialization, "     SLE  : " << SCD(GDIO[currGen].waveSize));
+                 "     SMP  : " << SCD(gen.io.sampleDataL) << SCD(gen.io.sampleDataR));
+        SCLOG_IF(generatorInitialization, "     SLE  : " << SCD(gen.io.waveSize));
 
-        GD[currGen].interpolationType = variantData.interpolationType;
-        isGeneratorRunning[currGen] = true;
+        gen.running = true;
         isAnyGeneratorRunning = true;
 
         currGen++;
@@ -1204,7 +1496,7 @@ void Voice::calculateGeneratorRatio(float pitch, int cSampleIndex, int generator
 
     auto fac = tuning::equalTuning.note_to_pitch(ndiff);
 
-    GD[generatorIndex].ratio =
+    generator(generatorIndex).state.ratio =
         (int32_t)((1 << 24) * fac * zone->samplePointers[cSampleIndex]->sample_rate *
                   sampleRateInv * (1.0 + *endpoints->mappingTarget.playbackRatioP));
 }
@@ -1219,9 +1511,10 @@ void Voice::initializeProcessors()
     outputPan.set_target_instant(*endpoints->outputTarget.panP);
     outputAmp.set_target_instant(*endpoints->outputTarget.ampP);
 
-    auto fpitch = calculateVoicePitch();
+    auto fpitch = voiceStartPitch;
     for (auto i = 0; i < engine::processorCount; ++i)
     {
+        laneFilterState[i] = {};
         processorIsActive[i] = zone->processorStorage[i].isActive;
         processorMix[i].set_target_instant(*endpoints->processorTarget[i].mixP);
         processorMixOS[i].set_target_instant(*endpoints->processorTarget[i].mixP);
@@ -1316,4 +1609,33 @@ std::pair<int16_t, int16_t> Voice::sampleIndexRange() const
 
     return {firstIndex, lastIndex};
 }
+
+std::pair<int16_t, int16_t> Voice::activeSampleIndexRange() const
+{
+    auto [firstIndex, lastIndex] = sampleIndexRange();
+    if (firstIndex >= 0)
+        lastIndex = std::min<int16_t>(lastIndex, firstIndex + numGeneratorsActive);
+    return {firstIndex, lastIndex};
+}
+
+bool Voice::checkoutUnisonGenerators()
+{
+    assert(!unisonGenerators);
+    auto *block = engine->getMemoryPool()->checkoutBlock(unisonGeneratorBytes);
+    if (!block)
+        return false;
+    unisonGenerators = reinterpret_cast<GeneratorSlot *>(block);
+    for (int i = 0; i < maxGeneratorsPerVoice - 1; ++i)
+        new (unisonGenerators + i) GeneratorSlot();
+    return true;
+}
+
+void Voice::returnUnisonGenerators()
+{
+    if (!unisonGenerators)
+        return;
+    auto *block = reinterpret_cast<engine::MemoryPool::data_t *>(unisonGenerators);
+    engine->getMemoryPool()->returnBlock(block, unisonGeneratorBytes);
+    unisonGenerators = nullptr;
+}
 } // namespace scxt::voice
@@ -28,11 +28,14 @@
 #ifndef SCXT_SRC_SCXT_CORE_VOICE_VOICE_H
 #define SCXT_SRC_SCXT_CORE_VOICE_VOICE_H
 
+#include <cassert>
+
 #include "engine/zone.h"
 #include "engine/engine.h"
 #include "dsp/data_tables.h"
 #include "dsp/generator.h"
 #include "dsp/processor/processor.h"
+#include "dsp/processor/quad_voice_filter.h"
 
 #include "modulation/voice_matrix.h"
 #include "modulation/has_modulators.h"
@@ -48,6 +51,7 @@ namespace scxt::voice
 {
 struct alignas(16) Voice : MoveableOnly<Voice>,
                            SampleRateSupport,
+                           scxt::modulation::shared::OwnedRNG,
                            scxt::modulation::shared::HasModulators<Voice, egsPerZone>
 {
     float output alignas(16)[2][blockSize << 2];
@@ -63,14 +67,37 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
 
     bool forceOversample{true};
 
-    std::array<dsp::GeneratorState, maxGeneratorsPerVoice> GD;
-    std::array<dsp::GeneratorIO, maxGeneratorsPerVoice> GDIO;
-    std::array<dsp::GeneratorFPtr, maxGeneratorsPerVoice> Generator;
-    std::array<bool, maxGeneratorsPerVoice> monoGenerator{};
+    /*
+     * Everything one generator touches each block sits together in a slot. Most voices
+     * play a single sample, so the first slot lives in the voice. The rest are only used
+     * in unison, so a unison voice checks them out of the engine memory pool when it
+     * starts, and plays just its first variant if the pool is dry.
+     */
+    struct GeneratorSlot
+    {
+        dsp::GeneratorState state;
+        dsp::GeneratorIO io;
+        dsp::GeneratorFPtr kernel{nullptr};
+        bool mono{false}, running{false};
+    };
+    static constexpr size_t unisonGeneratorBytes{sizeof(GeneratorSlot) *
+                                                 (maxGeneratorsPerVoice - 1)};
+    GeneratorSlot firstGenerator;
+    GeneratorSlot *unisonGenerators{nullptr};
+    GeneratorSlot &generator(int i)
+    {
+        assert(i >= 0 && i < numGeneratorsActive);
+        return i == 0 ? firstGenerator : unisonGenerators[i - 1];
+    }
+    bool checkoutUnisonGenerators();
+    void returnUnisonGenerators();
+
     bool allGeneratorsMono{};
     int16_t numGeneratorsActive{0};
 
     std::pair<int16_t, int16_t> sampleIndexRange() const;
+    // The part of sampleIndexRange this voice has generators for
+    std::pair<int16_t, int16_t> activeSampleIndexRange() const;
 
     sst::filters::HalfRate::HalfRateFilter halfRate;
 
@@ -221,13 +248,48 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     bool process();
     template <bool OS> bool processWithOS();
 
+    /**
+     * process() split into its three stages so a zone can run several voices through
+     * the processor slots in lockstep. Begin runs modulators and generators and resets
+     * processors; each slot call is one step of processSequential; end is the output
+     * stage and returns what process() would have.
+     */
+    bool beginLockstepBlock();
+    void processLockstepSlot(int slot);
+    bool endLockstepBlock();
+
+    /**
+     * Run one processor slot for a lockstep batch with the voices packed into the SIMD
+     * lanes of a QuadVoiceSVF. Returns false, having done nothing, unless every started
+     * voice in the batch holds a filter in that slot the lanes can stand in for.
+     */
+    static bool processLockstepSlotInLanes(Voice *const *batch, size_t count, int slot);
+
+    /**
+     * Render ahead of the zone mix, possibly off the audio thread. The zone
+     * consumes preRenderResult in place of calling process() for this block.
+     */
+    void preRender()
+    {
+        preRenderResult = process();
+        preRendered = true;
+    }
+    bool preRendered{false}, preRenderResult{false};
+
+    /**
+     * The voice time processor reset logic in processWithOS spawns from the engine
+     * memory pool. Voices where it would do so this block are not safe to render
+     * off the audio thread.
+     */
+    bool processorsMatchZone() const;
+
     /**
      * Voice Setup
      */
     void voiceStarted();
 
     /**
-     * Initialize the dsp generator state
+     * Initialize the dsp generator state from the zone's voice start descriptors
      */
     void initializeGenerator();
 
@@ -273,6 +335,7 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
      * Voice State on Creation
      */
     bool useOversampling{false};
+    float voiceStartPitch{0.f}; // calculated once in initializeGenerator
 
     /*
      * Voice Playback State Model.
@@ -286,13 +349,59 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
         isReleasedF = g ? 0.f : 1.f;
     };
 
-    std::array<bool, maxGeneratorsPerVoice> isGeneratorRunning{};
     bool isAnyGeneratorRunning{};
     bool isAEGRunning{false};
 
     bool isVoicePlaying{false};
     bool isVoiceAssigned{false};
 
+    /*
+     * A voice started part way into a block renders from the block start and is
+     * delayed by startOffset samples, carrying the end of each block into the next.
+     * When it stops it is DRAINING for one more block, which lets the carried end out
+     * before the zone cleans it up.
+     */
+    enum struct CarryState : uint8_t
+    {
+        NO_CARRY,
+        CARRYING,
+        DRAINING
+    } carryState{CarryState::NO_CARRY};
+    uint16_t startOffset{0};
+    float startOffsetCarry alignas(16)[2][blockSize << 1];
+    void applyStartOffset();
+    // Still producing output, either rendering or draining its carry
+    bool isSounding() const { return isVoicePlaying || carryState == CarryState::DRAINING; }
+
+    /*
+     * A release drops the gate for the whole next voice block. releaseShift is where in
+     * that block, relative to its start, the release event actually landed. When it is
+     * positive the AEG curve is delayed by that much for the rest of the voice, with
+     * releaseCurveCarry holding the end of each block's curve for the next. When it is
+     * negative the event landed in output already rendered into the start offset carry,
+     * which is faded down to where the release curve starts.
+     */
+    int16_t releaseShift{0};
+    bool releaseShiftPending{false}, hasRenderedBlock{false};
+    float releaseHeldLevel{0.f};
+    float releaseCurveCarry alignas(16)[blockSize << 1];
+    template <bool OS> const float *shiftAEGRelease(const float *curve, float *into);
+
+    template <bool OS> bool beginBlockWithOS();
+    template <bool OS> void processLockstepSlotWithOS(int slot);
+    template <bool OS> void finishBlockWithOS();
+    // State carried from beginBlockWithOS through the processor chain to finishBlockWithOS
+    float blockPitch{0.f};
+    bool blockChainIsMono{false}, blockForceStereo{false}, blockHasProcs{false};
+    bool lockstepBlockStarted{false};
+    void afterBlockRendered();
+    bool runsInLanes(int slot) const;
+
+    template <bool OS>
+    static void processLockstepSlotInLanesWithOS(Voice *const *batch, size_t count, int slot);
+    // Filter state for the slots when they run in lanes rather than in their processor
+    dsp::processor::QuadVoiceSVF::VoiceState laneFilterState[engine::processorCount];
+
     int16_t terminationSequence{-1};
     // how many blocks is the early-terminate/steal fade
     static constexpr int blocksToTerminateAt48k{8};
@@ -320,7 +429,7 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
     }
     bool firstSamplePlayback{false};
 
-    void release() { setIsGated(false); }
+    void release();
     void beginTerminationSequence()
     {
         // 8 block fade at 48k
@@ -331,6 +440,8 @@ struct alignas(16) Voice : MoveableOnly<Voice>,
         terminationSequence = blocksToTerminate;
     }
     void cleanupVoice();
+    // The engine-wide half of cleanupVoice, deferred when the part runs concurrently
+    void releaseFromEngine();
 
     void onSampleRateChanged() override;
 };
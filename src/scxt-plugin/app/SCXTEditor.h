@@ -164,6 +164,8 @@ struct SCXTEditor : sst::jucegui::components::WindowPanel,
         void timerCallback() override { editor->idle(); }
     };
     std::unique_ptr<IdleTimer> idleTimer;
+    // The engine paces coalesced updates to this too
+    static constexpr int idleTimerHz{60};
 
     std::unique_ptr<shared::HeaderRegion> headerRegion;
     std::unique_ptr<edit_screen::EditScreen> editScreen;
@@ -242,7 +244,8 @@ struct SCXTEditor : sst::jucegui::components::WindowPanel,
     void onEngineStatus(const engine::Engine::EngineStatusMessage &e);
     void onMappingUpdated(const scxt::messaging::client::mappingSelectedZoneViewResposne_t &);
     void onSamplesUpdated(const scxt::messaging::client::sampleSelectedZoneViewResposne_t &);
-    void onStructureUpdated(const engine::Engine::pgzStructure_t &);
+    void onStructureUpdated(const engine::Engine::pgzVersionedStructure_t &);
+    void onStructureDelta(const engine::Engine::pgzStructureDelta_t &);
     void
     onGroupOrZoneEnvelopeUpdated(const scxt::messaging::client::adsrViewResponsePayload_t &payload);
     void onGroupOrZoneProcessorDataAndMetadata(
@@ -295,6 +298,8 @@ struct SCXTEditor : sst::jucegui::components::WindowPanel,
 
     scxt::messaging::client::tuningStatusPayload_t tuningStatus;
     void onTuningStatus(const scxt::messaging::client::tuningStatusPayload_t &);
+    void onMemoryPoolStats(const scxt::messaging::client::memoryPoolStats_t &);
+    void onLatencyReport(const scxt::messaging::client::latencyReport_t &);
 
     std::array<std::array<scxt::engine::Macro, scxt::macrosPerPart>, scxt::numParts> macroCache;
     void onMacroFullState(const scxt::messaging::client::macroFullState_t &);
@@ -391,7 +396,6 @@ struct SCXTEditor : sst::jucegui::components::WindowPanel,
     /*
      * Items to deal with the shared memory reads
      */
-    int64_t lastVoiceDisplayWriteCounter{-1};
     float lastProcessMemoryInMegabytes{0};
 
     friend struct HasEditor;
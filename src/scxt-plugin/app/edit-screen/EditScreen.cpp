@@ -86,15 +86,14 @@ void EditScreen::layout()
 void EditScreen::onVoiceInfoChanged()
 {
     voiceCountByZoneAddress.clear();
-    for (const auto &v : editor->sharedUiMemoryState.voiceDisplayItems)
+    const auto &vds = editor->sharedUiMemoryState.voiceDisplay.read();
+    for (int i = 0; i < vds.itemCount; ++i)
     {
-        if (v.active)
-        {
-            auto sa = selection::SelectionManager::ZoneAddress(v.part, v.group, v.zone);
-            if (voiceCountByZoneAddress.find(sa) == voiceCountByZoneAddress.end())
-                voiceCountByZoneAddress[sa] = 0;
-            voiceCountByZoneAddress[sa]++;
-        }
+        const auto &v = vds.items[i];
+        auto sa = selection::SelectionManager::ZoneAddress(v.part, v.group, v.zone);
+        if (voiceCountByZoneAddress.find(sa) == voiceCountByZoneAddress.end())
+            voiceCountByZoneAddress[sa] = 0;
+        voiceCountByZoneAddress[sa]++;
     }
 
     mappingPane->repaint();
@@ -106,6 +106,32 @@ template <typename SidebarParent, bool fz> struct GroupZoneSidebarWidget : jcmp:
                 gzData.push_back(el);
     }
 
+    /*
+     * Edits from a structure delta, in rows of this list rather than of the whole
+     * structure, so a delta only moves the rows it touches. Call refresh after.
+     */
+    void removeRows(size_t at, size_t count)
+    {
+        assert(at + count <= gzData.size());
+        gzData.erase(gzData.begin() + at, gzData.begin() + at + count);
+    }
+    template <typename It> void insertRows(size_t at, It from, It to)
+    {
+        assert(at <= gzData.size());
+        gzData.insert(gzData.begin() + at, from, to);
+    }
+    template <typename It> void updateRows(size_t at, It from, It to)
+    {
+        assert(at + (size_t)std::distance(from, to) <= gzData.size());
+        std::copy(from, to, gzData.begin() + at);
+    }
+    // Removing a zone shifts the address of every zone after it
+    template <typename It> void renumberRows(It from)
+    {
+        for (auto &el : gzData)
+            el.address = (from++)->address;
+    }
+
     selection::SelectionManager::ZoneAddress getZoneAddress(int rowNumber)
     {
         auto &tgl = gzData;
@@ -955,9 +955,11 @@ void PartGroupSidebar::resized()
         zoneSidebar->setBounds(getContentArea());
 }
 
-void PartGroupSidebar::setPartGroupZoneStructure(const engine::Engine::pgzStructure_t &p)
+void PartGroupSidebar::setPartGroupZoneStructure(uint64_t version,
+                                                 const engine::Engine::pgzStructure_t &p)
 {
     pgzStructure = p;
+    pgzStructureVersion = version;
 #if LOG_PART_GROUP_SIDEBAR
     SCLOG_IF(debug, "PartGroupZone in Sidebar: Showing Part0 Entries");
     for (const auto &a : pgzStructure)
@@ -983,6 +985,89 @@ void PartGroupSidebar::setPartGroupZoneStructure(const engine::Engine::pgzStruct
     repaint();
 }
 
+void PartGroupSidebar::applyPartGroupZoneStructureDelta(
+    uint64_t version, const std::vector<engine::Engine::pgzDeltaOp_t> &ops)
+{
+    /*
+     * The group and zone lists show the group and zone rows of the selected part, which
+     * sit together in the structure. Follow each op and move just the list rows it
+     * overlaps, so a change elsewhere leaves the lists be and a change here doesn't
+     * rebuild them.
+     */
+    auto sp = editor->selectedPart;
+    auto selectedRows = [this, sp]() {
+        auto b = std::partition_point(pgzStructure.begin(), pgzStructure.end(),
+                                      [sp](const auto &el) { return el.address.part < sp; });
+        auto e = std::partition_point(b, pgzStructure.end(),
+                                      [sp](const auto &el) { return el.address.part == sp; });
+        while (b != e && b->address.group < 0)
+            ++b;
+        return std::make_pair((size_t)(b - pgzStructure.begin()),
+                              (size_t)(e - pgzStructure.begin()));
+    };
+    auto overlap = [](size_t idx, size_t count, std::pair<size_t, size_t> rows) {
+        return std::make_pair(std::max(idx, rows.first), std::min(idx + count, rows.second));
+    };
+    auto eachList = [this](auto &&f) {
+        f(*groupSidebar->gzTreeControl);
+        f(*zoneSidebar->gzTreeControl);
+    };
+
+    bool touchesSelectedPart{false};
+    for (const auto &op : ops)
+    {
+        const auto &[kind, idx, count, entries] = op;
+        auto at = (size_t)std::max(idx, 0);
+
+        if (kind == engine::Engine::PGZ_REMOVE)
+        {
+            auto rows = selectedRows();
+            auto [b, e] = overlap(at, (size_t)count, rows);
+            if (b < e)
+            {
+                eachList([&, b = b, e = e](auto &tc) { tc.removeRows(b - rows.first, e - b); });
+                touchesSelectedPart = true;
+            }
+        }
+
+        engine::Engine::applyPartGroupZoneStructureOp(pgzStructure, op);
+
+        if (kind != engine::Engine::PGZ_REMOVE)
+        {
+            auto rows = selectedRows();
+            auto [b, e] = overlap(at, entries.size(), rows);
+            if (b < e)
+            {
+                auto from = pgzStructure.begin() + b, to = pgzStructure.begin() + e;
+                auto row = b - rows.first;
+                bool insert = kind == engine::Engine::PGZ_INSERT;
+                eachList([=](auto &tc) {
+                    if (insert)
+                        tc.insertRows(row, from, to);
+                    else
+                        tc.updateRows(row, from, to);
+                });
+                touchesSelectedPart = true;
+            }
+        }
+    }
+
+    engine::Engine::renumberPartGroupZoneStructure(pgzStructure);
+    pgzStructureVersion = version;
+
+    if (touchesSelectedPart)
+    {
+        auto from = pgzStructure.begin() + selectedRows().first;
+        eachList([from](auto &tc) {
+            tc.renumberRows(from);
+            tc.refresh();
+        });
+    }
+
+    editorSelectionChanged();
+    repaint();
+}
+
 void PartGroupSidebar::selectedPartChanged()
 {
     groupSidebar->showSelectedPart(editor->selectedPart);
@@ -48,7 +48,10 @@ struct PartGroupSidebar : sst::jucegui::components::NamedPanel,
     ~PartGroupSidebar();
 
     engine::Engine::pgzStructure_t pgzStructure;
-    void setPartGroupZoneStructure(const engine::Engine::pgzStructure_t &p);
+    uint64_t pgzStructureVersion{0};
+    void setPartGroupZoneStructure(uint64_t version, const engine::Engine::pgzStructure_t &p);
+    void applyPartGroupZoneStructureDelta(uint64_t version,
+                                          const std::vector<engine::Engine::pgzDeltaOp_t> &ops);
     void editorSelectionChanged();
     void selectedPartChanged();
 
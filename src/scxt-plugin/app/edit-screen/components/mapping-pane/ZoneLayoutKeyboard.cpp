@@ -41,9 +41,11 @@ void ZoneLayoutKeyboard::paint(juce::Graphics &g)
 {
     std::array<int, 128> midiState; // 0 == 0ff, 1 == gated, 2 == sounding
     std::fill(midiState.begin(), midiState.end(), 0);
-    for (const auto &vd : display->editor->sharedUiMemoryState.voiceDisplayItems)
+    const auto &vds = display->editor->sharedUiMemoryState.voiceDisplay.read();
+    for (int i = 0; i < vds.itemCount; ++i)
     {
-        if (vd.active && vd.midiNote >= 0)
+        const auto &vd = vds.items[i];
+        if (vd.midiNote >= 0)
         {
             midiState[vd.midiNote] = vd.gated ? 1 : 2;
         }
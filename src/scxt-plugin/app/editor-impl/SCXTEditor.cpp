@@ -122,7 +122,7 @@ SCXTEditor::SCXTEditor(messaging::MessageController &e, infrastructure::Defaults
     keyBindings = std::make_unique<KeyBindings>(this);
 
     idleTimer = std::make_unique<IdleTimer>(this);
-    idleTimer->startTimer(1000 / 60);
+    idleTimer->startTimer(1000 / idleTimerHz);
 
     namespace cmsg = scxt::messaging::client;
     msgCont.registerClient("SCXTEditor", [this](auto &s) {
@@ -136,6 +136,7 @@ SCXTEditor::SCXTEditor(messaging::MessageController &e, infrastructure::Defaults
                 w->drainCallbackQueue();
         });
     });
+    sendToSerialization(cmsg::SetClientFrameRate(idleTimerHz));
 }
 
 SCXTEditor::~SCXTEditor() noexcept
@@ -236,12 +237,13 @@ void SCXTEditor::idle()
      * not for handling events which the message controller does
      * immediately
      */
-    if (sharedUiMemoryState.voiceDisplayStateWriteCounter != lastVoiceDisplayWriteCounter)
+    // Everything on this thread reads the snapshot taken here until the next idle
+    if (sharedUiMemoryState.voiceDisplay.acquireLatest())
     {
-        lastVoiceDisplayWriteCounter = sharedUiMemoryState.voiceDisplayStateWriteCounter;
-        if (headerRegion->voiceCount != sharedUiMemoryState.voiceCount)
+        const auto &vds = sharedUiMemoryState.voiceDisplay.read();
+        if (headerRegion->voiceCount != vds.voiceCount)
         {
-            headerRegion->setVoiceCount(sharedUiMemoryState.voiceCount);
+            headerRegion->setVoiceCount(vds.voiceCount);
 
             if (editScreen->isVisible())
             {
@@ -259,9 +261,11 @@ void SCXTEditor::idle()
         {
             bool anyActive{false};
             editScreen->clearSamplePlaybackPositions();
-            for (const auto &v : sharedUiMemoryState.voiceDisplayItems)
+            const auto &vds = sharedUiMemoryState.voiceDisplay.read();
+            for (int i = 0; i < vds.itemCount; ++i)
             {
-                if (v.active && v.group == currentLeadZoneSelection->group &&
+                const auto &v = vds.items[i];
+                if (v.group == currentLeadZoneSelection->group &&
                     v.part == currentLeadZoneSelection->part &&
                     v.zone == currentLeadZoneSelection->zone)
                 {
@@ -278,7 +282,8 @@ void SCXTEditor::idle()
                                  sharedUiMemoryState.busVULevels[0][1]);
         headerRegion->setCPULevel((double)sharedUiMemoryState.cpuLevel);
 
-        headerRegion->setMemUsage(sampleManager.sampleMemoryInBytes);
+        headerRegion->setMemUsage(sampleManager.sampleMemoryInBytes +
+                                  sharedUiMemoryState.memoryPoolBytes.load());
     }
     if (mixerScreen && mixerScreen->isVisible())
     {
@@ -38,6 +38,7 @@
 #include "app/shared/HeaderRegion.h"
 #include "app/edit-screen/components/MacroMappingVariantPane.h"
 #include "app/other-screens/AboutScreen.h"
+#include "app/other-screens/LogScreen.h"
 #include "app/browser-ui/BrowserPane.h"
 #include "app/play-screen/PlayScreen.h"
 #include "app/missing-resolution/MissingResolutionScreen.h"
@@ -118,17 +119,36 @@ void SCXTEditor::onSamplesUpdated(
     }
 }
 
-void SCXTEditor::onStructureUpdated(const engine::Engine::pgzStructure_t &s)
+void SCXTEditor::onStructureUpdated(const engine::Engine::pgzVersionedStructure_t &s)
 {
     if (editScreen && editScreen->partSidebar)
     {
-        editScreen->partSidebar->setPartGroupZoneStructure(s);
+        editScreen->partSidebar->setPartGroupZoneStructure(s.first, s.second);
     }
     if (editScreen && editScreen->mappingPane)
     {
     }
 }
 
+void SCXTEditor::onStructureDelta(const engine::Engine::pgzStructureDelta_t &d)
+{
+    const auto &[fromVersion, toVersion, ops] = d;
+    if (!editScreen || !editScreen->partSidebar)
+        return;
+
+    auto &sb = editScreen->partSidebar;
+    if (sb->pgzStructureVersion != fromVersion)
+    {
+        // We missed a step somewhere, so start over from a full structure
+        namespace cmsg = scxt::messaging::client;
+        SCLOG_IF(uiStructure, "Structure delta from " << fromVersion << " but we have "
+                                                      << sb->pgzStructureVersion << "; resyncing");
+        sendToSerialization(cmsg::PartGroupZoneStructure(-1));
+        return;
+    }
+    sb->applyPartGroupZoneStructureDelta(toVersion, ops);
+}
+
 void SCXTEditor::onGroupOrZoneProcessorDataAndMetadata(
     const scxt::messaging::client::processorDataResponsePayload_t &d)
 {
@@ -485,6 +505,23 @@ void SCXTEditor::onActivityNotification(
     }
 }
 
+void SCXTEditor::onMemoryPoolStats(const scxt::messaging::client::memoryPoolStats_t &stats)
+{
+    if (headerRegion)
+    {
+        headerRegion->showMemoryPoolStats(stats);
+    }
+}
+
+void SCXTEditor::onLatencyReport(const scxt::messaging::client::latencyReport_t &report)
+{
+    // Into the log rather than a dedicated view, so it sits alongside whatever was
+    // being logged while the lag happened and copies out with it
+    SCLOG_IF(always, scxt::messaging::LatencyTrace::formatReport(report));
+    if (logScreen && logScreen->isVisible())
+        logScreen->reshowLog();
+}
+
 void SCXTEditor::onMissingResolutionWorkItemList(
     const std::vector<engine::MissingResolutionWorkItem> &items)
 {
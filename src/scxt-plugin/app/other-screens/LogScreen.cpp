@@ -55,6 +55,27 @@ LogScreen::LogScreen(SCXTEditor *e) : HasEditor(e)
             w->setVisible(false);
     };
     addAndMakeVisible(*closeButton);
+
+    // First press starts tracing, later ones append a report of everything since
+    latencyButton = std::make_unique<juce::TextButton>();
+    latencyButton->setTitle("Latency");
+    latencyButton->setButtonText("Trace Latency");
+    latencyButton->onClick = [w = juce::Component::SafePointer(this)]() {
+        if (!w)
+            return;
+        namespace cmsg = scxt::messaging::client;
+        if (!w->tracingLatency)
+        {
+            w->sendToSerialization(cmsg::SetLatencyTracing(true));
+            w->tracingLatency = true;
+            w->latencyButton->setButtonText("Latency Report");
+        }
+        else
+        {
+            w->sendToSerialization(cmsg::RequestLatencyReport(false));
+        }
+    };
+    addAndMakeVisible(*latencyButton);
 }
 
 void LogScreen::visibilityChanged()
@@ -76,6 +97,7 @@ void LogScreen::resized()
 
     logDisplay->setBounds(tb.reduced(3));
     closeButton->setBounds(bb.withLeft(bb.getRight() - 120).reduced(3));
+    latencyButton->setBounds(bb.withLeft(bb.getRight() - 240).withWidth(120).reduced(3));
 }
 bool LogScreen::keyPressed(const juce::KeyPress &key)
 {
@@ -38,7 +38,8 @@ struct LogScreen : juce::Component, HasEditor
     LogScreen(SCXTEditor *e);
 
     std::unique_ptr<juce::TextEditor> logDisplay;
-    std::unique_ptr<juce::TextButton> copyButton, closeButton;
+    std::unique_ptr<juce::TextButton> copyButton, closeButton, latencyButton;
+    bool tracingLatency{false};
 
 #if JUCE_VERSION >= 0x080000
     juce::Font displayFont{juce::FontOptions(1)};
@@ -28,6 +28,7 @@
 #include "HeaderRegion.h"
 #include "app/SCXTEditor.h"
 #include "infrastructure/user_defaults.h"
+#include "engine/memory_pool.h"
 #include "app/shared/PatchMultiIO.h"
 #include "sst/jucegui/components/ToggleButton.h"
 #include "sst/jucegui/components/ToggleButtonRadioGroup.h"
@@ -190,7 +191,12 @@ HeaderRegion::HeaderRegion(SCXTEditor *e) : HasEditor(e)
     if (hasFeature::memoryUsageExplanation)
     {
         chipButton = std::make_unique<jcmp::GlyphButton>(jcmp::GlyphPainter::MEMORY);
-        chipButton->setOnCallback(editor->makeComingSoon());
+        chipButton->setTitle("Memory Usage");
+        chipButton->setOnCallback([w = juce::Component::SafePointer(this)]() {
+            if (!w)
+                return;
+            w->sendToSerialization(cmsg::RequestMemoryPoolStats(true));
+        });
         addAndMakeVisible(*chipButton);
     }
 
@@ -398,6 +404,64 @@ void HeaderRegion::showSaveMenu()
     p.showMenuAsync(editor->defaultPopupMenuOptions(saveAsButton.get()));
 }
 
+void HeaderRegion::showMemoryPoolStats(const messaging::client::memoryPoolStats_t &stats)
+{
+    if (!chipButton)
+        return;
+
+    auto toMB = [](double b) { return b / 1024.0 / 1024.0; };
+    const auto &[poolBytes, fallbacks, classes] = stats;
+
+    auto p = juce::PopupMenu();
+    p.addSectionHeader("Memory Usage");
+    p.addSeparator();
+    p.addItem(fmt::format("Samples : {:.2f} MB", toMB(editor->sampleManager.sampleMemoryInBytes)),
+              false, false, []() {});
+    p.addItem(fmt::format("DSP Pool : {:.2f} MB", toMB(poolBytes)), false, false, []() {});
+    if (fallbacks > 0)
+    {
+        p.addItem(fmt::format("Empty Pool Checkouts : {}", fallbacks), false, false, []() {});
+    }
+
+    if (!classes.empty())
+    {
+        p.addSeparator();
+        p.addSectionHeader("DSP Pool by Block Size");
+    }
+    for (const auto &[blockSize, reserved, freeBlocks, outstanding, highWatermark, grows,
+                      bytes, owners] : classes)
+    {
+        std::string ownerNames;
+        for (int i = 0;
+             i < dsp::processor::proct_num_types && i < engine::MemoryPool::maxOwners; ++i)
+        {
+            if (owners & (1ULL << i))
+            {
+                ownerNames += (ownerNames.empty() ? "" : ", ");
+                ownerNames += dsp::processor::getProcessorName((dsp::processor::ProcessorType)i);
+            }
+        }
+        if (ownerNames.empty())
+            ownerNames = "Unknown";
+
+        auto sub = juce::PopupMenu();
+        sub.addItem(fmt::format("In Use : {} (Peak {})", outstanding, highWatermark), false,
+                    false, []() {});
+        sub.addItem(fmt::format("Reserved : {} Blocks ({:.2f} MB)", reserved, toMB(bytes)),
+                    false, false, []() {});
+        sub.addItem(fmt::format("Free : {}", freeBlocks), false, false, []() {});
+        sub.addItem(fmt::format("Empty Checkouts : {}", grows), false, false, []() {});
+        sub.addSeparator();
+        sub.addItem("Used By : " + ownerNames, false, false, []() {});
+
+        p.addSubMenu(fmt::format("{} KB : {} in use, peak {}", blockSize / 1024, outstanding,
+                                 highWatermark),
+                     sub);
+    }
+
+    p.showMenuAsync(editor->defaultPopupMenuOptions(chipButton.get()));
+}
+
 void HeaderRegion::populateSaveMenu(juce::PopupMenu &p)
 {
     p.addItem("Save Multi Only", [w = juce::Component::SafePointer(this)]() {
@@ -40,6 +40,7 @@
 #include "sst/jucegui/components/ToggleButtonRadioGroup.h"
 #include "sst/jucegui/data/Discrete.h"
 #include "patch_io/patch_io.h"
+#include "messaging/client/enginestatus_messages.h"
 #include "app/HasEditor.h"
 #include "utils.h"
 
@@ -117,6 +118,8 @@ struct HeaderRegion : juce::Component, HasEditor, juce::FileDragAndDropTarget
 
     void showMultiSelectionMenu();
 
+    void showMemoryPoolStats(const messaging::client::memoryPoolStats_t &stats);
+
     void addResetMenuItems(juce::PopupMenu &menu);
 
     void setShowUndoRedo(bool show);
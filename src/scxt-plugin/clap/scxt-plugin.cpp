@@ -25,8 +25,10 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstring>
 
 #include "sst/basic-blocks/modulators/Transport.h"
 
@@ -267,7 +269,6 @@ clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
     engine->onTransportUpdated();
 
     auto &ptch = engine->getPatch();
-    auto &main = ptch->busses.mainBus.output;
 
     auto ev = process->in_events;
     auto sz = ev->size(ev);
@@ -281,21 +282,79 @@ clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
         nextEvent = ev->get(ev, nextEventIndex);
     }
 
-    for (auto s = 0U; s < process->frames_count; ++s)
+    /*
+     * Ports with nothing routed to them are zeroed once for the whole host block
+     * and flagged constant so the host can skip them.
+     */
+    auto nonMainPorts = std::min((uint32_t)scxt::numNonMainPluginOutputs,
+                                 process->audio_outputs_count - 1);
+    std::array<bool, scxt::numNonMainPluginOutputs> portUsed{};
+    std::array<bool, scxt::numNonMainPluginOutputs> portUsedAtStart{};
+    for (auto i = 0U; i < nonMainPorts; ++i)
     {
-        if (blockPos == 0)
+        portUsedAtStart[i] = ptch->usesOutputBus(i + 1);
+        float **pout = process->audio_outputs[i + 1].data32;
+        if (pout && !portUsedAtStart[i])
+        {
+            memset(pout[0], 0, process->frames_count * sizeof(float));
+            memset(pout[1], 0, process->frames_count * sizeof(float));
+        }
+    }
+
+    auto s = 0U;
+    while (s < process->frames_count)
+    {
+        auto n = std::min((uint32_t)(scxt::blockSize - blockPos), process->frames_count - s);
+
+        /*
+         * Output runs one engine block behind the events, so every event landing in a
+         * block has been handled before that block renders, even when the block began in
+         * the previous host block. Each event passes its offset into the block it lands
+         * in, which voices use to start and release sample accurately.
+         */
+        while (nextEvent && nextEvent->time < s + n)
         {
-            // Only realy need to run events when we do the block process
-            while (nextEvent && nextEvent->time <= s)
+            engine->noteEventSampleOffset =
+                blockPos + (nextEvent->time > s ? nextEvent->time - s : 0);
+            handleEvent(nextEvent);
+            nextEventIndex++;
+            if (nextEventIndex < sz)
+                nextEvent = ev->get(ev, nextEventIndex);
+            else
+                nextEvent = nullptr;
+        }
+        engine->noteEventSampleOffset = 0;
+
+        // Copy out the block rendered last time round, up to its end or the end of the host block
+        auto &main = ptch->busses.mainBus.output;
+        memcpy(out[0] + s, main[0] + blockPos, n * sizeof(float));
+        memcpy(out[1] + s, main[1] + blockPos, n * sizeof(float));
+        for (auto i = 0U; i < nonMainPorts; ++i)
+        {
+            float **pout = process->audio_outputs[i + 1].data32;
+            if (!pout)
+                continue;
+
+            if (ptch->usesOutputBus(i + 1))
+            {
+                auto &pno = ptch->busses.pluginNonMainOutputs[i];
+                memcpy(pout[0] + s, pno[0] + blockPos, n * sizeof(float));
+                memcpy(pout[1] + s, pno[1] + blockPos, n * sizeof(float));
+                portUsed[i] = true;
+            }
+            else if (portUsedAtStart[i])
             {
-                handleEvent(nextEvent);
-                nextEventIndex++;
-                if (nextEventIndex < sz)
-                    nextEvent = ev->get(ev, nextEventIndex);
-                else
-                    nextEvent = nullptr;
+                // Routing changed mid host block so this port wasn't cleared above
+                memset(pout[0] + s, 0, n * sizeof(float));
+                memset(pout[1] + s, 0, n * sizeof(float));
             }
+        }
+
+        s += n;
+        blockPos = (blockPos + n) & (scxt::blockSize - 1);
 
+        if (blockPos == 0)
+        {
             engine->processAudio();
             engine->transport.timeInBeats += (double)scxt::blockSize * engine->transport.tempo *
                                              engine->getSampleRateInv() / 60.f;
@@ -323,7 +382,7 @@ clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
                     evt.header.size = sizeof(clap_event_param_gesture);
                     evt.header.type =
                         (begin ? CLAP_EVENT_PARAM_GESTURE_BEGIN : CLAP_EVENT_PARAM_GESTURE_END);
-                    evt.header.time = s;
+                    evt.header.time = std::min(s, process->frames_count - 1);
                     evt.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
                     evt.header.flags = 0;
                     evt.param_id = parm;
@@ -360,30 +419,12 @@ clap_process_status SCXTPlugin::process(const clap_process *process) noexcept
                 }
             }
         }
+    }
 
-        // TODO: this can be way more efficient and block wise and stuff
-        out[0][s] = main[0][blockPos];
-        out[1][s] = main[1][blockPos];
-        for (int i = 0; i < scxt::numNonMainPluginOutputs; ++i)
-        {
-            float **pout = process->audio_outputs[i + 1].data32;
-
-            if (pout)
-            {
-                pout[0][s] = 0.f;
-                pout[1][s] = 0.f;
-            }
-            if (engine->getPatch()->usesOutputBus(i + 1))
-            {
-                if (pout)
-                {
-                    pout[0][s] = engine->getPatch()->busses.pluginNonMainOutputs[i][0][blockPos];
-                    pout[1][s] = engine->getPatch()->busses.pluginNonMainOutputs[i][1][blockPos];
-                }
-            }
-        }
-
-        blockPos = (blockPos + 1) & (scxt::blockSize - 1);
+    process->audio_outputs[0].constant_mask = 0;
+    for (auto i = 0U; i < nonMainPorts; ++i)
+    {
+        process->audio_outputs[i + 1].constant_mask = portUsed[i] ? 0 : 0x3;
     }
 
     // CLean up past-last-process events since we only sweep when processing in main loop to avoid
@@ -433,6 +474,7 @@ bool SCXTPlugin::handleEvent(const clap_event_header_t *nextEvent)
             engine->processNoteOffEvent(nevt->port_index, nevt->channel, nevt->key, nevt->note_id,
                                         nevt->velocity);
         }
+        break;
 
         case CLAP_EVENT_PARAM_VALUE:
         {
@@ -462,9 +504,25 @@ bool SCXTPlugin::activate(double sampleRate, uint32_t minFrameCount,
                           uint32_t maxFrameCount) noexcept
 {
     engine->prepareToPlay(sampleRate);
+
+    if (_host.canUseThreadPool())
+    {
+        engine->requestConcurrentPartTasks = [this](uint32_t n) {
+            return _host.threadPoolRequestExec(n);
+        };
+    }
+    else
+    {
+        engine->requestConcurrentPartTasks = nullptr;
+    }
     return true;
 }
 
+void SCXTPlugin::threadPoolExec(uint32_t taskIndex) noexcept
+{
+    engine->getPatch()->processConcurrentPartTask(taskIndex);
+}
+
 /*
  * Parameter support
  */
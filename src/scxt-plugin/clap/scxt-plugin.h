@@ -97,8 +97,19 @@ struct SCXTPlugin : public plugHelper_t, sst::clap_juce_shim::EditorProvider
                        clap_note_port_info *info) const noexcept override;
 
     clap_process_status process(const clap_process *process) noexcept override;
+
+    // Active parts run as host thread pool tasks when the host has one
+    bool implementsThreadPool() const noexcept override { return true; }
+    void threadPoolExec(uint32_t taskIndex) noexcept override;
     bool handleEvent(const clap_event_header_t *);
 
+    // Output runs a block behind events so they land sample accurately, plus any engine latency
+    bool implementsLatency() const noexcept override { return true; }
+    uint32_t latencyGet() const noexcept override
+    {
+        return scxt::blockSize + engine->getLatencySamples();
+    }
+
     bool implementsState() const noexcept override { return true; }
     bool stateSave(const clap_ostream *stream) noexcept override;
     bool stateLoad(const clap_istream *stream) noexcept override;
@@ -0,0 +1,198 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include "catch2/catch2.hpp"
+#include "engine/engine.h"
+#include "console_harness.h"
+#include "infrastructure/audio_thread_guard.h"
+
+/*
+ * These only do anything in a -DSCXT_AUDIO_THREAD_GUARD=TRUE build, where the allocator
+ * and mutex locks are instrumented on the audio thread.
+ */
+#if SCXT_AUDIO_THREAD_GUARD
+
+namespace cmsg = scxt::messaging::client;
+namespace atg = scxt::infrastructure::audio_thread_guard;
+
+namespace
+{
+void requireNoViolationsSince(size_t mark)
+{
+    auto vs = atg::violationsSince(mark);
+    for (auto i = mark; i < mark + vs; ++i)
+    {
+        INFO(atg::describe(i));
+        CHECK(false);
+    }
+    REQUIRE(vs == 0);
+}
+
+void startWithHeldZone(scxt::clients::console_ui::ConsoleHarness &th)
+{
+    th.start();
+    th.stepUI();
+
+    th.sendToSerialization(cmsg::AddBlankZone({0, 0, 0, 127, 0, 127}));
+    th.stepUI();
+    // A filter keeps the voice alive and gives processor changes something to swap
+    th.sendToSerialization(
+        cmsg::SetSelectedProcessorType({true, 0, scxt::dsp::processor::proct_CytomicSVF}));
+    th.stepUI();
+    REQUIRE(th.engine->getPatch()->getPart(0)->getGroup(0)->getZones().size() == 1);
+}
+} // namespace
+
+TEST_CASE("Audio Thread Guard - Note On and Off")
+{
+    scxt::clients::console_ui::ConsoleHarness th;
+    startWithHeldZone(th);
+
+    auto m = atg::mark();
+    for (int i = 0; i < 8; ++i)
+    {
+        th.sendToSerialization(cmsg::NoteFromGUI({60 + i, 0.8f, true}));
+        th.stepUI();
+    }
+    REQUIRE(th.engine->activeVoices > 0);
+    for (int i = 0; i < 8; ++i)
+    {
+        th.sendToSerialization(cmsg::NoteFromGUI({60 + i, 0.8f, false}));
+        th.stepUI();
+    }
+    th.stepUI(50);
+    requireNoViolationsSince(m);
+}
+
+TEST_CASE("Audio Thread Guard - Processor Type Change With Held Notes")
+{
+    scxt::clients::console_ui::ConsoleHarness th;
+    startWithHeldZone(th);
+
+    th.sendToSerialization(cmsg::NoteFromGUI({60, 0.8f, true}));
+    th.sendToSerialization(cmsg::NoteFromGUI({64, 0.8f, true}));
+    th.stepUI();
+
+    auto m = atg::mark();
+    th.sendToSerialization(
+        cmsg::SetSelectedProcessorType({true, 0, scxt::dsp::processor::proct_none}));
+    th.stepUI();
+    th.sendToSerialization(
+        cmsg::SetSelectedProcessorType({true, 0, scxt::dsp::processor::proct_CytomicSVF}));
+    th.stepUI();
+    th.sendToSerialization(cmsg::NoteFromGUI({60, 0.8f, false}));
+    th.sendToSerialization(cmsg::NoteFromGUI({64, 0.8f, false}));
+    th.stepUI(50);
+    requireNoViolationsSince(m);
+}
+
+TEST_CASE("Audio Thread Guard - Voice Steal")
+{
+    scxt::clients::console_ui::ConsoleHarness th;
+    startWithHeldZone(th);
+
+    auto oi = th.engine->getPatch()->getPart(0)->getGroup(0)->outputInfo;
+    oi.hasIndependentPolyLimit = true;
+    oi.polyLimit = 2;
+    th.sendToSerialization(cmsg::UpdateGroupOutputInfoPolyphony(oi));
+    th.stepUI();
+
+    auto m = atg::mark();
+    for (int i = 0; i < 6; ++i)
+    {
+        th.sendToSerialization(cmsg::NoteFromGUI({48 + i, 0.8f, true}));
+        th.stepUI();
+    }
+    for (int i = 0; i < 6; ++i)
+    {
+        th.sendToSerialization(cmsg::NoteFromGUI({48 + i, 0.8f, false}));
+    }
+    th.stepUI(50);
+    requireNoViolationsSince(m);
+}
+
+TEST_CASE("Audio Thread Guard - Burst of Parameter Edits")
+{
+    scxt::clients::console_ui::ConsoleHarness th;
+    startWithHeldZone(th);
+
+    th.sendToSerialization(cmsg::NoteFromGUI({60, 0.8f, true}));
+    th.stepUI();
+
+    // Far more edits than the callback pool holds, so batching and the overflow path run.
+    // Every edit hits the same target, so coalescing would fold each burst into one.
+    auto &cont = *th.engine->getMessageController();
+    cont.coalesceInboundMessages = false;
+    auto heapBefore = cont.heapAudioThreadCallbackCount.load();
+
+    auto m = atg::mark();
+    auto off = offsetof(scxt::engine::Zone::ZoneOutputInfo, amplitude);
+    for (int burst = 0; burst < 20 && cont.heapAudioThreadCallbackCount == heapBefore; ++burst)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            th.sendToSerialization(cmsg::UpdateZoneOutputFloatValue({off, (i % 100) * 0.01f}));
+            th.sendToSerialization(cmsg::UpdateZoneOutputFloatValue(
+                {offsetof(scxt::engine::Zone::ZoneOutputInfo, pan), 0.f}));
+        }
+        th.stepUI(50);
+    }
+    REQUIRE(cont.heapAudioThreadCallbackCount > heapBefore);
+    th.sendToSerialization(cmsg::NoteFromGUI({60, 0.8f, false}));
+    th.stepUI(50);
+    requireNoViolationsSince(m);
+    REQUIRE(th.engine->getPatch()->getPart(0)->getGroup(0)->getZone(0)->outputInfo.amplitude ==
+            Approx(0.99f));
+}
+
+TEST_CASE("Audio Thread Guard - Patch Load While Playing")
+{
+    namespace fs = std::filesystem;
+    auto path = fs::temp_directory_path() / "scxt_audio_thread_guard_test.scm";
+
+    scxt::clients::console_ui::ConsoleHarness th;
+    startWithHeldZone(th);
+    th.sendToSerialization(cmsg::SaveMulti({path.u8string(), 0})); // NO_SAMPLES
+    th.stepUI();
+    REQUIRE(fs::exists(path));
+
+    th.sendToSerialization(cmsg::NoteFromGUI({60, 0.8f, true}));
+    th.stepUI();
+
+    auto m = atg::mark();
+    th.sendToSerialization(cmsg::LoadMulti(path.u8string()));
+    th.stepUI(50);
+    th.sendToSerialization(cmsg::NoteFromGUI({62, 0.8f, true}));
+    th.stepUI();
+    th.sendToSerialization(cmsg::NoteFromGUI({62, 0.8f, false}));
+    th.stepUI(50);
+    requireNoViolationsSince(m);
+
+    fs::remove(path);
+}
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "catch2/catch2.hpp"
+#include "engine_host.h"
+#include "messaging/messaging.h"
+
+namespace srv = scxt::clients::server;
+namespace cmsg = scxt::messaging::client;
+
+namespace
+{
+std::string tempPath(const std::string &suffix)
+{
+    return (std::filesystem::temp_directory_path() /
+            ("scxt-test-" + std::to_string(getpid()) + "-" + suffix))
+        .u8string();
+}
+
+int connectTo(const std::string &path)
+{
+    auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (::connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void setReadTimeout(int fd, std::chrono::milliseconds ms)
+{
+    timeval tv{};
+    tv.tv_sec = ms.count() / 1000;
+    tv.tv_usec = (ms.count() % 1000) * 1000;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+}
+
+// Sends our hello and returns the host's answer
+std::string greet(int fd, const std::string &hello = srv::EngineHost::helloFrame())
+{
+    std::string answer;
+    REQUIRE(srv::EngineHost::writeFrame(fd, hello));
+    setReadTimeout(fd, std::chrono::milliseconds(2000));
+    REQUIRE(srv::EngineHost::readFrame(fd, answer));
+    return answer;
+}
+
+// Reads frames until the socket has been quiet for a while, returning how many
+int drainFrames(int fd)
+{
+    setReadTimeout(fd, std::chrono::milliseconds(300));
+    std::string frame;
+    int count{0};
+    while (srv::EngineHost::readFrame(fd, frame))
+        count++;
+    return count;
+}
+} // namespace
+
+TEST_CASE("Engine Host Frames Round Trip")
+{
+    int fds[2];
+    REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    SECTION("Frames arrive whole and in order")
+    {
+        std::vector<std::string> sent{"hello", "", std::string("a\0b\0c", 5),
+                                      std::string(1 << 20, 'x')};
+        // The big frame is more than the socket buffer, so write from elsewhere
+        bool allWritten{true};
+        std::thread writer([&]() {
+            for (const auto &s : sent)
+                allWritten = allWritten && srv::EngineHost::writeFrame(fds[0], s);
+        });
+        std::string got;
+        for (const auto &s : sent)
+        {
+            REQUIRE(srv::EngineHost::readFrame(fds[1], got));
+            REQUIRE(got == s);
+        }
+        writer.join();
+        REQUIRE(allWritten);
+    }
+
+    SECTION("An oversized length is rejected without reading on")
+    {
+        auto len = srv::EngineHost::maxFrameBytes + 1;
+        unsigned char hdr[4]{(unsigned char)(len & 0xFF), (unsigned char)((len >> 8) & 0xFF),
+                             (unsigned char)((len >> 16) & 0xFF),
+                             (unsigned char)((len >> 24) & 0xFF)};
+        REQUIRE(::write(fds[0], hdr, 4) == 4);
+        std::string got;
+        REQUIRE(!srv::EngineHost::readFrame(fds[1], got));
+    }
+
+    SECTION("A truncated frame is rejected")
+    {
+        unsigned char hdr[4]{10, 0, 0, 0};
+        REQUIRE(::write(fds[0], hdr, 4) == 4);
+        REQUIRE(::write(fds[0], "abc", 3) == 3);
+        ::shutdown(fds[0], SHUT_WR);
+        std::string got;
+        REQUIRE(!srv::EngineHost::readFrame(fds[1], got));
+    }
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+TEST_CASE("Engine Host Serves A Client Over Its Socket")
+{
+    srv::EngineHost::Config cfg;
+    cfg.socketPath = tempPath("host.sock");
+    srv::EngineHost host(cfg);
+    REQUIRE(host.start());
+
+    auto fd = connectTo(cfg.socketPath);
+    REQUIRE(fd >= 0);
+    REQUIRE(greet(fd) == srv::EngineHost::helloFrame());
+
+    // Connecting registers us as the client, which answers with a full refresh
+    REQUIRE(drainFrames(fd) > 0);
+
+    // And a request we send gets the refresh again
+    auto reg = cmsg::detail::flatFrame((int32_t)cmsg::RegisterClient::c2s_id, true);
+    REQUIRE(srv::EngineHost::writeFrame(fd, reg));
+    REQUIRE(drainFrames(fd) > 0);
+
+    REQUIRE(host.blocksRendered() > 0);
+
+    // Stopping with the client still attached mustn't hang, and the client sees us go
+    host.stop();
+    setReadTimeout(fd, std::chrono::milliseconds(2000));
+    std::string frame;
+    REQUIRE(!srv::EngineHost::readFrame(fd, frame));
+    ::close(fd);
+    REQUIRE(!std::filesystem::exists(std::filesystem::path(cfg.socketPath)));
+}
+
+TEST_CASE("Engine Host Turns Away Clients It Can't Trust")
+{
+    srv::EngineHost::Config cfg;
+    cfg.socketPath = tempPath("strict.sock");
+    srv::EngineHost host(cfg);
+    REQUIRE(host.start());
+
+    SECTION("A client from another build gets our hello and then nothing")
+    {
+        auto fd = connectTo(cfg.socketPath);
+        REQUIRE(fd >= 0);
+        REQUIRE(greet(fd, "scxt-server 0 some other build") == srv::EngineHost::helloFrame());
+        REQUIRE(drainFrames(fd) == 0);
+        ::close(fd);
+    }
+
+    SECTION("A malformed frame ends the connection, and the host serves the next one")
+    {
+        auto reg = cmsg::detail::flatFrame((int32_t)cmsg::RegisterClient::c2s_id, true);
+        std::vector<std::string> bad{
+            reg.substr(0, reg.size() - 1),                               // short payload
+            cmsg::detail::flatFrame((int32_t)-1, true),                  // id out of range
+            std::string("{\"id\": 100000, \"object\": null}"),           // id out of range
+            std::string("{\"id\": "),                                    // not JSON
+            std::string("\x92\x01", 2)};                                 // truncated msgpack
+        for (const auto &b : bad)
+        {
+            INFO("Frame of " << b.size() << " bytes");
+            auto fd = connectTo(cfg.socketPath);
+            REQUIRE(fd >= 0);
+            REQUIRE(greet(fd) == srv::EngineHost::helloFrame());
+            drainFrames(fd);
+            REQUIRE(srv::EngineHost::writeFrame(fd, b));
+            setReadTimeout(fd, std::chrono::milliseconds(2000));
+            // The host hangs up rather than leaving us to time out
+            std::string frame;
+            errno = 0;
+            while (srv::EngineHost::readFrame(fd, frame))
+                ;
+            REQUIRE(errno != EAGAIN);
+            REQUIRE(errno != EWOULDBLOCK);
+            ::close(fd);
+        }
+
+        auto fd = connectTo(cfg.socketPath);
+        REQUIRE(fd >= 0);
+        REQUIRE(greet(fd) == srv::EngineHost::helloFrame());
+        REQUIRE(srv::EngineHost::writeFrame(fd, reg));
+        REQUIRE(drainFrames(fd) > 0);
+        ::close(fd);
+    }
+
+    host.stop();
+}
+
+TEST_CASE("Engine Host Only Replaces A Stale Socket")
+{
+    srv::EngineHost::Config cfg;
+    cfg.socketPath = tempPath("stale.sock");
+
+    SECTION("Something which isn't a socket is left alone")
+    {
+        {
+            std::ofstream f(cfg.socketPath);
+            f << "keep me";
+        }
+        srv::EngineHost host(cfg);
+        REQUIRE(!host.start());
+        REQUIRE(std::filesystem::is_regular_file(cfg.socketPath));
+        std::filesystem::remove(cfg.socketPath);
+    }
+
+    SECTION("A socket an earlier run left behind is replaced")
+    {
+        auto old = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, cfg.socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        REQUIRE(::bind(old, (sockaddr *)&addr, sizeof(addr)) == 0);
+        ::close(old);
+        REQUIRE(std::filesystem::is_socket(cfg.socketPath));
+
+        srv::EngineHost host(cfg);
+        REQUIRE(host.start());
+        auto fd = connectTo(cfg.socketPath);
+        REQUIRE(fd >= 0);
+        REQUIRE(greet(fd) == srv::EngineHost::helloFrame());
+        ::close(fd);
+        host.stop();
+    }
+}
+
+TEST_CASE("Engine Host Stops Cleanly With Nobody Connected")
+{
+    srv::EngineHost::Config cfg;
+    cfg.socketPath = tempPath("idle.sock");
+    for (int i = 0; i < 10; ++i)
+    {
+        srv::EngineHost host(cfg);
+        REQUIRE(host.start());
+        host.stop();
+    }
+}
+
+TEST_CASE("Engine Host Renders Offline To A Wav")
+{
+    srv::EngineHost::Config cfg;
+    cfg.socketPath = tempPath("render.sock");
+    cfg.renderPath = tempPath("render.wav");
+    cfg.offline = true;
+    srv::EngineHost host(cfg);
+    REQUIRE(host.start());
+
+    // Offline runs flat out, so a second of audio shouldn't take anywhere near a second
+    auto blocks = (uint64_t)(cfg.sampleRate / scxt::blockSize);
+    auto st = std::chrono::steady_clock::now();
+    while (host.blocksRendered() < blocks &&
+           std::chrono::steady_clock::now() - st < std::chrono::seconds(10))
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    REQUIRE(host.blocksRendered() >= blocks);
+    host.stop();
+
+    auto wav = std::filesystem::path(cfg.renderPath);
+    REQUIRE(std::filesystem::exists(wav));
+    // At least a 44 byte header then interleaved stereo float
+    REQUIRE(std::filesystem::file_size(wav) >= 44 + blocks * scxt::blockSize * 2 * sizeof(float));
+    std::filesystem::remove(wav);
+}
@@ -28,6 +28,11 @@
 #include "catch2/catch2.hpp"
 #include "engine/engine.h"
 #include "console_harness.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
 
 namespace cmsg = scxt::messaging::client;
 using ZoneAddress = scxt::selection::SelectionManager::ZoneAddress;
@@ -184,3 +189,332 @@ TEST_CASE("Paste Group Does Nothing When Clipboard Holds Zone")
     // Still one group
     REQUIRE(part->getGroups().size() == 1);
 }
+
+TEST_CASE("Zone Lookup Index Matches Full Walk")
+{
+    scxt::clients::console_ui::ConsoleHarness th;
+    th.start();
+    th.stepUI();
+
+    // A grid of small zones in two groups plus one full range layer
+    for (int k = 0; k < 128; k += 16)
+    {
+        for (int v = 0; v < 128; v += 32)
+        {
+            th.sendToSerialization(cmsg::AddBlankZone({0, 0, k, k + 15, v, v + 31}));
+            th.sendToSerialization(cmsg::AddBlankZone({0, 1, k + 4, k + 9, v + 3, v + 7}));
+        }
+    }
+    th.sendToSerialization(cmsg::AddBlankZone({0, 1, 0, 127, 0, 127}));
+    th.stepUI();
+
+    auto &part = th.engine->getPatch()->getPart(0);
+    REQUIRE(part->getGroups().size() == 2);
+
+    auto zl = scxt::engine::ZoneLookupIndex::build(*part, 0);
+    REQUIRE(zl);
+    REQUIRE(zl->groupCount == 2);
+
+    for (int16_t k = 0; k < 128; ++k)
+    {
+        for (int16_t v = 0; v < 128; ++v)
+        {
+            std::vector<std::pair<uint32_t, uint32_t>> walk, indexed;
+            for (const auto &[gi, g] : sst::cpputils::enumerate(part->getGroups()))
+                for (const auto &[zi, z] : sst::cpputils::enumerate(g->getZones()))
+                    if (z->mapping.keyboardRange.includes(k) &&
+                        z->mapping.velocityRange.includes(v))
+                        walk.emplace_back(gi, zi);
+
+            zl->forEachCandidate(k, v, [&](uint32_t gi, uint32_t zi) {
+                const auto &z = part->getGroup(gi)->getZone(zi);
+                if (z->mapping.keyboardRange.includes(k) && z->mapping.velocityRange.includes(v))
+                    indexed.emplace_back(gi, zi);
+            });
+            INFO("Key " << k << " Velocity " << v);
+            REQUIRE(walk == indexed);
+        }
+    }
+
+    // and the serialization thread should have built and installed one for the audio thread
+    th.stepUI(50);
+    REQUIRE(part->zoneLookup);
+
+    // A range reaching outside 0..127 at either end can't be indexed, so the part walks in full
+    th.audioThreadProvider.reset();
+    auto &mapping = part->getGroup(0)->getZone(0)->mapping;
+    std::vector<std::array<int16_t, 4>> outside{
+        {-3, 15, 0, 31}, {0, 130, 0, 31}, {0, 15, -1, 31}, {0, 15, 0, 128}};
+    for (auto [ks, ke, vs, ve] : outside)
+    {
+        INFO("Key " << ks << ".." << ke << " Velocity " << vs << ".." << ve);
+        mapping.keyboardRange.keyStart = ks;
+        mapping.keyboardRange.keyEnd = ke;
+        mapping.velocityRange.velStart = vs;
+        mapping.velocityRange.velEnd = ve;
+        REQUIRE(!scxt::engine::ZoneLookupIndex::build(*part, 0));
+    }
+}
+
+TEST_CASE("Voice Start Descriptors Are Published From The Serialization Thread")
+{
+    scxt::clients::console_ui::ConsoleHarness th;
+    th.start();
+    th.stepUI();
+
+    th.sendToSerialization(cmsg::AddBlankZone({0, 0, 0, 127, 0, 127}));
+    th.stepUI(50);
+
+    auto &zone = th.engine->getPatch()->getPart(0)->getGroup(0)->getZone(0);
+    auto published = [&zone]() {
+        return zone->voiceStartDescriptors &&
+               zone->voiceStartDescriptors->generation ==
+                   zone->voiceStartGeneration.value.load(std::memory_order_acquire);
+    };
+    REQUIRE(published());
+
+    // Dirtying the zone makes the published set stale until the next one lands
+    zone->markVoiceStartDescriptorsDirty();
+    REQUIRE(!published());
+    th.stepUI(50);
+    REQUIRE(published());
+}
+
+TEST_CASE("Structure Deltas Reproduce the Structure")
+{
+    using eng = scxt::engine::Engine;
+
+    scxt::clients::console_ui::ConsoleHarness th;
+    th.start();
+    th.stepUI();
+
+    for (int k = 0; k < 8; ++k)
+        th.sendToSerialization(cmsg::AddBlankZone({0, 0, k * 10, k * 10 + 9, 0, 127}));
+    th.stepUI();
+
+    auto checkDelta = [&th](const eng::pgzStructure_t &s0, const std::vector<int64_t> &k0) {
+        std::vector<int64_t> k1;
+        auto s1 = th.engine->getPartGroupZoneStructure(&k1);
+        auto ops = eng::diffPartGroupZoneStructure(s0, k0, s1, k1);
+
+        auto applied = s0;
+        eng::applyPartGroupZoneStructureDelta(applied, ops);
+        REQUIRE(applied.size() == s1.size());
+        for (size_t i = 0; i < s1.size(); ++i)
+        {
+            REQUIRE(applied[i].address == s1[i].address);
+            REQUIRE(applied[i].name == s1[i].name);
+            REQUIRE(applied[i].features == s1[i].features);
+        }
+        return ops;
+    };
+
+    std::vector<int64_t> k0;
+    auto s0 = th.engine->getPartGroupZoneStructure(&k0);
+
+    SECTION("Deleting a zone removes one entry")
+    {
+        th.sendToSerialization(cmsg::DeleteZone(ZoneAddress{0, 0, 2}));
+        th.stepUI();
+        auto ops = checkDelta(s0, k0);
+        REQUIRE(ops.size() == 1);
+        REQUIRE(std::get<0>(ops[0]) == eng::PGZ_REMOVE);
+        REQUIRE(std::get<2>(ops[0]) == 1);
+    }
+
+    SECTION("Renaming a zone updates one entry")
+    {
+        th.sendToSerialization(cmsg::RenameZone({ZoneAddress{0, 0, 5}, "Renamed"}));
+        th.stepUI();
+        auto ops = checkDelta(s0, k0);
+        REQUIRE(ops.size() == 1);
+        REQUIRE(std::get<0>(ops[0]) == eng::PGZ_UPDATE);
+    }
+
+    SECTION("Adding a group and zones inserts them")
+    {
+        th.sendToSerialization(cmsg::CreateGroup(0));
+        th.stepUI();
+        th.sendToSerialization(cmsg::AddBlankZone({0, 1, 60, 72, 0, 127}));
+        th.stepUI();
+        checkDelta(s0, k0);
+    }
+}
+
+TEST_CASE("Load Multi Swaps In A New Patch While Audio Runs")
+{
+    namespace fs = std::filesystem;
+    auto path = fs::temp_directory_path() / "scxt_patch_swap_test.scm";
+
+    scxt::clients::console_ui::ConsoleHarness th;
+    th.start();
+    th.stepUI();
+
+    th.sendToSerialization(cmsg::AddBlankZone({0, 0, 48, 60, 0, 127}));
+    th.stepUI();
+    th.sendToSerialization(cmsg::SaveMulti({path.u8string(), 0})); // NO_SAMPLES
+    th.stepUI();
+    REQUIRE(fs::exists(path));
+
+    th.sendToSerialization(cmsg::AddBlankZone({0, 0, 61, 72, 0, 127}));
+    th.stepUI();
+    REQUIRE(th.engine->getPatch()->getPart(0)->getGroup(0)->getZones().size() == 2);
+    auto oldPatchId = th.engine->getPatch()->id;
+
+    th.sendToSerialization(cmsg::LoadMulti(path.u8string()));
+    th.stepUI(50);
+
+    // The audio thread never stopped; it swapped in the freshly built patch
+    REQUIRE(th.engine->getMessageController()->isAudioRunning);
+    REQUIRE(th.engine->getPatch()->id != oldPatchId);
+    REQUIRE(th.engine->getPatch()->getPart(0)->getGroup(0)->getZones().size() == 1);
+
+    // Swap again; the first loaded patch's groups hand their voice manager keys back
+    th.sendToSerialization(cmsg::LoadMulti(path.u8string()));
+    th.stepUI(50);
+    int32_t groups{0};
+    for (auto &p : *th.engine->getPatch())
+        groups += p->getGroups().size();
+    REQUIRE(groups > 0);
+    REQUIRE(th.engine->polyphonyGroupKeys.getGroupKeysInUse() == groups);
+
+    fs::remove(path);
+}
+
+TEST_CASE("Load Multi Restores Samples Aside Until The Swap Lands")
+{
+    namespace fs = std::filesystem;
+    auto path = fs::temp_directory_path() / "scxt_patch_swap_samples_test.scm";
+    auto sample = fs::path(__FILE__).parent_path().parent_path() / "resources" /
+                  "test_samples" / "WavStereo48k.wav";
+
+    scxt::clients::console_ui::ConsoleHarness th;
+    th.start();
+    th.stepUI();
+
+    th.sendToSerialization(cmsg::AddSampleWithRange({sample.u8string(), 60, 48, 72, 0, 127}));
+    th.stepUI(50);
+    th.sendToSerialization(cmsg::SaveMulti({path.u8string(), 0})); // NO_SAMPLES
+    th.stepUI();
+    REQUIRE(fs::exists(path));
+
+    auto &e = *th.engine;
+    auto &sm = *e.getSampleManager();
+    auto &zone = e.getPatch()->getPart(0)->getGroup(0)->getZone(0);
+    auto sid = zone->variantData.variants[0].sampleID;
+    auto liveSample = zone->samplePointers[0];
+    REQUIRE(liveSample);
+    REQUIRE(sm.getSample(sid) == liveSample);
+    auto oldPatchId = e.getPatch()->id;
+
+    {
+        // Holding a read section keeps the audio thread from swapping the new patch in
+        scxt::engine::StructureGate::ReadGuard hold(e.structureGate);
+        th.sendToSerialization(cmsg::LoadMulti(path.u8string()));
+        th.stepUI(50);
+
+        // The new patch has restored its samples, but not into the live manager
+        REQUIRE(e.getPatch()->id == oldPatchId);
+        REQUIRE(sm.getSample(sid) == liveSample);
+    }
+    th.stepUI(50);
+
+    REQUIRE(e.getPatch()->id != oldPatchId);
+    auto &newZone = e.getPatch()->getPart(0)->getGroup(0)->getZone(0);
+    REQUIRE(newZone->samplePointers[0]);
+    REQUIRE(newZone->samplePointers[0] != liveSample);
+    REQUIRE(sm.getSample(newZone->variantData.variants[0].sampleID) ==
+            newZone->samplePointers[0]);
+
+    fs::remove(path);
+}
+
+TEST_CASE("Structure Gate Defers Writes While Reading")
+{
+    scxt::engine::StructureGate gate;
+
+    SECTION("Write Fails Without Blocking While A Reader Is Inside")
+    {
+        {
+            scxt::engine::StructureGate::ReadGuard g(gate);
+            REQUIRE(!gate.tryEnterWrite());
+        }
+        REQUIRE(gate.getDeferredWrites() == 1);
+        // The deferred write lands before the next reader gets in
+        REQUIRE(gate.tryEnterWrite());
+        gate.exitWrite();
+    }
+
+    SECTION("A Write Parked With Audio Stopped Only Holds Back One Read")
+    {
+        using clock_t = std::chrono::steady_clock;
+        {
+            scxt::engine::StructureGate::ReadGuard g(gate);
+            REQUIRE(!gate.tryEnterWrite());
+        }
+        // Nobody retries the write, so the first read gives up on it...
+        auto st = clock_t::now();
+        {
+            scxt::engine::StructureGate::ReadGuard g(gate);
+        }
+        REQUIRE(clock_t::now() - st >= scxt::engine::StructureGate::writerWaitLimit);
+
+        // ...and the ones after don't wait again
+        st = clock_t::now();
+        for (int i = 0; i < 10; ++i)
+        {
+            scxt::engine::StructureGate::ReadGuard g(gate);
+        }
+        REQUIRE(clock_t::now() - st < scxt::engine::StructureGate::writerWaitLimit);
+    }
+
+    SECTION("Reads Don't Wait Once The Writer Has Stopped")
+    {
+        using clock_t = std::chrono::steady_clock;
+        {
+            scxt::engine::StructureGate::ReadGuard g(gate);
+            REQUIRE(!gate.tryEnterWrite());
+        }
+        gate.writerStopped();
+
+        auto st = clock_t::now();
+        {
+            scxt::engine::StructureGate::ReadGuard g(gate);
+        }
+        REQUIRE(clock_t::now() - st < scxt::engine::StructureGate::writerWaitLimit);
+        // and the write still goes through when audio comes back
+        REQUIRE(gate.tryEnterWrite());
+        gate.exitWrite();
+    }
+
+    SECTION("Readers And Writers Never Overlap")
+    {
+        std::atomic<bool> inWrite{false}, done{false};
+        std::atomic<int> overlaps{0}, writes{0};
+
+        std::thread writer([&]() {
+            while (!done)
+            {
+                if (gate.tryEnterWrite())
+                {
+                    inWrite = true;
+                    writes++;
+                    inWrite = false;
+                    gate.exitWrite();
+                }
+            }
+        });
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            scxt::engine::StructureGate::ReadGuard g(gate);
+            if (inWrite)
+                overlaps++;
+        }
+        done = true;
+        writer.join();
+
+        REQUIRE(overlaps == 0);
+        REQUIRE(writes > 0);
+    }
+}
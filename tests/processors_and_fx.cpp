@@ -25,8 +25,15 @@
  * https://github.com/surge-synthesizer/shortcircuit-xt
  */
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
 #include "catch2/catch2.hpp"
 #include "dsp/processor/processor.h"
+#include "dsp/processor/quad_voice_filter.h"
 #include "engine/memory_pool.h"
 #include "engine/engine.h"
 
@@ -116,4 +123,168 @@ TEST_CASE("Dump Processor Silence Lengths")
             }
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Memory Pool Recycles Blocks")
+{
+    scxt::engine::MemoryPool mp;
+    static constexpr size_t sz{48000 * sizeof(float)};
+    mp.preReservePool(sz);
+
+    SECTION("Checkout and return within the reserve never falls back")
+    {
+        std::vector<uint8_t *> blocks;
+        for (int i = 0; i < 16; ++i)
+        {
+            auto b = mp.checkoutBlock(sz);
+            REQUIRE(b);
+            // The whole requested size is ours to use
+            memset(b, i, sz);
+            blocks.push_back(b);
+        }
+        REQUIRE(mp.getFallbackAllocations() == 0);
+
+        for (auto b : blocks)
+            mp.returnBlock(b, sz);
+
+        // and coming back out reuses what went back in
+        auto b = mp.checkoutBlock(sz);
+        REQUIRE(std::find(blocks.begin(), blocks.end(), b) != blocks.end());
+        mp.returnBlock(b, sz);
+        REQUIRE(mp.getFallbackAllocations() == 0);
+    }
+
+    SECTION("Running dry returns null rather than allocating")
+    {
+        // The class table caps how far the replenisher can grow, so this must run dry.
+        // A small class keeps the thousand or so blocks that takes cheap.
+        scxt::engine::MemoryPool dry;
+        static constexpr size_t small{64};
+        dry.preReservePool(small);
+
+        std::vector<uint8_t *> blocks;
+        uint8_t *b{nullptr};
+        while ((b = dry.checkoutBlock(small)) != nullptr)
+        {
+            blocks.push_back(b);
+            REQUIRE(blocks.size() <= scxt::engine::MemoryPool::maxBlocksPerClass);
+        }
+        REQUIRE(blocks.size() >= 16);
+        REQUIRE(dry.getFallbackAllocations() >= 1);
+        REQUIRE(dry.getStats()[0].fallbackGrows >= 1);
+
+        std::sort(blocks.begin(), blocks.end());
+        REQUIRE(std::adjacent_find(blocks.begin(), blocks.end()) == blocks.end());
+
+        // The reserve is always there to set up in, and returning it changes nothing
+        auto r = dry.reserveBlock(small);
+        REQUIRE(r);
+        REQUIRE(std::find(blocks.begin(), blocks.end(), r) == blocks.end());
+        memset(r, 0, small);
+        dry.returnBlock(r, small);
+        REQUIRE(dry.getStats()[0].outstanding == (int32_t)blocks.size());
+
+        for (auto rb : blocks)
+            dry.returnBlock(rb, small);
+        REQUIRE(dry.getStats()[0].outstanding == 0);
+
+        // and what came back can go out again
+        b = dry.checkoutBlock(small);
+        REQUIRE(b);
+        dry.returnBlock(b, small);
+    }
+
+    SECTION("Stats track outstanding blocks and the high watermark")
+    {
+        std::vector<uint8_t *> blocks;
+        for (int i = 0; i < 5; ++i)
+            blocks.push_back(mp.checkoutBlock(sz));
+        mp.returnBlock(blocks.back(), sz);
+        blocks.pop_back();
+
+        auto st = mp.getStats();
+        REQUIRE(st.size() == 1);
+        REQUIRE(st[0].blockSize >= sz);
+        REQUIRE(st[0].outstanding == 4);
+        REQUIRE(st[0].highWatermark == 5);
+        REQUIRE(mp.getReservedBytes() >= st[0].reservedBytes);
+
+        for (auto b : blocks)
+            mp.returnBlock(b, sz);
+        REQUIRE(mp.getStats()[0].outstanding == 0);
+    }
+}
+
+TEST_CASE("Memory Pool Single Instance Pools Hold One Block")
+{
+    scxt::engine::MemoryPool mp;
+    static constexpr size_t sz{1000 * sizeof(float)};
+    mp.preReserveSingleInstancePool(sz);
+    REQUIRE(mp.getStats()[0].reservedBlocks == 1);
+
+    // With its one block out the replenisher has no reason to make another
+    auto b = mp.checkoutBlock(sz);
+    REQUIRE(b);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(mp.getStats()[0].reservedBlocks == 1);
+    mp.returnBlock(b, sz);
+}
+
+TEST_CASE("Quad Voice SVF Lanes Filter Independently")
+{
+    using svf_t = scxt::dsp::processor::QuadVoiceSVF;
+    static constexpr int n{64}, blocks{16};
+    static constexpr float srInv{1.f / 48000.f};
+
+    // A different filter in each lane, the last one running only its left channel
+    float fp[svf_t::lanes][3]{{0, 0, 0.2f}, {12, 5, 0.5f}, {-24, 0, 0.9f}, {30, 30, 0.1f}};
+    int32_t ip[svf_t::lanes][2]{{0, svf_t::LP}, {1, svf_t::HP}, {0, svf_t::BP}, {0, svf_t::PEAK}};
+    auto input = [](int l, int c, int i) { return std::sin(0.01f * (l + 1) * i + c); };
+
+    // Run the lanes in use together over all the blocks, left then right per lane
+    auto render = [&](const std::vector<int> &used) {
+        svf_t::VoiceState st[svf_t::lanes];
+        std::vector<float> res;
+        for (int b = 0; b < blocks; ++b)
+        {
+            svf_t svf;
+            float in alignas(16)[svf_t::lanes][2][n], out alignas(16)[svf_t::lanes][2][n];
+            float *inP[svf_t::lanes][2]{}, *outP[svf_t::lanes][2]{};
+            for (auto l : used)
+            {
+                for (int c = 0; c < (l == 3 ? 1 : 2); ++c)
+                {
+                    for (int i = 0; i < n; ++i)
+                        in[l][c][i] = input(l, c, b * n + i);
+                    inP[l][c] = in[l][c];
+                    outP[l][c] = out[l][c];
+                }
+                svf.setLane(l, fp[l], ip[l], 0.f, srInv, st[l]);
+            }
+            svf.process<n>(inP, outP);
+            for (auto l : used)
+            {
+                svf.storeLane(l, st[l]);
+                for (int c = 0; c < (l == 3 ? 1 : 2); ++c)
+                    res.insert(res.end(), out[l][c], out[l][c] + n);
+            }
+        }
+        return res;
+    };
+
+    auto together = render({0, 1, 2, 3});
+    for (int l = 0; l < svf_t::lanes; ++l)
+    {
+        INFO("Lane " << l);
+        auto alone = render({l});
+        auto per = alone.size() / blocks;
+        REQUIRE(per > 0);
+        // Each block of the lane on its own sits at the same place in the joint render
+        for (int b = 0; b < blocks; ++b)
+        {
+            size_t at{(size_t)(b * 7 + l * 2) * n};
+            REQUIRE(std::equal(alone.begin() + b * per, alone.begin() + (b + 1) * per,
+                               together.begin() + at));
+        }
+    }
+}
@@ -0,0 +1,481 @@
+/*
+ * Shortcircuit XT - a Surge Synth Team product
+ *
+ * A fully featured creative sampler, available as a standalone
+ * and plugin for multiple platforms.
+ *
+ * Copyright 2019 - 2026, Various authors, as described in the github
+ * transaction log.
+ *
+ * This source file and all other files in the shortcircuit-xt repo outside of
+ * `libs/` are licensed under the MIT license, available in the
+ * file LICENSE or at https://opensource.org/license/mit.
+ *
+ * As some dependencies of ShortcircuitXT are released under the GNU General
+ * Public License 3, if you distribute a binary of ShortcircuitXT
+ * without breaking those dependencies, the combined work must be
+ * distributed under GPL3.
+ *
+ * ShortcircuitXT is inspired by, and shares a small amount of code with,
+ * the commercial product Shortcircuit 1 and 2, released by VemberTech
+ * in the mid 2000s. The code for Shortcircuit 2 was opensourced in
+ * 2020 at the outset of this project.
+ *
+ * All source for ShortcircuitXT is available at
+ * https://github.com/surge-synthesizer/shortcircuit-xt
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "catch2/catch2.hpp"
+#include "engine/engine.h"
+#include "dsp/processor/quad_voice_filter.h"
+#include "console_harness.h"
+#include "infrastructure/worker_wake.h"
+
+namespace cmsg = scxt::messaging::client;
+using ConsoleHarness = scxt::clients::console_ui::ConsoleHarness;
+
+namespace
+{
+std::string testSample(const char *name)
+{
+    auto root = std::filesystem::path(__FILE__).parent_path().parent_path();
+    return (root / "resources" / "test_samples" / name).u8string();
+}
+
+// One sampled zone per eight keys across the keyboard of part 0, group 0
+void addSampleKeyboard(ConsoleHarness &th)
+{
+    for (int k = 0; k < 128; k += 8)
+    {
+        th.sendToSerialization(
+            cmsg::AddSampleWithRange({testSample("WavStereo48k.wav"), k + 4, k, k + 7, 0, 127}));
+    }
+    th.stepUI(50);
+}
+
+// Stop the harness audio thread so the test can drive processAudio block by block
+scxt::engine::Engine &takeOverAudioThread(ConsoleHarness &th, uint32_t seed = 8675309)
+{
+    th.audioThreadProvider.reset();
+    auto &e = *th.engine;
+    e.getMessageController()->threadingChecker.registerAsAudioThread();
+    // Voices seed their own random source from this at note on
+    e.rng = sst::basic_blocks::dsp::RNG(seed);
+    return e;
+}
+
+// Render blocks and return the main bus output, left then right for each block
+std::vector<float> renderMainBus(scxt::engine::Engine &e, int blocks,
+                                 const std::function<void(int)> &beforeBlock)
+{
+    std::vector<float> res;
+    res.reserve(blocks * scxt::blockSize * 2);
+    for (int b = 0; b < blocks; ++b)
+    {
+        beforeBlock(b);
+        e.processAudio();
+        const auto &mb = e.getPatch()->busses.mainBus;
+        res.insert(res.end(), mb.output[0], mb.output[0] + scxt::blockSize);
+        res.insert(res.end(), mb.output[1], mb.output[1] + scxt::blockSize);
+    }
+    return res;
+}
+
+bool hasSignal(const std::vector<float> &v)
+{
+    for (auto f : v)
+        if (f != 0.f)
+            return true;
+    return false;
+}
+
+// A chord held then released, enough voices in one group to use the render pool
+void playChord(scxt::engine::Engine &e, int block)
+{
+    static constexpr int heldBlocks{64};
+    for (int k = 36; k < 36 + 24; ++k)
+    {
+        if (block == 0)
+            e.processNoteOnEvent(0, 0, k, -1, 0.8, 0.f);
+        if (block == heldBlocks)
+            e.processNoteOffEvent(0, 0, k, -1, 0.8);
+    }
+}
+} // namespace
+
+TEST_CASE("Parallel Voice Render Matches Serial Render")
+{
+    auto render = [](int workers) {
+        ConsoleHarness th;
+        th.start();
+        th.stepUI();
+        addSampleKeyboard(th);
+
+        auto &e = takeOverAudioThread(th);
+        e.setVoiceRenderWorkerCount(workers);
+        return renderMainBus(e, 128, [&e](int b) { playChord(e, b); });
+    };
+
+    auto serial = render(0);
+    REQUIRE(hasSignal(serial));
+    for (auto workers : {1, 3})
+    {
+        INFO("Render workers " << workers);
+        auto parallel = render(workers);
+        REQUIRE(parallel == serial);
+    }
+}
+
+TEST_CASE("Quad Voice Filters Track The Per Voice Filter")
+{
+    auto render = [](bool quad) {
+        ConsoleHarness th;
+        th.start();
+        th.stepUI();
+        addSampleKeyboard(th);
+
+        auto &e = takeOverAudioThread(th);
+        e.getMessageController()->threadingChecker.bypassThreadChecks = true;
+        for (auto &z : *e.getPatch()->getPart(0)->getGroup(0))
+        {
+            z->setProcessorType(0, scxt::dsp::processor::proct_CytomicSVF);
+            auto &ps = z->processorStorage[0];
+            ps.floatParams[0] = 12.f; // an octave over A440
+            ps.floatParams[2] = 0.4f;
+            ps.intParams[0] = 0;
+            ps.intParams[1] = scxt::dsp::processor::QuadVoiceSVF::LP;
+        }
+        e.getMessageController()->threadingChecker.bypassThreadChecks = false;
+        e.setQuadVoiceFilters(quad);
+        return renderMainBus(e, 128, [&e](int b) { playChord(e, b); });
+    };
+
+    auto rms = [](const std::vector<float> &v) {
+        double s{0};
+        for (auto f : v)
+            s += f * f;
+        return std::sqrt(s / v.size());
+    };
+
+    auto perVoice = render(false);
+    auto lanes = render(true);
+    REQUIRE(hasSignal(perVoice));
+    // The lanes ran, and filter much as each voice's own filter does
+    REQUIRE(lanes != perVoice);
+    REQUIRE(rms(lanes) == Approx(rms(perVoice)).epsilon(0.1));
+}
+
+TEST_CASE("Worker Wake Never Loses A Wake Up")
+{
+    // With a limit this long a single lost wake up would stall the test for seconds
+    static constexpr std::chrono::microseconds limit{std::chrono::seconds(30)};
+    static constexpr uint32_t rounds{5000};
+
+    scxt::infrastructure::WorkerWake wake;
+    std::atomic<uint32_t> published{0}, seen{0};
+    std::atomic<bool> keepRunning{true};
+    std::thread worker([&]() {
+        uint32_t last{0};
+        while (keepRunning)
+        {
+            auto p = published.load();
+            if (p != last)
+            {
+                last = p;
+                seen = p;
+                continue;
+            }
+            wake.sleepUnless([&]() { return !keepRunning || published.load() != last; }, limit);
+        }
+    });
+
+    auto st = std::chrono::steady_clock::now();
+    for (uint32_t i = 1; i <= rounds; ++i)
+    {
+        published = i;
+        wake.wake();
+        while (seen != i)
+            std::this_thread::yield();
+    }
+    keepRunning = false;
+    wake.wake();
+    worker.join();
+    REQUIRE(std::chrono::steady_clock::now() - st < limit);
+}
+
+TEST_CASE("Concurrent Part Render Matches Serial Render")
+{
+    static constexpr int partsUsed{4};
+
+    auto render = [](bool concurrent, int &concurrentBlocks) {
+        ConsoleHarness th;
+        th.start();
+        th.stepUI();
+        for (int p = 1; p < partsUsed; ++p)
+            th.sendToSerialization(cmsg::ActivateNextPart(true));
+        th.stepUI();
+        for (int p = 0; p < partsUsed; ++p)
+            th.sendToSerialization(cmsg::AddSampleToGroup({testSample("WavStereo48k.wav"), p, 0}));
+        th.stepUI(50);
+
+        auto &e = takeOverAudioThread(th);
+        if (concurrent)
+        {
+            // Stand in for a host thread pool with one thread per task
+            e.requestConcurrentPartTasks = [&e, &concurrentBlocks](uint32_t n) {
+                std::vector<std::thread> tasks;
+                for (uint32_t i = 0; i < n; ++i)
+                    tasks.emplace_back([&e, i]() { e.getPatch()->processConcurrentPartTask(i); });
+                for (auto &t : tasks)
+                    t.join();
+                concurrentBlocks++;
+                return true;
+            };
+        }
+
+        return renderMainBus(e, 128, [&e](int b) {
+            for (int p = 0; p < partsUsed; ++p)
+            {
+                if (b == p)
+                    e.processNoteOnEvent(0, p, 60 + p * 3, -1, 0.8, 0.f);
+                if (b == 64 + p)
+                    e.processNoteOffEvent(0, p, 60 + p * 3, -1, 0.8);
+            }
+        });
+    };
+
+    int serialBlocks{0}, concurrentBlocks{0};
+    auto serial = render(false, serialBlocks);
+    auto concurrent = render(true, concurrentBlocks);
+
+    REQUIRE(hasSignal(serial));
+    REQUIRE(concurrentBlocks > 0);
+    REQUIRE(concurrent == serial);
+}
+
+TEST_CASE("Pipelined Bus Effects Match Inline Bus Effects")
+{
+    auto render = [](bool pipelined, bool withDelay) {
+        ConsoleHarness th;
+        th.start();
+        th.stepUI();
+        addSampleKeyboard(th);
+
+        auto &e = takeOverAudioThread(th);
+        if (withDelay)
+        {
+            // A delay on the main bus, so the bus pass carries state from block to block
+            auto &mb = e.getPatch()->busses.mainBus;
+            mb.setBusEffectType(e, 0, scxt::engine::AvailableBusEffects::delay);
+            REQUIRE(mb.busEffects[0]);
+            REQUIRE(mb.busEffectStorage[0].isActive);
+        }
+        e.setPipelinedBusEffects(pipelined);
+        REQUIRE(e.getLatencySamples() ==
+                (pipelined ? scxt::engine::BusEffectWorker::latencyInSamples : 0));
+        return renderMainBus(e, 128, [&e](int b) { playChord(e, b); });
+    };
+
+    auto inlined = render(false, true);
+    auto pipelined = render(true, true);
+    REQUIRE(hasSignal(inlined));
+    REQUIRE(inlined != render(false, false));
+    REQUIRE(pipelined.size() == inlined.size());
+
+    // The pipelined output is the inline output a latency later, and silent before that
+    static_assert(scxt::engine::BusEffectWorker::latencyInSamples % scxt::blockSize == 0);
+    auto lag = 2 * scxt::engine::BusEffectWorker::latencyInSamples; // both channels per block
+    for (size_t i = 0; i < lag; ++i)
+        REQUIRE(pipelined[i] == 0.f);
+    REQUIRE(std::equal(inlined.begin(), inlined.end() - lag, pipelined.begin() + lag));
+}
+
+TEST_CASE("Only Active Busses Are Cleared, Summed And Processed")
+{
+    using namespace scxt::engine;
+    static constexpr float sentinel{0.25f};
+
+    // Part 0 holds a note for a while, with part bus 1 and aux bus 1 left idle
+    auto render = [](bool markIdleBusses, const std::function<void(Engine &, int)> &check) {
+        ConsoleHarness th;
+        th.start();
+        th.stepUI();
+        addSampleKeyboard(th);
+
+        auto &e = takeOverAudioThread(th);
+        auto &bs = e.getPatch()->busses;
+        for (int a = 0; a < bs.busCount; ++a)
+        {
+            INFO("Bus " << a);
+            REQUIRE(bs.busActive[a] == (a == MAIN_0));
+        }
+
+        bs.partBusses[0].setAuxSendLevel(0, 1.f);
+        if (markIdleBusses)
+        {
+            // An idle bus is neither cleared nor processed, and nothing reads it
+            for (auto *b : {&bs.partBusses[1], &bs.auxBusses[1]})
+            {
+                std::fill(&b->output[0][0], &b->output[0][0] + 2 * scxt::blockSize, sentinel);
+                b->vuLevel[0] = sentinel;
+                b->vuLevel[1] = sentinel;
+            }
+        }
+
+        return renderMainBus(e, 256, [&e, &check](int b) {
+            if (b == 0)
+                e.processNoteOnEvent(0, 0, 60, -1, 0.8, 0.f);
+            if (b == 64)
+                e.processNoteOffEvent(0, 0, 60, -1, 0.8);
+            if (b > 0)
+                check(e, b);
+        });
+    };
+
+    auto plain = render(false, [](auto &, auto) {});
+    REQUIRE(hasSignal(plain));
+
+    auto marked = render(true, [](Engine &e, int b) {
+        auto &bs = e.getPatch()->busses;
+        if (b <= 64)
+        {
+            // the held note keeps its part bus and the aux it sends to going
+            REQUIRE(bs.busActive[PART_0]);
+            REQUIRE(bs.busActive[AUX_0]);
+        }
+        REQUIRE(!bs.busActive[PART_0 + 1]);
+        REQUIRE(!bs.busActive[AUX_0 + 1]);
+        for (const auto *idle : {&bs.partBusses[1], &bs.auxBusses[1]})
+        {
+            REQUIRE(idle->output[0][0] == sentinel);
+            REQUIRE(idle->output[1][scxt::blockSize - 1] == sentinel);
+            REQUIRE(idle->vuLevel[0] == sentinel);
+        }
+    });
+    REQUIRE(marked == plain);
+}
+
+TEST_CASE("Busses Leave The Active Set Once Rung Out")
+{
+    using namespace scxt::engine;
+
+    ConsoleHarness th;
+    th.start();
+    th.stepUI();
+    addSampleKeyboard(th);
+
+    auto &e = takeOverAudioThread(th);
+    auto &bs = e.getPatch()->busses;
+    renderMainBus(e, 64, [&e](int b) {
+        if (b == 0)
+            e.processNoteOnEvent(0, 0, 60, -1, 0.8, 0.f);
+    });
+    REQUIRE(bs.busActive[PART_0]);
+
+    e.processNoteOffEvent(0, 0, 60, -1, 0.8);
+    int blocks{0};
+    static constexpr int maxBlocks{10 * 48000 / scxt::blockSize};
+    while (bs.busActive[PART_0] && blocks < maxBlocks)
+    {
+        e.processAudio();
+        blocks++;
+    }
+    REQUIRE(!bs.busActive[PART_0]);
+    REQUIRE(bs.busActive[MAIN_0]);
+
+    // and a retired bus left silent behind it, which a new note brings back
+    auto &pb = bs.partBusses[0];
+    for (int c = 0; c < 2; ++c)
+        for (int i = 0; i < scxt::blockSize; ++i)
+            REQUIRE(pb.output[c][i] == 0.f);
+
+    e.processNoteOnEvent(0, 0, 60, -1, 0.8, 0.f);
+    e.processAudio();
+    REQUIRE(bs.busActive[PART_0]);
+}
+
+TEST_CASE("Note Events Land At Their Sample Offset")
+{
+    static constexpr int bs{scxt::blockSize};
+    static constexpr int releaseBlock{32};
+    static constexpr int noRelease{-1};
+
+    // One note, started and optionally released at a sample offset within its block
+    auto render = [](int blocks, uint16_t onOffset, int offOffset) {
+        ConsoleHarness th;
+        th.start();
+        th.stepUI();
+        addSampleKeyboard(th);
+
+        auto &e = takeOverAudioThread(th);
+        return renderMainBus(e, blocks, [&e, onOffset, offOffset](int b) {
+            if (b == 0)
+            {
+                e.noteEventSampleOffset = onOffset;
+                e.processNoteOnEvent(0, 0, 60, -1, 0.8, 0.f);
+            }
+            if (b == releaseBlock && offOffset != noRelease)
+            {
+                e.noteEventSampleOffset = offOffset;
+                e.processNoteOffEvent(0, 0, 60, -1, 0.8);
+            }
+            e.noteEventSampleOffset = 0;
+        });
+    };
+
+    // renderMainBus interleaves channels by block; this is the left channel at sample t
+    auto left = [](const std::vector<float> &v, size_t t) { return v[(t / bs) * 2 * bs + t % bs]; };
+    auto samples = [](const std::vector<float> &v) { return v.size() / 2; };
+
+    SECTION("Note On Offset Delays The Whole Voice Including Its Tail")
+    {
+        // Long enough for the release to finish, with silence after it
+        static constexpr int blocks{8000};
+        auto ref = render(blocks, 0, 0);
+        REQUIRE(hasSignal(ref));
+        REQUIRE(left(ref, samples(ref) - 1) == 0.f);
+
+        for (uint16_t d : {1, 7, bs - 1})
+        {
+            INFO("Note on offset " << d);
+            // Release at the same offset so both voices render identical blocks
+            auto late = render(blocks, d, d);
+            for (size_t t = 0; t < d; ++t)
+                REQUIRE(left(late, t) == 0.f);
+            for (size_t t = 0; t + d < samples(ref); ++t)
+                REQUIRE(left(late, t + d) == left(ref, t));
+        }
+    }
+
+    SECTION("Note Off Offset Starts The Release At That Sample")
+    {
+        static constexpr int blocks{releaseBlock + 4};
+        auto releaseStart = [](int off) { return (size_t)releaseBlock * bs + off; };
+
+        for (uint16_t on : {0, 11})
+        {
+            auto held = render(blocks, on, noRelease);
+            for (int off : {0, 3, 9, bs - 1})
+            {
+                INFO("Note on offset " << on << " note off offset " << off);
+                auto released = render(blocks, on, off);
+
+                size_t diff{0};
+                while (diff < samples(held) && left(held, diff) == left(released, diff))
+                    diff++;
+                // Identical up to the note off, and the release shows within a block of it
+                REQUIRE(diff >= releaseStart(off));
+                REQUIRE(diff < releaseStart(off) + bs);
+            }
+        }
+    }
+}
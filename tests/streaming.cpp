@@ -158,6 +158,30 @@ TEST_CASE("Stream engine::Zone")
     // TODO: Expand this test
 }
 
+TEST_CASE("Zones Unstreamed Together Share an Arena")
+{
+    auto before = engine::StructureArena::getLiveArenaCount();
+    std::vector<std::unique_ptr<engine::Zone>> zones;
+    {
+        engine::StructureArena::Scope scope;
+        REQUIRE(engine::StructureArena::getLiveArenaCount() == before + 1);
+        for (int i = 0; i < 8; ++i)
+            zones.push_back(std::make_unique<engine::Zone>());
+    }
+    // The zones keep the arena alive past the scope
+    REQUIRE(engine::StructureArena::getLiveArenaCount() == before + 1);
+
+    // and a zone made outside a scope comes from and goes back to the heap
+    auto heapZone = std::make_unique<engine::Zone>();
+    heapZone.reset();
+    REQUIRE(engine::StructureArena::getLiveArenaCount() == before + 1);
+
+    zones.erase(zones.begin() + 3);
+    REQUIRE(engine::StructureArena::getLiveArenaCount() == before + 1);
+    zones.clear();
+    REQUIRE(engine::StructureArena::getLiveArenaCount() == before);
+}
+
 // TODO: Add test for Group streaming
 // TODO: Add test for Part streaming
 // TODO: Add test for Patch streaming
@@ -27,6 +27,7 @@
 
 #include "catch2/catch2.hpp"
 #include <chrono>
+#include <set>
 #include "console_harness.h"
 
 TEST_CASE("Basic Console UI Startup")
@@ -41,4 +42,179 @@ TEST_CASE("Basic Console UI Startup")
         th.editor->stepUI();
         std::this_thread::sleep_for(std::chrono::milliseconds(17));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Scalar Payloads Round Trip as Flat Frames")
+{
+    namespace det = scxt::messaging::client::detail;
+    using diff_t = scxt::messaging::client::detail::zoneOrGroupDiffMsg_t<float>;
+
+    static_assert(det::FlatLayout<diff_t>::value);
+    static_assert(det::FlatLayout<bool>::value);
+    static_assert(!det::FlatLayout<std::string>::value);
+    static_assert(!det::FlatLayout<std::tuple<int, std::string>>::value);
+
+    diff_t in{true, 1234, 0.625f}, out{};
+    auto fr = det::flatFrame(17, in);
+    REQUIRE(det::isFlatFrame(fr));
+    REQUIRE(det::flatFrameId(fr) == 17);
+    REQUIRE(det::flatFramePayload(fr, out));
+    REQUIRE(in == out);
+
+    // A truncated frame is refused rather than read past the end
+    fr.pop_back();
+    REQUIRE(!det::flatFramePayload(fr, out));
+}
+
+TEST_CASE("Redundant Parameter Updates Coalesce")
+{
+    namespace cmsg = scxt::messaging::client;
+    namespace det = scxt::messaging::client::detail;
+    auto out = [](ptrdiff_t off, float v) {
+        return scxt::messaging::InboundMessage{
+            det::flatFrame((int32_t)cmsg::UpdateZoneOutputFloatValue::c2s_id,
+                           det::diffMsg_t<float>{off, v})};
+    };
+
+    std::vector<scxt::messaging::InboundMessage> batch{out(8, 0.1f), out(16, 0.2f),
+                                                       out(8, 0.3f), out(8, 0.4f)};
+    REQUIRE(cmsg::coalesceClientMessages(batch) == 2);
+    REQUIRE(batch.size() == 2);
+    REQUIRE(batch[0].msg == out(16, 0.2f).msg);
+    REQUIRE(batch[1].msg == out(8, 0.4f).msg);
+
+    // Something which isn't a bound update may change what the offset refers to
+    std::vector<scxt::messaging::InboundMessage> barrier{out(8, 0.1f), {"{}"}, out(8, 0.2f)};
+    REQUIRE(cmsg::coalesceClientMessages(barrier) == 0);
+    REQUIRE(barrier.size() == 3);
+}
+
+TEST_CASE("Inplace Functions Hold Small and Large Callables")
+{
+    scxt::messaging::InplaceFunction<int(int), 32> f;
+    REQUIRE(!f);
+
+    int k{3};
+    f.set([k](int x) { return x + k; });
+    REQUIRE(f);
+    REQUIRE(f(1) == 4);
+
+    std::array<int, 32> big{};
+    big[0] = 5;
+    static_assert(!decltype(f)::fitsInline<std::array<int, 32>>());
+    f.set([big](int x) { return x + big[0]; });
+    REQUIRE(f(1) == 6);
+
+    f.set(std::function<int(int)>());
+    REQUIRE(!f);
+    f.set(nullptr);
+    REQUIRE(!f);
+}
+
+TEST_CASE("Outbound Updates Coalesce Per Key Until The Frame")
+{
+    using oc_t = scxt::messaging::OutboundCoalescer;
+    oc_t oc;
+    oc.setFrameRate(1000.0);
+    REQUIRE(oc.getFrameRate() == Approx(oc_t::maxFrameRate));
+
+    std::vector<int> sent;
+    oc.add(7, 1, [&]() { sent.push_back(10); });
+    oc.add(7, 2, [&]() { sent.push_back(20); });
+    oc.add(7, 1, [&]() { sent.push_back(11); });
+    oc.add(9, 1, [&]() { sent.push_back(90); });
+    REQUIRE(oc.getReplacedCount() == 1);
+
+    // Only the latest per key, in the order the keys arrived
+    auto now = oc_t::clock_t::now();
+    REQUIRE(oc.isFrameDue(now));
+    oc.flush(now);
+    REQUIRE(sent == std::vector<int>{11, 20, 90});
+    REQUIRE(oc.empty());
+    REQUIRE(!oc.isFrameDue(now));
+
+    // A direct send of an id pulls its held updates out ahead of it
+    sent.clear();
+    oc.add(7, 1, [&]() { sent.push_back(12); });
+    oc.add(9, 1, [&]() { sent.push_back(91); });
+    oc.flushId(7);
+    REQUIRE(sent == std::vector<int>{12});
+    REQUIRE(!oc.empty());
+}
+
+TEST_CASE("Latency Tracing Records Each Hop")
+{
+    namespace cmsg = scxt::messaging::client;
+    using lt_t = scxt::messaging::LatencyTrace;
+
+    scxt::clients::console_ui::ConsoleHarness th;
+    REQUIRE(th.start(false));
+    th.stepUI(20);
+
+    th.sendToSerialization(cmsg::SetLatencyTracing(true));
+    th.stepUI();
+    for (int i = 0; i < 10; ++i)
+        th.sendToSerialization(cmsg::StopSounds(false));
+    th.stepUI(20);
+
+    auto report = th.engine->getMessageController()->latencyTrace.report();
+    auto countFor = [&](lt_t::Hop h, int32_t id) {
+        for (const auto &r : report)
+            if (std::get<0>(r) == h && std::get<1>(r) == id)
+                return std::get<2>(r);
+        return (int64_t)0;
+    };
+    REQUIRE(countFor(lt_t::CLIENT_ENCODE, cmsg::c2s_silence_engine) == 10);
+    REQUIRE(countFor(lt_t::INBOUND_QUEUE, cmsg::c2s_silence_engine) == 10);
+    REQUIRE(countFor(lt_t::SERIAL_EXECUTE, cmsg::c2s_silence_engine) == 10);
+    // StopSounds is an audio thread callback, and the harness runs an audio thread
+    REQUIRE(countFor(lt_t::AUDIO_ROUND_TRIP, cmsg::c2s_silence_engine) == 10);
+}
+
+TEST_CASE("Voice Display Snapshot Holds Only Playing Voices")
+{
+    namespace cmsg = scxt::messaging::client;
+    scxt::clients::console_ui::ConsoleHarness th;
+    REQUIRE(th.start(false));
+    th.stepUI();
+
+    th.sendToSerialization(cmsg::AddBlankZone({0, 0, 0, 127, 0, 127}));
+    th.stepUI();
+    th.sendToSerialization(cmsg::NoteFromGUI({60, 0.8f, true}));
+    th.sendToSerialization(cmsg::NoteFromGUI({64, 0.8f, true}));
+    th.stepUI(20);
+
+    auto &vd = th.engine->sharedUIMemoryState.voiceDisplay;
+    REQUIRE(vd.acquireLatest());
+    const auto &vds = vd.read();
+    REQUIRE(vds.voiceCount == 2);
+    REQUIRE(vds.itemCount == 2);
+    std::set<int> notes;
+    for (int i = 0; i < vds.itemCount; ++i)
+    {
+        REQUIRE(vds.items[i].gated);
+        notes.insert(vds.items[i].midiNote);
+    }
+    REQUIRE(notes == std::set<int>{60, 64});
+
+    th.sendToSerialization(cmsg::NoteFromGUI({60, 0.8f, false}));
+    th.sendToSerialization(cmsg::NoteFromGUI({64, 0.8f, false}));
+    th.stepUI(20);
+}
+
+TEST_CASE("Console UI Runs Over the JSON Wire Format")
+{
+    scxt::clients::console_ui::ConsoleHarness th;
+    REQUIRE(th.start(false));
+    th.engine->getMessageController()->wireFormat =
+        scxt::messaging::MessageController::WireFormat::JSON;
+
+    namespace cmsg = scxt::messaging::client;
+    th.sendToSerialization(cmsg::AddBlankZone({0, -1, 60, 72, 0, 127}));
+    th.stepUI(20);
+
+    size_t zones{0};
+    for (const auto &g : *(th.engine->getPatch()->getPart(0)))
+        zones += g->getZones().size();
+    REQUIRE(zones == 1);
+}